@@ -0,0 +1,9 @@
+#!/bin/bash
+set -e
+
+cd "$(dirname "$0")/.."
+mkdir -p bin
+
+g++ -std=c++17 -O2 -Iinclude bench/csv_scan_bench.cpp src/df/csv_reader.cpp -pthread -o bin/csv_scan_bench
+
+echo "Compilation complete. Run ./bin/csv_scan_bench [megabytes] to execute the benchmark."
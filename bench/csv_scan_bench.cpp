@@ -0,0 +1,165 @@
+// Throughput of the CSV block scanners: the raw 64-byte classification and
+// the tokenizer built on it, for each scanner this CPU supports, over a
+// generated plain file and a quote-heavy one. The baseline row is the
+// line-at-a-time tokenizer readCSV used before the block scanners.
+//
+//   bash bench/build.sh && ./bin/csv_scan_bench [megabytes]
+
+#include "df/csv_reader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using df::detail::BlockScanner;
+
+namespace {
+
+std::string plainCSV(size_t bytes) {
+    std::mt19937 rng(42);
+    std::string out = "id,name,price,qty,date\n";
+    while (out.size() < bytes) {
+        out += std::to_string(rng() % 1000000) + ",item" + std::to_string(rng() % 5000) + "," +
+               std::to_string(rng() % 100000 / 100.0) + "," + std::to_string(rng() % 100) +
+               ",2024-0" + std::to_string(1 + rng() % 9) + "-1" + std::to_string(rng() % 10) + "\n";
+    }
+    return out;
+}
+
+// Every text field quoted, with embedded delimiters, escaped quotes and line
+// breaks.
+std::string quotedCSV(size_t bytes) {
+    std::mt19937 rng(7);
+    std::string out = "id,comment,tag\n";
+    while (out.size() < bytes) {
+        out += std::to_string(rng() % 1000000) + ",\"said \"\"hi\"\", then left, " +
+               std::to_string(rng() % 1000) + (rng() % 4 == 0 ? "\nsecond line" : "") + "\",\"t" +
+               std::to_string(rng() % 50) + "\"\n";
+    }
+    return out;
+}
+
+// The previous tokenizer: std::getline, joining lines while a quote is open,
+// and a per-character split into owned strings.
+std::vector<std::string> parseCSVLine(const std::string& line, char delimiter, char quotechar) {
+    std::vector<std::string> fields;
+    std::string field;
+    bool inQuotes = false;
+
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (inQuotes) {
+            if (c == quotechar) {
+                if (i + 1 < line.size() && line[i + 1] == quotechar) {
+                    field += quotechar;
+                    ++i;
+                } else {
+                    inQuotes = false;
+                }
+            } else {
+                field += c;
+            }
+        } else {
+            if (c == quotechar) {
+                inQuotes = true;
+            } else if (c == delimiter) {
+                fields.push_back(field);
+                field.clear();
+            } else {
+                field += c;
+            }
+        }
+    }
+    fields.push_back(field);
+    return fields;
+}
+
+bool hasUnclosedQuote(const std::string& line, char quotechar) {
+    bool inQuotes = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == quotechar) {
+            if (inQuotes && i + 1 < line.size() && line[i + 1] == quotechar) {
+                ++i;
+            } else {
+                inQuotes = !inQuotes;
+            }
+        }
+    }
+    return inQuotes;
+}
+
+size_t baselineRecords(const std::string& text) {
+    std::istringstream in(text);
+    std::string line, nextLine;
+    size_t records = 0;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        while (hasUnclosedQuote(line, '"') && std::getline(in, nextLine)) {
+            if (!nextLine.empty() && nextLine.back() == '\r') nextLine.pop_back();
+            line += '\n' + nextLine;
+        }
+        records += !parseCSVLine(line, ',', '"').empty();
+    }
+    return records;
+}
+
+// Timings on shared machines are noisy, so take the best of several runs.
+template <typename Fn>
+double bestSeconds(Fn fn) {
+    double best = 1e30;
+    for (int rep = 0; rep < 7; ++rep) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+volatile size_t sink;
+
+void run(const char* label, const std::string& text) {
+    const std::pair<const char*, BlockScanner> scanners[] = {
+        {"scalar", BlockScanner::Scalar}, {"sse2", BlockScanner::SSE2}, {"avx2", BlockScanner::AVX2}};
+    const double mb = text.size() / 1e6;
+    double baseline = bestSeconds([&] { sink = baselineRecords(text); });
+    std::printf("%-8s %-8s %-20s tokenize %6.0f MB/s\n", label, "baseline", "", mb / baseline);
+    for (const auto& [name, scanner] : scanners) {
+        if (!df::detail::useBlockScanner(scanner)) {
+            std::printf("%-8s %-8s unsupported\n", label, name);
+            continue;
+        }
+        double scan = bestSeconds([&] {
+            size_t bits = 0;
+            for (size_t p = 0; p < text.size(); p += 64) {
+                df::detail::BlockMasks masks =
+                    df::detail::scanBlock(text.data() + p, std::min<size_t>(64, text.size() - p), ',', '"');
+                bits += __builtin_popcountll(masks.quotes | masks.delimiters | masks.newlines);
+            }
+            sink = bits;
+        });
+        double tokenize = bestSeconds([&] {
+            df::detail::CSVTokenizer tokenizer(text, ',', '"');
+            std::vector<std::string_view> fields;
+            size_t records = 0;
+            while (tokenizer.next(fields)) ++records;
+            sink = records;
+        });
+        std::printf("%-8s %-8s scan %8.0f MB/s   tokenize %6.0f MB/s\n", label, name, mb / scan, mb / tokenize);
+    }
+    df::detail::useBlockScanner(BlockScanner::Auto);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    if (megabytes == 0) megabytes = 64;
+    run("plain", plainCSV(megabytes << 20));
+    run("quoted", quotedCSV(megabytes << 20));
+    return 0;
+}
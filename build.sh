@@ -3,17 +3,35 @@ set -e
 
 mkdir -p bin/static
 
+# zstd (Parquet pages, .zst CSV files) is built in when libzstd and its header
+# are installed.
+ZSTD_FLAGS=""
+ZSTD_LIBS=""
+if echo '#include <zstd.h>
+int main() { return ZSTD_versionNumber() == 0; }' | g++ -x c++ - -lzstd -o /dev/null 2>/dev/null; then
+    ZSTD_FLAGS="-DDF_HAVE_ZSTD"
+    ZSTD_LIBS="-lzstd"
+fi
+
 g++ -std=c++17 -Iinclude -c main.cpp -o bin/main.o
 
+g++ -std=c++17 -Iinclude -c src/df/column.cpp -o bin/static/column.o
+g++ -std=c++17 -Iinclude -c src/df/timestamp.cpp -o bin/static/timestamp.o
 g++ -std=c++17 -Iinclude -c src/df/dataframe.cpp -o bin/static/dataframe.o
 g++ -std=c++17 -Iinclude -c src/df/math.cpp -o bin/static/math.o
 g++ -std=c++17 -Iinclude -c src/df/stats.cpp -o bin/static/stats.o
 g++ -std=c++17 -Iinclude -c src/df/io.cpp -o bin/static/io.o
+g++ -std=c++17 -Iinclude -c src/df/csv_reader.cpp -o bin/static/csv_reader.o
+g++ -std=c++17 -Iinclude $ZSTD_FLAGS -c src/df/compression.cpp -o bin/static/compression.o
+g++ -std=c++17 -Iinclude -c src/df/binary_io.cpp -o bin/static/binary_io.o
+g++ -std=c++17 -Iinclude -c src/df/arrow_io.cpp -o bin/static/arrow_io.o
+g++ -std=c++17 -Iinclude $ZSTD_FLAGS -c src/df/parquet_io.cpp -o bin/static/parquet_io.o
 g++ -std=c++17 -Iinclude -c src/df/index.cpp -o bin/static/index.o
 g++ -std=c++17 -Iinclude -c src/df/groupby.cpp -o bin/static/groupby.o
+g++ -std=c++17 -Iinclude -c src/df/encoding.cpp -o bin/static/encoding.o
 
-ar rcs bin/static/dataframe_lib.a bin/static/dataframe.o bin/static/math.o bin/static/stats.o bin/static/io.o bin/static/index.o bin/static/groupby.o
+ar rcs bin/static/dataframe_lib.a bin/static/column.o bin/static/timestamp.o bin/static/dataframe.o bin/static/math.o bin/static/stats.o bin/static/io.o bin/static/csv_reader.o bin/static/compression.o bin/static/binary_io.o bin/static/arrow_io.o bin/static/parquet_io.o bin/static/index.o bin/static/groupby.o bin/static/encoding.o
 
-g++ bin/main.o -Lbin/static -l:dataframe_lib.a -o bin/dataframe_demo
+g++ bin/main.o -Lbin/static -l:dataframe_lib.a -lz $ZSTD_LIBS -pthread -o bin/dataframe_demo
 
 echo "Compilation complete. Run ./bin/dataframe_demo to execute the program." 
\ No newline at end of file
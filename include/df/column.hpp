@@ -0,0 +1,655 @@
+#ifndef DF_DS_LIBRARY_COLUMN_H
+#define DF_DS_LIBRARY_COLUMN_H
+
+#include "df/nullable.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <memory>
+
+namespace df {
+
+// Reference-counted, copy-on-write handle to a std::vector. Copies share the
+// same buffer; mutate() detaches a private copy first if the buffer is shared,
+// so copying a column is O(1) and cells are only copied on the first write.
+//
+// A handle may also be a view of a sub-range of the shared vector (see
+// slice()), or of memory owned elsewhere such as a mapped file (see
+// borrow()). Views are read-only: mutate() materialises just the viewed range.
+template<typename T>
+class SharedBuffer {
+private:
+    static constexpr size_t whole = static_cast<size_t>(-1);
+
+    std::shared_ptr<std::vector<T>> buf;
+    const T* external = nullptr;
+    std::shared_ptr<const void> owner;
+    size_t offset = 0;
+    size_t length = whole;
+
+public:
+    SharedBuffer() = default;
+    explicit SharedBuffer(std::vector<T> v) : buf(std::make_shared<std::vector<T>>(std::move(v))) {}
+
+    // A view of n elements at data, which owner keeps alive.
+    static SharedBuffer borrow(const T* data, size_t n, std::shared_ptr<const void> owner) {
+        SharedBuffer view;
+        view.external = data;
+        view.owner = std::move(owner);
+        view.length = n;
+        return view;
+    }
+
+    std::vector<T>& mutate() {
+        if (isView()) {
+            buf = std::make_shared<std::vector<T>>(data(), data() + length);
+            external = nullptr;
+            owner.reset();
+            offset = 0;
+            length = whole;
+        } else if (!buf) {
+            buf = std::make_shared<std::vector<T>>();
+        } else if (buf.use_count() > 1) {
+            buf = std::make_shared<std::vector<T>>(*buf);
+        }
+        return *buf;
+    }
+
+    SharedBuffer slice(size_t start, size_t count) const {
+        SharedBuffer view;
+        view.buf = buf;
+        view.external = external;
+        view.owner = owner;
+        view.offset = offset + start;
+        view.length = count;
+        return view;
+    }
+
+    bool isView() const { return length != whole; }
+    bool isShared() const { return external || (buf && buf.use_count() > 1); }
+    size_t size() const { return isView() ? length : (buf ? buf->size() : 0); }
+    bool empty() const { return size() == 0; }
+    const T* data() const { return external ? external + offset : buf ? buf->data() + offset : nullptr; }
+    const T& operator[](size_t i) const { return external ? external[offset + i] : (*buf)[offset + i]; }
+};
+
+// Packed validity bitmap, one bit per row (1 = valid). Bits past the end of
+// an owned bitmap are always zero. A sliced bitmap may start mid-word; read
+// whole words through wordAt(), which realigns them.
+class Bitmap {
+private:
+    SharedBuffer<uint64_t> words;
+    size_t bitOffset = 0;
+    size_t bits = 0;
+
+    static size_t wordsFor(size_t n) { return (n + 63) / 64; }
+
+    void clearTail() {
+        if (bits % 64 != 0) words.mutate().back() &= (uint64_t(1) << (bits % 64)) - 1;
+    }
+
+    // Re-packs a slice into an owned, word-aligned buffer before a write.
+    void materialize() {
+        if (bitOffset == 0 && !words.isView()) return;
+        std::vector<uint64_t> packed(wordsFor(bits));
+        for (size_t k = 0; k < packed.size(); ++k) packed[k] = wordAt(k);
+        words = SharedBuffer<uint64_t>(std::move(packed));
+        bitOffset = 0;
+    }
+
+public:
+    Bitmap() = default;
+    explicit Bitmap(size_t n, bool value = false)
+        : words(std::vector<uint64_t>(wordsFor(n), value ? ~uint64_t(0) : 0)), bits(n) {
+        if (value) clearTail();
+    }
+    // Adopts packed words holding at least n bits. An owned buffer is trimmed
+    // to n bits and has any bits past n cleared; a borrowed one is left as is
+    // and realigned through wordAt() when it is first written.
+    Bitmap(SharedBuffer<uint64_t> packed, size_t n) : words(std::move(packed)), bits(n) {
+        if (words.size() < wordsFor(n)) throw std::invalid_argument("Bitmap buffer is too small.");
+        if (words.isView()) return;
+        if (words.size() > wordsFor(n)) words.mutate().resize(wordsFor(n));
+        if (n % 64 != 0 && (words[n >> 6] >> (n & 63)) != 0) clearTail();
+    }
+
+    size_t size() const { return bits; }
+    bool empty() const { return bits == 0; }
+
+    bool get(size_t i) const {
+        size_t j = bitOffset + i;
+        return (words[j >> 6] >> (j & 63)) & 1;
+    }
+    void set(size_t i, bool v) {
+        materialize();
+        uint64_t mask = uint64_t(1) << (i & 63);
+        if (v) words.mutate()[i >> 6] |= mask;
+        else   words.mutate()[i >> 6] &= ~mask;
+    }
+
+    // Bits [64k, 64k + 64) of this bitmap, zero-padded past size().
+    uint64_t wordAt(size_t k) const {
+        size_t j = bitOffset + k * 64;
+        size_t w = j >> 6, shift = j & 63;
+        uint64_t word = words[w] >> shift;
+        if (shift != 0 && w + 1 < words.size()) word |= words[w + 1] << (64 - shift);
+        size_t remaining = bits - k * 64;
+        if (remaining < 64) word &= (uint64_t(1) << remaining) - 1;
+        return word;
+    }
+    size_t numWords() const { return wordsFor(bits); }
+
+    Bitmap slice(size_t start, size_t count) const {
+        Bitmap view;
+        size_t j = bitOffset + start;
+        view.words = words.slice(j >> 6, wordsFor((j & 63) + count));
+        view.bitOffset = j & 63;
+        view.bits = count;
+        return view;
+    }
+
+    void push_back(bool v) {
+        materialize();
+        if (bits % 64 == 0) words.mutate().push_back(0);
+        ++bits;
+        if (v) set(bits - 1, true);
+    }
+
+    void resize(size_t n, bool value = false) {
+        materialize();
+        size_t old = bits;
+        words.mutate().resize(wordsFor(n), 0);
+        bits = n;
+        if (value) for (size_t i = old; i < n; ++i) set(i, true);
+        clearTail();
+    }
+
+    void append(const Bitmap& other) {
+        // A copy shares the words, so the write below detaches this bitmap
+        // and leaves the source intact.
+        if (&other == this) { Bitmap source(other); append(source); return; }
+        const size_t n = other.bits;
+        materialize();
+        if (bits % 64 == 0) {
+            const size_t nWords = other.numWords();
+            auto& dst = words.mutate();
+            for (size_t k = 0; k < nWords; ++k) dst.push_back(other.wordAt(k));
+            bits += n;
+            return;
+        }
+        reserve(bits + n);
+        for (size_t i = 0; i < n; ++i) push_back(other.get(i));
+    }
+
+    void reserve(size_t n) { materialize(); words.mutate().reserve(wordsFor(n)); }
+    void clear() { words = SharedBuffer<uint64_t>(); bitOffset = 0; bits = 0; }
+
+    size_t count() const {
+        size_t total = 0;
+        for (size_t k = 0; k < numWords(); ++k) total += static_cast<size_t>(__builtin_popcountll(wordAt(k)));
+        return total;
+    }
+};
+
+// Write-through proxy returned by the mutable operator[] of a column.
+template<typename Col>
+class ColumnReference {
+private:
+    Col* col;
+    size_t pos;
+
+public:
+    using value_type = typename Col::value_type;
+    using element_type = typename Col::element_type;
+
+    ColumnReference(Col* c, size_t i) : col(c), pos(i) {}
+
+    ColumnReference& operator=(const value_type& v) { col->set(pos, v); return *this; }
+    ColumnReference& operator=(const ColumnReference& other) { return *this = value_type(other); }
+
+    operator value_type() const { return col->get(pos); }
+    bool isNA() const { return col->isNA(pos); }
+    element_type valueUnsafe() const { return element_type(col->value(pos)); }
+    element_type valueOr(element_type defaultVal) const {
+        return col->isNA(pos) ? defaultVal : element_type(col->value(pos));
+    }
+};
+
+// Read-only iterator yielding Nullable values by copy.
+template<typename Col>
+class ColumnConstIterator {
+private:
+    const Col* col;
+    size_t pos;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename Col::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    ColumnConstIterator(const Col* c, size_t i) : col(c), pos(i) {}
+
+    value_type operator*() const { return col->get(pos); }
+    ColumnConstIterator& operator++() { ++pos; return *this; }
+    ColumnConstIterator operator++(int) { ColumnConstIterator tmp = *this; ++pos; return tmp; }
+    ColumnConstIterator& operator--() { --pos; return *this; }
+    ColumnConstIterator& operator+=(difference_type n) { pos += n; return *this; }
+    ColumnConstIterator operator+(difference_type n) const { return ColumnConstIterator(col, pos + n); }
+    difference_type operator-(const ColumnConstIterator& o) const {
+        return static_cast<difference_type>(pos) - static_cast<difference_type>(o.pos);
+    }
+    bool operator==(const ColumnConstIterator& o) const { return pos == o.pos; }
+    bool operator!=(const ColumnConstIterator& o) const { return pos != o.pos; }
+};
+
+// Columnar storage for a fixed-width type: a dense value buffer plus a packed
+// validity bitmap. NA slots hold T{} in the value buffer, so kernels may run
+// over data() unconditionally and mask with validity() afterwards.
+//
+// Element access returns Nullable<T> by value; the non-const operator[]
+// returns a proxy that writes through to the buffers.
+template<typename T>
+class Column {
+public:
+    using value_type = Nullable<T>;
+    using element_type = T;
+    // std::vector<bool> has no data(), so booleans are stored one per byte.
+    using storage_type = std::conditional_t<std::is_same_v<T, bool>, uint8_t, T>;
+    using reference = ColumnReference<Column>;
+    using const_iterator = ColumnConstIterator<Column>;
+
+private:
+    SharedBuffer<storage_type> values;
+    Bitmap valid;
+
+public:
+    Column() = default;
+    explicit Column(size_t n) : values(std::vector<storage_type>(n, storage_type{})), valid(n, false) {}
+    Column(size_t n, const Nullable<T>& fill)
+        : values(std::vector<storage_type>(
+              n, fill.isNA() ? storage_type{} : static_cast<storage_type>(fill.valueUnsafe()))),
+          valid(n, !fill.isNA()) {}
+    Column(std::initializer_list<Nullable<T>> init) {
+        reserve(init.size());
+        for (const auto& v : init) push_back(v);
+    }
+    // Adopts a dense buffer; every slot is valid.
+    explicit Column(std::vector<storage_type> data)
+        : valid(data.size(), true) { values = SharedBuffer<storage_type>(std::move(data)); }
+    Column(std::vector<storage_type> data, Bitmap validity)
+        : values(std::move(data)), valid(std::move(validity)) {
+        if (values.size() != valid.size()) {
+            throw std::invalid_argument("Value buffer and validity bitmap size mismatch.");
+        }
+    }
+    Column(SharedBuffer<storage_type> data, Bitmap validity)
+        : values(std::move(data)), valid(std::move(validity)) {
+        if (values.size() != valid.size()) {
+            throw std::invalid_argument("Value buffer and validity bitmap size mismatch.");
+        }
+    }
+
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+    void reserve(size_t n) { values.mutate().reserve(n); valid.reserve(n); }
+    void clear() { values = SharedBuffer<storage_type>(); valid.clear(); }
+    void resize(size_t n) { values.mutate().resize(n, storage_type{}); valid.resize(n, false); }
+
+    void push_back(const Nullable<T>& v) {
+        if (v.isNA()) pushNA();
+        else push_back(v.valueUnsafe());
+    }
+    void push_back(T v) {
+        values.mutate().push_back(static_cast<storage_type>(v));
+        valid.push_back(true);
+    }
+    void pushNA() {
+        values.mutate().push_back(storage_type{});
+        valid.push_back(false);
+    }
+
+    bool isNA(size_t i) const { return !valid.get(i); }
+    bool isValid(size_t i) const { return valid.get(i); }
+    T value(size_t i) const { return static_cast<T>(values[i]); }
+    Nullable<T> get(size_t i) const {
+        if (!valid.get(i)) return NA_VALUE;
+        return Nullable<T>(static_cast<T>(values[i]));
+    }
+
+    void set(size_t i, T v) {
+        values.mutate()[i] = static_cast<storage_type>(v);
+        valid.set(i, true);
+    }
+    void set(size_t i, const Nullable<T>& v) {
+        if (v.isNA()) setNA(i);
+        else set(i, v.valueUnsafe());
+    }
+    void setNA(size_t i) {
+        values.mutate()[i] = storage_type{};
+        valid.set(i, false);
+    }
+
+    Nullable<T> operator[](size_t i) const { return get(i); }
+    reference operator[](size_t i) { return reference(this, i); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    const storage_type* data() const { return values.data(); }
+    // Detaches the buffer if it is shared with another column.
+    storage_type* mutableData() { return values.mutate().data(); }
+    // Whether mutableData() would have to copy the values first.
+    bool sharesValues() const { return values.isShared() || values.isView(); }
+    const Bitmap& validity() const { return valid; }
+    // Replaces the bitmap wholesale, for kernels that work out validity a
+    // word at a time; slots it marks NA keep whatever values they hold.
+    void setValidity(Bitmap validity) {
+        if (validity.size() != size()) {
+            throw std::invalid_argument("Value buffer and validity bitmap size mismatch.");
+        }
+        valid = std::move(validity);
+    }
+
+    size_t nullCount() const { return size() - valid.count(); }
+
+    // Calls f(i, value) for every valid slot, walking the bitmap a word at a
+    // time and skipping it entirely when the column has no nulls.
+    template<typename F>
+    void forEachValid(F&& f) const {
+        const size_t n = size();
+        const storage_type* data = values.data();
+        if (valid.count() == n) {
+            for (size_t i = 0; i < n; ++i) f(i, static_cast<T>(data[i]));
+            return;
+        }
+        for (size_t w = 0; w < valid.numWords(); ++w) {
+            uint64_t word = valid.wordAt(w);
+            while (word) {
+                size_t i = w * 64 + static_cast<size_t>(__builtin_ctzll(word));
+                f(i, static_cast<T>(data[i]));
+                word &= word - 1;
+            }
+        }
+    }
+
+    // O(1) view sharing this column's buffers; copied on first write.
+    Column slice(size_t start, size_t end) const {
+        Column result;
+        result.values = values.slice(start, end - start);
+        result.valid = valid.slice(start, end - start);
+        return result;
+    }
+
+    void append(const Column& other) {
+        // Appending to itself goes through a copy sharing the buffers, so
+        // mutate() detaches and src keeps pointing at the original values.
+        if (&other == this) { Column source(other); append(source); return; }
+        const storage_type* src = other.values.data();
+        const size_t n = other.size();
+        auto& dst = values.mutate();
+        dst.insert(dst.end(), src, src + n);
+        valid.append(other.valid);
+    }
+
+    Column take(const std::vector<size_t>& positions) const {
+        const storage_type* data = values.data();
+        std::vector<storage_type> taken;
+        Bitmap takenValid;
+        taken.reserve(positions.size());
+        takenValid.reserve(positions.size());
+        for (size_t pos : positions) {
+            taken.push_back(data[pos]);
+            takenValid.push_back(valid.get(pos));
+        }
+        return Column(std::move(taken), std::move(takenValid));
+    }
+
+    // A copy with every value converted to U, sharing the validity bitmap.
+    template<typename U>
+    Column<U> cast() const {
+        using Out = typename Column<U>::storage_type;
+        const storage_type* data = values.data();
+        std::vector<Out> converted(size());
+        for (size_t i = 0; i < converted.size(); ++i) {
+            converted[i] = static_cast<Out>(static_cast<U>(static_cast<T>(data[i])));
+        }
+        return Column<U>(std::move(converted), valid);
+    }
+};
+
+// Variable-length strings stored as one contiguous character buffer plus an
+// offsets array (offsets[i]..offsets[i + 1] delimits row i) and a validity
+// bitmap. NA rows occupy zero bytes. Slices share the character buffer and
+// view a sub-range of the offsets. value(i) returns a std::string_view into
+// the character buffer; it is invalidated by any mutation of the column.
+//
+// Appending is amortised O(1). Overwriting a row in the middle (set, or
+// assignment through operator[]) has to shift the following bytes, so bulk
+// rewrites should build a new column instead.
+class StringColumn {
+public:
+    using value_type = Nullable<std::string>;
+    using element_type = std::string;
+    using offset_type = int64_t;
+    using reference = ColumnReference<StringColumn>;
+    using const_iterator = ColumnConstIterator<StringColumn>;
+
+private:
+    SharedBuffer<offset_type> offsets{std::vector<offset_type>{0}};
+    SharedBuffer<char> chars;
+    Bitmap valid;
+
+    void splice(size_t i, std::string_view v);
+    void compact();
+
+public:
+    StringColumn() = default;
+    explicit StringColumn(size_t n);
+    StringColumn(size_t n, const Nullable<std::string>& fill);
+    StringColumn(std::initializer_list<Nullable<std::string>> init);
+    // Adopts offsets (size() + 1 of them, into charBuffer) and validity.
+    StringColumn(SharedBuffer<offset_type> offsetBuffer, SharedBuffer<char> charBuffer, Bitmap validity);
+
+    size_t size() const { return offsets.size() - 1; }
+    bool empty() const { return size() == 0; }
+    void reserve(size_t n) { compact(); offsets.mutate().reserve(n + 1); valid.reserve(n); }
+    void reserveBytes(size_t n) { compact(); chars.mutate().reserve(n); }
+    void clear() { offsets = SharedBuffer<offset_type>(std::vector<offset_type>{0}); chars = SharedBuffer<char>(); valid.clear(); }
+    void resize(size_t n);
+
+    void push_back(const Nullable<std::string>& v) {
+        if (v.isNA()) pushNA();
+        else push_back(std::string_view(v.valueUnsafe()));
+    }
+    void push_back(const std::string& v) { push_back(std::string_view(v)); }
+    void push_back(const char* v) { push_back(std::string_view(v)); }
+    void push_back(std::string_view v) {
+        compact();
+        auto& bytes = chars.mutate();
+        bytes.insert(bytes.end(), v.begin(), v.end());
+        offsets.mutate().push_back(static_cast<offset_type>(bytes.size()));
+        valid.push_back(true);
+    }
+    void pushNA() {
+        compact();
+        offsets.mutate().push_back(static_cast<offset_type>(chars.size()));
+        valid.push_back(false);
+    }
+
+    bool isNA(size_t i) const { return !valid.get(i); }
+    bool isValid(size_t i) const { return valid.get(i); }
+    std::string_view value(size_t i) const {
+        return std::string_view(chars.data() + offsets[i], static_cast<size_t>(offsets[i + 1] - offsets[i]));
+    }
+    Nullable<std::string> get(size_t i) const {
+        if (!valid.get(i)) return NA_VALUE;
+        return Nullable<std::string>(std::string(value(i)));
+    }
+
+    void set(size_t i, std::string_view v) { splice(i, v); valid.set(i, true); }
+    void set(size_t i, const std::string& v) { set(i, std::string_view(v)); }
+    void set(size_t i, const char* v) { set(i, std::string_view(v)); }
+    void set(size_t i, const Nullable<std::string>& v) {
+        if (v.isNA()) setNA(i);
+        else set(i, std::string_view(v.valueUnsafe()));
+    }
+    void setNA(size_t i) { splice(i, std::string_view()); valid.set(i, false); }
+
+    Nullable<std::string> operator[](size_t i) const { return get(i); }
+    reference operator[](size_t i) { return reference(this, i); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    // Offsets index into charData(); a sliced column's first offset need not be 0.
+    const offset_type* offsetData() const { return offsets.data(); }
+    const char* charData() const { return chars.data(); }
+    size_t numBytes() const { return static_cast<size_t>(offsets[size()] - offsets[0]); }
+    const Bitmap& validity() const { return valid; }
+
+    size_t nullCount() const { return size() - valid.count(); }
+
+    template<typename F>
+    void forEachValid(F&& f) const {
+        const size_t n = size();
+        for (size_t i = 0; i < n; ++i) {
+            if (valid.get(i)) f(i, value(i));
+        }
+    }
+
+    void append(const StringColumn& other);
+    StringColumn slice(size_t start, size_t end) const;
+    StringColumn take(const std::vector<size_t>& positions) const;
+};
+
+// Distinct category strings of a CategoricalColumn, addressed by code.
+class CategoryDictionary {
+private:
+    StringColumn values;
+    // Keys view the bytes of values and are rebuilt when those move.
+    std::unordered_map<std::string_view, int32_t> lookup;
+
+    void reindex();
+
+public:
+    CategoryDictionary() = default;
+    // Categories in code order; they must be distinct.
+    explicit CategoryDictionary(StringColumn categories);
+
+    size_t size() const { return values.size(); }
+    std::string_view at(int32_t code) const { return values.value(static_cast<size_t>(code)); }
+    // Returns -1 when the category is not present.
+    int32_t find(std::string_view v) const;
+    int32_t insert(std::string_view v);
+    const StringColumn& categories() const { return values; }
+    // Position of each code when the categories are sorted lexicographically.
+    std::vector<int32_t> ranks() const;
+};
+
+// Dictionary-encoded strings: one int32 code per row, a validity bitmap and a
+// dictionary shared between columns derived from the same source (slices,
+// takes, copies). Sorting, filtering and grouping work on the codes; the
+// dictionary is only copied when a shared one needs a new category.
+class CategoricalColumn {
+public:
+    using value_type = Nullable<std::string>;
+    using element_type = std::string;
+    using code_type = int32_t;
+    using reference = ColumnReference<CategoricalColumn>;
+    using const_iterator = ColumnConstIterator<CategoricalColumn>;
+
+private:
+    SharedBuffer<code_type> codes;
+    Bitmap valid;
+    std::shared_ptr<CategoryDictionary> dict;
+
+    CategoryDictionary& mutableDictionary();
+    // Code of v, adding it to the dictionary (detaching a shared one) only
+    // when it is a new category.
+    code_type codeFor(std::string_view v);
+
+public:
+    CategoricalColumn();
+    explicit CategoricalColumn(size_t n);
+    CategoricalColumn(std::initializer_list<Nullable<std::string>> init);
+    CategoricalColumn(std::vector<code_type> codeData, Bitmap validity,
+                      std::shared_ptr<CategoryDictionary> dictionary);
+    CategoricalColumn(SharedBuffer<code_type> codeData, Bitmap validity,
+                      std::shared_ptr<CategoryDictionary> dictionary);
+    explicit CategoricalColumn(const StringColumn& strings);
+
+    size_t size() const { return codes.size(); }
+    bool empty() const { return codes.empty(); }
+    void reserve(size_t n) { codes.mutate().reserve(n); valid.reserve(n); }
+    void clear() { codes = SharedBuffer<code_type>(); valid.clear(); }
+    void resize(size_t n) { codes.mutate().resize(n, 0); valid.resize(n, false); }
+
+    void push_back(const Nullable<std::string>& v) {
+        if (v.isNA()) pushNA();
+        else push_back(std::string_view(v.valueUnsafe()));
+    }
+    void push_back(const std::string& v) { push_back(std::string_view(v)); }
+    void push_back(const char* v) { push_back(std::string_view(v)); }
+    void push_back(std::string_view v) { pushCode(codeFor(v)); }
+    void pushCode(code_type code) { codes.mutate().push_back(code); valid.push_back(true); }
+    void pushNA() { codes.mutate().push_back(0); valid.push_back(false); }
+
+    bool isNA(size_t i) const { return !valid.get(i); }
+    bool isValid(size_t i) const { return valid.get(i); }
+    code_type code(size_t i) const { return codes[i]; }
+    std::string_view value(size_t i) const { return dict->at(codes[i]); }
+    Nullable<std::string> get(size_t i) const {
+        if (!valid.get(i)) return NA_VALUE;
+        return Nullable<std::string>(std::string(value(i)));
+    }
+
+    void set(size_t i, std::string_view v) { codes.mutate()[i] = codeFor(v); valid.set(i, true); }
+    void set(size_t i, const std::string& v) { set(i, std::string_view(v)); }
+    void set(size_t i, const char* v) { set(i, std::string_view(v)); }
+    void set(size_t i, const Nullable<std::string>& v) {
+        if (v.isNA()) setNA(i);
+        else set(i, std::string_view(v.valueUnsafe()));
+    }
+    void setNA(size_t i) { codes.mutate()[i] = 0; valid.set(i, false); }
+
+    Nullable<std::string> operator[](size_t i) const { return get(i); }
+    reference operator[](size_t i) { return reference(this, i); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    const code_type* codeData() const { return codes.data(); }
+    const Bitmap& validity() const { return valid; }
+    const CategoryDictionary& dictionary() const { return *dict; }
+    const std::shared_ptr<CategoryDictionary>& sharedDictionary() const { return dict; }
+    // Code of a category, or -1 if no row can hold that value.
+    code_type codeOf(std::string_view v) const { return dict->find(v); }
+
+    size_t nullCount() const { return size() - valid.count(); }
+
+    template<typename F>
+    void forEachValid(F&& f) const {
+        const size_t n = size();
+        for (size_t i = 0; i < n; ++i) {
+            if (valid.get(i)) f(i, value(i));
+        }
+    }
+
+    void append(const CategoricalColumn& other);
+    CategoricalColumn slice(size_t start, size_t end) const;
+    CategoricalColumn take(const std::vector<size_t>& positions) const;
+    StringColumn toStrings() const;
+};
+
+} // namespace df
+
+#endif // DF_DS_LIBRARY_COLUMN_H
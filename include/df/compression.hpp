@@ -0,0 +1,51 @@
+#ifndef DF_DS_LIBRARY_COMPRESSION_H
+#define DF_DS_LIBRARY_COMPRESSION_H
+
+#include "df/io.hpp"
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace df {
+namespace detail {
+
+// The compression of filename: the one given, or for Infer the one named by
+// its extension (.gz, .zst) or, when reading, by its first bytes.
+io::Compression resolveCompression(const std::string& filename, io::Compression compression, bool reading);
+
+// The bytes of a file in order, inflated block by block as they are read
+// when it is gzip or zstd compressed (Infer is resolved on opening).
+class InputStream {
+private:
+    struct State;
+    std::unique_ptr<State> state;
+
+public:
+    InputStream(const std::string& filename, io::Compression compression);
+    ~InputStream();
+
+    // Reads up to n bytes into out; fewer only at the end of the input.
+    size_t read(char* out, size_t n);
+};
+
+// Writes a file, compressing the bytes as they arrive when asked to; level
+// is the codec's compression level, its default when unset.
+class OutputStream {
+private:
+    struct State;
+    std::unique_ptr<State> state;
+
+public:
+    OutputStream(const std::string& filename, io::Compression compression, std::optional<int> level = std::nullopt);
+    ~OutputStream();
+
+    void write(const char* data, size_t n);
+    // Ends the compressed stream and flushes the file; throws if any of it
+    // could not be written.
+    void finish();
+};
+
+} // namespace detail
+} // namespace df
+
+#endif // DF_DS_LIBRARY_COMPRESSION_H
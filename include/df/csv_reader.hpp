@@ -0,0 +1,150 @@
+#ifndef DF_DS_LIBRARY_CSV_READER_H
+#define DF_DS_LIBRARY_CSV_READER_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace df {
+namespace detail {
+
+// Read-only view of a whole file. Regular files are memory-mapped; anything
+// that cannot be mapped (or when mapping is disabled) is read into memory.
+class MappedFile {
+private:
+    const char* mapped = nullptr;
+    size_t length = 0;
+    std::string buffer;
+
+public:
+    explicit MappedFile(const std::string& filename, bool memoryMap = true);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view view() const { return mapped ? std::string_view(mapped, length) : std::string_view(buffer); }
+};
+
+// Bitmasks of the quote, delimiter and '\n' bytes in a 64-byte block.
+struct BlockMasks {
+    uint64_t quotes;
+    uint64_t delimiters;
+    uint64_t newlines;
+};
+
+// Classifies up to 64 bytes (SSE2/AVX2 when the CPU has them, else scalar).
+BlockMasks scanBlock(const char* data, size_t len, char delimiter, char quotechar);
+
+// Scanners scanBlock can be pinned to when benchmarking; Auto is the fastest
+// the CPU supports.
+enum class BlockScanner { Auto, Scalar, SSE2, AVX2 };
+
+// Pins scanBlock to scanner for full blocks. Returns false, changing nothing,
+// if this build or CPU lacks it. Threads already scanning may finish their
+// current block with the previous scanner.
+bool useBlockScanner(BlockScanner scanner);
+
+// Splits CSV text into records of fields. Quotes may open and close anywhere
+// in a field, a doubled quote inside quotes is a literal quote, and quoted
+// fields may span lines; a '\r' before a line break is dropped. Fields are
+// views into the input except those that need unescaping, which are decoded
+// into storage owned by the tokenizer and stay valid for its lifetime.
+//
+// The input is scanned 64 bytes at a time: a prefix XOR over the quote mask
+// marks quoted regions, and only the delimiters and line breaks outside them
+// are visited. Whether a field holds quotes or line breaks is read off the
+// same masks, so plain fields are never searched byte by byte. With a
+// projection set, fields outside it are skipped without being decoded.
+class CSVTokenizer {
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    std::string_view input;
+    size_t pos = 0;
+    char delimiter;
+    char quotechar;
+    // Decoded fields, packed into blocks that are never moved or freed
+    // before the tokenizer.
+    std::vector<std::unique_ptr<char[]>> decoded;
+    char* decodedNext = nullptr;
+    size_t decodedLeft = 0;
+
+    // Unvisited structural bits of the block at blockBase, where the next
+    // block to scan starts and whether it starts inside quotes.
+    size_t blockBase = 0;
+    size_t scanned = 0;
+    uint64_t structural = 0;
+    uint64_t quoteCarry = 0;
+    // Every quote and '\n' byte of the block at blockBase, and the last of
+    // each before it (npos if none). The quotes of the block before it are
+    // kept to decode fields spanning both.
+    uint64_t quoteBits = 0;
+    uint64_t breakBits = 0;
+    uint64_t prevQuoteBits = 0;
+    size_t lastQuote = npos;
+    size_t lastBreak = npos;
+
+    // Output slot of each field position (noSlot to skip it), when projecting.
+    static constexpr size_t noSlot = static_cast<size_t>(-1);
+    std::vector<size_t> slots;
+    size_t numSlots = 0;
+    bool projected = false;
+
+    bool loadBlock();
+    bool marked(uint64_t bits, size_t last, size_t begin, size_t end) const;
+    std::string_view field(size_t begin, size_t end);
+    std::string_view unescape(size_t begin, size_t end, bool hasBreak);
+    void emit(std::vector<std::string_view>& fields, size_t column, size_t begin, size_t end);
+
+public:
+    CSVTokenizer(std::string_view input, char delimiter, char quotechar);
+
+    // Restricts records to the fields at the given positions: next() then
+    // yields columns.size() fields, fields[i] being field columns[i] of the
+    // record (empty when the record is shorter).
+    void project(const std::vector<size_t>& columns);
+
+    // Reads the next record into fields; returns false once the input is exhausted.
+    bool next(std::vector<std::string_view>& fields);
+    bool atEnd() const { return pos >= input.size(); }
+    size_t offset() const { return pos; }
+    void rewind();
+};
+
+// Whole records found by scanRecords().
+struct RecordScan {
+    size_t end = 0;        // just past the last record-ending '\n'; 0 if none
+    size_t count = 0;      // record-ending line breaks seen
+    bool inQuotes = false; // whether the scan stopped inside quotes
+};
+
+// Continues a scan of input, which starts at a record boundary, from
+// input[from] with the state left by the previous call; for a buffer that
+// grows as more of a file is read.
+void scanRecords(std::string_view input, size_t from, char quotechar, RecordScan& scan);
+
+// Runs fn(0) .. fn(n - 1) concurrently, one thread each, and rethrows the
+// first exception once all have finished.
+void parallelFor(size_t n, const std::function<void(size_t)>& fn);
+
+// Runs fn(0) .. fn(n - 1) on at most workers threads, each taking the next
+// index once done with its last, and rethrows the first exception.
+void parallelTasks(size_t n, size_t workers, const std::function<void(size_t)>& fn);
+
+// Paths matching a shell glob pattern, sorted; none if nothing matches.
+std::vector<std::string> globFiles(const std::string& pattern);
+
+// Offsets splitting input, which must start at a record boundary, into at
+// most parts runs of whole records: 0 = bounds[0] < ... < bounds.back() =
+// input.size(). Quotes are counted per part on at most workers threads, so a
+// boundary is never placed on a line break inside a quoted field.
+std::vector<size_t> splitRecords(std::string_view input, size_t parts, char quotechar, size_t workers);
+
+} // namespace detail
+} // namespace df
+
+#endif // DF_DS_LIBRARY_CSV_READER_H
@@ -21,6 +21,9 @@ private:
     Index index;
     size_t rowCount;
 
+    // The rows at positions, with encoded columns encoded again.
+    DataFrame takeRows(const std::vector<size_t>& positions) const;
+
 public:
     DataFrame();
     DataFrame(const std::vector<std::pair<std::string, ColumnData>>& data);
@@ -37,6 +40,7 @@ public:
     std::vector<std::string> getColumnNames() const;
     const Index& getIndex() const;
     void setIndex(const std::vector<std::string>& labels);
+    void setIndex(const Index& newIndex);
 
     size_t numRows() const;
     size_t numColumns() const;
@@ -45,15 +49,30 @@ public:
     DataFrame operator()(size_t startRow, size_t endRow) const;
     DataFrame head(size_t n = 5) const;
     DataFrame tail(size_t n = 5) const;
+    // Rows whose integer index labels lie between first and last inclusive.
+    DataFrame loc(long long first, long long last) const;
 
     DataFrame select(const std::vector<std::string>& columnNames) const;
     ColumnData operator[](size_t idx) const;
 
     DataFrame filter(const std::function<bool(const ColumnStore&, size_t)>& condition) const;
+    // Rows passing every predicate, with values compared to the bounds as
+    // they are when a file is read with them. Encoded columns are compared
+    // in their encoded form and stay encoded.
+    DataFrame filter(const std::vector<io::ColumnPredicate>& predicates) const;
 
     void sort(const std::string& columnName, bool ascending = true);
+    // Fills the NAs of every column value fits. Numbers a column cannot hold
+    // (out of its range, or fractional for integers) leave its NAs as they are.
     void fillna(const Value& value);
 
+    // Stores the column as an EncodedColumn. Without a name, every integer,
+    // Bool and Timestamp column that the encoding makes smaller.
+    void encode(const std::string& columnName, Encoding encoding = Encoding::Auto);
+    void encode(Encoding encoding = Encoding::Auto);
+    void decode(const std::string& columnName);
+    void decode();
+
     void info() const;
     void display(size_t n = 5) const;
     bool empty() const;
@@ -70,22 +89,59 @@ public:
     DataFrame cov() const;
     DataFrame describe() const;
 
-    DataFrame add(const DataFrame& other, const Value& fillValue = NA_VALUE) const;
-    DataFrame sub(const DataFrame& other, const Value& fillValue = NA_VALUE) const;
-    DataFrame mul(const DataFrame& other, const Value& fillValue = NA_VALUE) const;
-    DataFrame div(const DataFrame& other, const Value& fillValue = NA_VALUE) const;
+    // The rvalue forms reuse this frame's buffers, so a chain such as
+    // std::move(df).add(1).mul(2) only allocates what it widens.
+    DataFrame add(const DataFrame& other, const Value& fillValue = NA_VALUE) const&;
+    DataFrame sub(const DataFrame& other, const Value& fillValue = NA_VALUE) const&;
+    DataFrame mul(const DataFrame& other, const Value& fillValue = NA_VALUE) const&;
+    DataFrame div(const DataFrame& other, const Value& fillValue = NA_VALUE) const&;
+    DataFrame add(const DataFrame& other, const Value& fillValue = NA_VALUE) &&;
+    DataFrame sub(const DataFrame& other, const Value& fillValue = NA_VALUE) &&;
+    DataFrame mul(const DataFrame& other, const Value& fillValue = NA_VALUE) &&;
+    DataFrame div(const DataFrame& other, const Value& fillValue = NA_VALUE) &&;
+
+    template<typename T>
+    DataFrame add(const T& scalar) const&;
+    template<typename T>
+    DataFrame sub(const T& scalar) const&;
+    template<typename T>
+    DataFrame mul(const T& scalar) const&;
+    template<typename T>
+    DataFrame div(const T& scalar) const&;
+    template<typename T>
+    DataFrame add(const T& scalar) &&;
+    template<typename T>
+    DataFrame sub(const T& scalar) &&;
+    template<typename T>
+    DataFrame mul(const T& scalar) &&;
+    template<typename T>
+    DataFrame div(const T& scalar) &&;
+
+    // As above, in place: numeric columns change, bool columns become
+    // integers and the others are left as they are.
+    void addInPlace(const DataFrame& other, const Value& fillValue = NA_VALUE);
+    void subInPlace(const DataFrame& other, const Value& fillValue = NA_VALUE);
+    void mulInPlace(const DataFrame& other, const Value& fillValue = NA_VALUE);
+    void divInPlace(const DataFrame& other, const Value& fillValue = NA_VALUE);
 
     template<typename T>
-    DataFrame add(const T& scalar) const;
+    void addInPlace(const T& scalar);
     template<typename T>
-    DataFrame sub(const T& scalar) const;
+    void subInPlace(const T& scalar);
     template<typename T>
-    DataFrame mul(const T& scalar) const;
+    void mulInPlace(const T& scalar);
     template<typename T>
-    DataFrame div(const T& scalar) const;
+    void divInPlace(const T& scalar);
 
     void toCSV(const std::string& filename, const io::CSVWriteOptions& options = {}) const;
     static DataFrame readCSV(const std::string& filename, const io::CSVReadOptions& options = {});
+    static DataFrame readCSVMany(const std::vector<std::string>& paths, const io::CSVReadOptions& options = {},
+                                 const std::string& sourceColumn = "");
+    void save(const std::string& filename) const;
+    static DataFrame load(const std::string& filename, bool memoryMap = true);
+    void toArrow(const std::string& filename, io::ArrowFormat format = io::ArrowFormat::File) const;
+    static DataFrame readArrow(const std::string& filename, bool memoryMap = true);
+    static DataFrame readParquet(const std::string& filename, const io::ParquetReadOptions& options = {});
 };
 
 } // namespace df
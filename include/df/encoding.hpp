@@ -0,0 +1,114 @@
+#ifndef DF_DS_LIBRARY_ENCODING_H
+#define DF_DS_LIBRARY_ENCODING_H
+
+#include "df/types.hpp"
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace df {
+
+namespace io {
+struct ColumnPredicate;
+}
+
+namespace detail {
+struct EncodedColumnState;
+}
+
+// How an EncodedColumn stores each block of values. RLE keeps runs of equal
+// values, Delta the differences between neighbours, FrameOfReference the
+// offsets from the block's minimum and BitPacked the values themselves
+// (zigzagged when signed), each packed at the fewest bits that hold them.
+// Auto picks whichever is smallest for every block.
+enum class Encoding { Auto, RLE, Delta, FrameOfReference, BitPacked };
+
+// A read-only integer, Bool or Timestamp column compressed in blocks of
+// blockRows values, each of which also keeps the smallest and largest of its
+// valid values. count(), min(), max(), sum(), mean() and matches() work on
+// the blocks as they are stored, skipping any whose range settles the
+// answer. Everything else sees the column decoded (see visitDecoded()), a
+// block at a time where only some rows are needed. Copies share the blocks.
+class EncodedColumn {
+private:
+    std::shared_ptr<const detail::EncodedColumnState> state;
+
+public:
+    static constexpr size_t blockRows = 4096;
+
+    EncodedColumn();
+    // Throws std::invalid_argument for a column of another type.
+    explicit EncodedColumn(const ColumnData& column, Encoding encoding = Encoding::Auto);
+
+    // Whether a column of this type can be encoded.
+    static bool supports(const ColumnData& column);
+
+    DataType type() const;
+    Encoding encoding() const;
+    // Bytes held by the blocks and the validity bitmap.
+    size_t encodedBytes() const;
+
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+    bool isNA(size_t i) const;
+    size_t nullCount() const;
+    const Bitmap& validity() const;
+
+    ColumnData decode() const;
+    // Rows [start, end), decoding only the blocks they fall in.
+    ColumnData slice(size_t start, size_t end) const;
+    ColumnData take(const std::vector<size_t>& positions) const;
+
+    // As stats::count, min, max, sum and mean report them for the decoded column.
+    Value count() const;
+    Value min() const;
+    Value max() const;
+    Value sum() const;
+    Value mean() const;
+
+    // The rows passing predicate, whose column name is ignored. Values
+    // compare with its bounds as they do when a file is read with it.
+    Bitmap matches(const io::ColumnPredicate& predicate) const;
+};
+
+// Calls f with column, or with the plain column an EncodedColumn decodes to,
+// so that f never sees an EncodedColumn.
+template<typename F>
+decltype(auto) visitDecoded(F&& f, const ColumnData& column) {
+    using Result = std::invoke_result_t<F&, const IntColumn&>;
+    return std::visit([&f](const auto& col) -> Result {
+        if constexpr (std::is_same_v<std::decay_t<decltype(col)>, EncodedColumn>) {
+            return visitDecoded(f, col.decode());
+        } else {
+            return f(col);
+        }
+    }, column);
+}
+
+// As visitDecoded, for f that modifies the column: an EncodedColumn is
+// decoded for f and encoded again afterwards if its new type allows.
+template<typename F>
+void visitDecodedInPlace(F&& f, ColumnData& column) {
+    std::optional<Encoding> encoding;
+    if (const auto* encoded = std::get_if<EncodedColumn>(&column)) {
+        encoding = encoded->encoding();
+        column = encoded->decode();
+    }
+    std::visit([&f](auto& col) {
+        if constexpr (!std::is_same_v<std::decay_t<decltype(col)>, EncodedColumn>) f(col);
+    }, column);
+    if (encoding && EncodedColumn::supports(column)) column = EncodedColumn(column, *encoding);
+}
+
+// Calls f with column, or for an EncodedColumn with an empty column of the
+// type it decodes to, for f that only looks at the column's type.
+template<typename F>
+decltype(auto) visitType(F&& f, const ColumnData& column) {
+    if (const auto* encoded = std::get_if<EncodedColumn>(&column)) return visitDecoded(f, encoded->slice(0, 0));
+    return visitDecoded(f, column);
+}
+
+} // namespace df
+
+#endif // DF_DS_LIBRARY_ENCODING_H
@@ -15,7 +15,14 @@ class DataFrame;
 class GroupBy {
 public:
     using GroupKey = std::vector<Value>;
-    using GroupMap = std::map<GroupKey, std::vector<size_t>>;
+
+    // Orders keys element-wise; NA components sort after every value and
+    // only compare equal to other NAs, so they form their own group.
+    struct GroupKeyLess {
+        bool operator()(const GroupKey& a, const GroupKey& b) const;
+    };
+
+    using GroupMap = std::map<GroupKey, std::vector<size_t>, GroupKeyLess>;
 
 private:
     std::shared_ptr<DataFrame> df;
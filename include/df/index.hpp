@@ -3,35 +3,197 @@
 
 #include <vector>
 #include <string>
-#include <map>
+#include <memory>
+#include <variant>
+#include <cstdint>
+#include <utility>
 
 namespace df {
 
+// Open-addressing (linear probing) table from label hashes to row positions.
+// Each distinct label takes one slot holding its first position; later rows
+// with the same label are chained behind it in position order, so a probe
+// meets them first to last.
+class PositionTable {
+private:
+    std::vector<uint32_t> slots; // first position + 1; 0 marks an empty slot
+    std::vector<uint32_t> next;  // next position + 1 with the same label; 0 ends the chain
+    size_t mask = 0;
+
+public:
+    PositionTable() = default;
+
+    // equalAt(i, j) tells whether the labels at positions i and j are equal.
+    template<typename HashAt, typename EqualAt>
+    PositionTable(size_t n, HashAt hashAt, EqualAt equalAt) {
+        size_t capacity = 8;
+        while (capacity < n + n / 2) capacity *= 2;
+        slots.assign(capacity, 0);
+        next.assign(n, 0);
+        mask = capacity - 1;
+        std::vector<uint32_t> tails(capacity, 0);
+        for (size_t i = 0; i < n; ++i) {
+            size_t h = hashAt(i) & mask;
+            while (slots[h] != 0 && !equalAt(static_cast<size_t>(slots[h] - 1), i)) h = (h + 1) & mask;
+            if (slots[h] == 0) {
+                slots[h] = static_cast<uint32_t>(i + 1);
+            } else {
+                next[tails[h] - 1] = static_cast<uint32_t>(i + 1);
+            }
+            tails[h] = static_cast<uint32_t>(i + 1);
+        }
+    }
+
+    // Finds the label for which isKey(firstPos) holds and calls f(pos) for
+    // each of its positions, first to last, until f returns true.
+    template<typename IsKey, typename F>
+    void probe(size_t hash, IsKey&& isKey, F&& f) const {
+        if (slots.empty()) return;
+        for (size_t h = hash & mask; slots[h] != 0; h = (h + 1) & mask) {
+            size_t first = static_cast<size_t>(slots[h] - 1);
+            if (!isKey(first)) continue;
+            for (size_t pos = first + 1; pos != 0; pos = next[pos - 1]) {
+                if (f(pos - 1)) return;
+            }
+            return;
+        }
+    }
+};
+
+// Integer labels start, start + step, ... held as an arithmetic progression.
+// Lookups, slices and takes are computed; the label strings are only built
+// if getLabels() is called.
+class RangeIndex {
+private:
+    long long start;
+    long long step;
+    size_t length;
+    mutable std::shared_ptr<const std::vector<std::string>> labels;
+
+public:
+    RangeIndex(long long start, long long stop, long long step = 1);
+
+    size_t size() const { return length; }
+    long long getStart() const { return start; }
+    long long getStop() const { return start + step * static_cast<long long>(length); }
+    long long getStep() const { return step; }
+    long long valueAt(size_t pos) const { return start + step * static_cast<long long>(pos); }
+
+    std::string at(size_t pos) const { return std::to_string(valueAt(pos)); }
+    // Position of label, or size() when the label is not in the range.
+    size_t find(const std::string& label) const;
+    size_t find(long long value) const;
+    const std::vector<std::string>& getLabels() const;
+    // Positions [begin, end) of the labels between first and last inclusive.
+    std::pair<size_t, size_t> locRange(long long first, long long last) const;
+
+    RangeIndex slice(size_t begin, size_t end) const;
+};
+
+// Int64 labels (plain integers or epoch timestamps). Sorted labels are looked
+// up by binary search; unsorted ones through a hash table. Labels may repeat.
+// Copies and slices share the label storage.
+class Int64Index {
+private:
+    std::shared_ptr<const std::vector<int64_t>> values;
+    std::shared_ptr<const PositionTable> table;
+    size_t offset = 0;
+    size_t length = 0;
+    bool sorted = true;
+    bool unique = true;
+    mutable std::shared_ptr<const std::vector<std::string>> labels;
+
+public:
+    explicit Int64Index(std::vector<int64_t> values);
+
+    size_t size() const { return length; }
+    bool isSorted() const { return sorted; }
+    bool isUnique() const { return unique; }
+    int64_t valueAt(size_t pos) const { return (*values)[offset + pos]; }
+    const int64_t* data() const { return values->data() + offset; }
+
+    std::string at(size_t pos) const { return std::to_string(valueAt(pos)); }
+    size_t find(const std::string& label) const;
+    size_t find(int64_t value) const;
+    std::vector<size_t> positions(int64_t value) const;
+    const std::vector<std::string>& getLabels() const;
+    // Positions [begin, end) of the labels between first and last inclusive;
+    // requires sorted labels.
+    std::pair<size_t, size_t> locRange(int64_t first, int64_t last) const;
+
+    Int64Index slice(size_t begin, size_t end) const;
+};
+
+// Arbitrary string labels with hashed O(1) lookup. Labels may repeat; lookups
+// by label return the first match. Copies and slices share the label storage;
+// a slice views positions [offset, offset + length) of its parent.
+class StringIndex {
+private:
+    std::shared_ptr<const std::vector<std::string>> labels;
+    std::shared_ptr<const PositionTable> table;
+    size_t offset = 0;
+    size_t length = 0;
+    bool unique = true;
+    mutable std::shared_ptr<const std::vector<std::string>> viewLabels;
+
+    bool isView() const { return offset != 0 || length != labels->size(); }
+
+public:
+    explicit StringIndex(std::vector<std::string> labels);
+
+    size_t size() const { return length; }
+    bool isUnique() const { return unique; }
+    const std::string& at(size_t pos) const { return (*labels)[offset + pos]; }
+    size_t find(const std::string& label) const;
+    std::vector<size_t> positions(const std::string& label) const;
+    const std::vector<std::string>& getLabels() const;
+
+    StringIndex slice(size_t begin, size_t end) const;
+};
+
 class Index {
 private:
-    std::vector<std::string> labels;
-    std::map<std::string, size_t> labelToPos;
-    bool isDefaultIndex;
+    std::variant<RangeIndex, Int64Index, StringIndex> impl;
 
 public:
     Index(size_t size);
     Index(const std::vector<std::string>& labels);
+    Index(RangeIndex range);
+    Index(Int64Index values);
+    Index(StringIndex labels);
 
     Index(const Index& other) = default;
     Index(Index&& other) noexcept = default;
     Index& operator=(const Index& other) = default;
     Index& operator=(Index&& other) noexcept = default;
 
-    size_t size() const { return labels.size(); }
-    const std::string& at(size_t pos) const;
+    size_t size() const;
+    std::string at(size_t pos) const;
+    // Position of the first row labelled label.
     size_t at(const std::string& label) const;
     bool contains(const std::string& label) const;
-    const std::vector<std::string>& getLabels() const { return labels; }
+    // Positions of every row labelled label, in row order.
+    std::vector<size_t> positions(const std::string& label) const;
+    const std::vector<std::string>& getLabels() const;
+
+    // Positions [begin, end) of the rows whose integer labels lie between
+    // first and last inclusive. Needs a range or sorted Int64 index.
+    std::pair<size_t, size_t> locRange(long long first, long long last) const;
 
     Index slice(size_t start, size_t end) const;
     Index take(const std::vector<size_t>& positions) const;
 
-    bool isDefault() const { return isDefaultIndex; }
+    // The underlying representation, or nullptr when the index is another kind.
+    const RangeIndex* asRange() const { return std::get_if<RangeIndex>(&impl); }
+    const Int64Index* asInt64() const { return std::get_if<Int64Index>(&impl); }
+    const StringIndex* asStrings() const { return std::get_if<StringIndex>(&impl); }
+
+    bool isRange() const { return std::holds_alternative<RangeIndex>(impl); }
+    bool isInt64() const { return std::holds_alternative<Int64Index>(impl); }
+    bool isUnique() const;
+    bool isSorted() const;
+    // True for the 0, 1, ..., n - 1 labels a DataFrame gets by default.
+    bool isDefault() const;
 
     bool operator==(const Index& other) const;
     bool operator!=(const Index& other) const { return !(*this == other); }
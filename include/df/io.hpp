@@ -6,13 +6,40 @@
 #include <vector>
 #include <map>
 #include <optional>
+#include <memory>
 
 namespace df {
 
 class DataFrame;
 
+namespace detail {
+struct CSVChunkReaderState;
+}
+
 namespace io {
 
+// A test on one column applied while reading: rows that fail any predicate
+// in CSVReadOptions::where are dropped before the rest of the row is
+// converted, and Parquet row groups whose statistics rule out a predicate in
+// ParquetReadOptions::where are not read. Cells are compared as numbers when
+// the bound is a number, as true/false (or 1/0) when it is a bool, as times
+// (parsed with dateFormat) when it is a Timestamp, and as text otherwise.
+// NA cells, and cells that do not parse as the bound's kind, fail every
+// comparison; NotEqual is the negation of Equal.
+struct ColumnPredicate {
+    enum class Op { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual, Between, IsNA, NotNA };
+
+    std::string column;
+    Op op;
+    Value value = NA_VALUE;
+    Value upper = NA_VALUE; // inclusive upper bound for Between; value is the lower
+};
+
+// Compression of a CSV file. Infer goes by the file's extension (.gz, .zst)
+// and, when reading, its first bytes. zstd needs a build with DF_HAVE_ZSTD,
+// which build.sh defines when libzstd is installed.
+enum class Compression { Infer, None, Gzip, Zstd };
+
 struct CSVReadOptions {
     char delimiter = ',';
     char quotechar = '"';
@@ -22,15 +49,47 @@ struct CSVReadOptions {
     size_t skipRows = 0;
     std::optional<size_t> nRows = std::nullopt;
     std::vector<std::string> useCols = {};
+    // Columns read as the given type, with cells that do not parse as it
+    // (or are out of its range) read as NA.
     std::map<std::string, DataType> dtype = {};
+    // Column whose values label the rows. Integer and timestamp columns
+    // without NAs become an Int64Index (timestamps as epoch nanoseconds);
+    // anything else becomes string labels.
     std::string indexCol = "";
+    // Inferred string columns whose distinct/non-NA ratio is at most this
+    // are stored as CategoricalColumn. Set to 0 to disable.
+    double categoricalThreshold = 0.5;
+    // Inferred integer columns are IntColumn, or Int64Column when a value
+    // needs 64 bits. With this they take the narrowest of Int8Column,
+    // Int16Column, IntColumn and Int64Column that holds all of their values.
+    bool narrowIntegers = false;
+    // Map the file into memory instead of reading it into a buffer.
+    bool memoryMap = true;
+    // Threads that tokenize and convert chunks of the file in parallel; 0
+    // uses one per hardware thread. Ignored when nRows is set.
+    size_t numThreads = 1;
+    // Convert the file in chunks of bounded size, dropping each chunk's
+    // tokenized cells once converted, rather than in one chunk per thread.
+    bool lowMemory = true;
+    // Only rows passing all of these are read. Types are inferred from the
+    // rows kept, which keep the labels they would have without the filter.
+    std::vector<ColumnPredicate> where = {};
+    // Compressed files are decompressed a block at a time as they are
+    // tokenized, in lowMemory-sized chunks whatever lowMemory and memoryMap
+    // say. Chunks that inferred a column which later turns out to hold
+    // strings are decompressed a second time.
+    Compression compression = Compression::Infer;
+    // Inferred string columns whose values all parse as timestamps are read
+    // as TimestampColumn.
+    bool parseDates = false;
+    // Columns read as TimestampColumn, like a dtype of Timestamp; cells that
+    // do not parse are NA.
+    std::vector<std::string> dateCols = {};
+    // How timestamps are parsed (see TimestampFormat); empty for ISO-8601.
+    std::string dateFormat = "";
 
     // TODO: not implemented yet
     char escapechar = '\\';
-    bool parseDates = false;
-    std::vector<std::string> dateCols = {};
-    std::string dateFormat = "%Y-%m-%d";
-    bool lowMemory = true;
 };
 
 struct CSVWriteOptions {
@@ -42,13 +101,112 @@ struct CSVWriteOptions {
     bool quoteAll = false;
     char lineTerminator = '\n';
     std::vector<std::string> columns = {};
+    // Threads that format blocks of rows in parallel; 0 uses one per
+    // hardware thread. Rows are written in order either way.
+    size_t numThreads = 1;
+    Compression compression = Compression::Infer;
+    // gzip takes 0 to 9, zstd 1 to 22 (or negative for faster); unset uses
+    // the codec's default.
+    std::optional<int> compressionLevel = std::nullopt;
+    // How timestamps are written (see TimestampFormat). Empty writes each
+    // column as ISO-8601 with the precision its values need: the date alone
+    // when all are midnight, else "YYYY-MM-DD HH:MM:SS" and any fraction.
+    std::string dateFormat = "";
 
     // TODO: not implemented yet
     char escapechar = '\\';
-    std::string dateFormat = "%Y-%m-%d";
 };
 
+// Throws std::invalid_argument when two header fields name the same column,
+// as do readCSVMany and CSVChunkReader.
 DataFrame readCSV(const std::string& filename, const CSVReadOptions& options = CSVReadOptions{});
+
+// Reads several CSV files into one DataFrame as readCSV would read their
+// data rows as one file. Paths that name no file are expanded as glob
+// patterns (sorted), e.g. "events-2026-10-*.csv". Columns are matched by
+// name, in the order first seen, and are NA in the rows of files without
+// them; inferred types are promoted across files, files whose column
+// becomes a string column being read again for just that column.
+//
+// Files are parsed concurrently, numThreads at a time (0 for one per
+// hardware thread), the threads left over going to each file's own
+// chunks. The other options apply to each file, nRows included. Rows are
+// labelled 0 .. n - 1 in file order, or by indexCol. A non-empty
+// sourceColumn adds a categorical column of that name holding each row's
+// file path.
+DataFrame readCSVMany(const std::vector<std::string>& paths, const CSVReadOptions& options = CSVReadOptions{},
+                      const std::string& sourceColumn = "");
+
+// Native binary format: every column's buffers (values, validity bitmap,
+// string offsets and bytes, categories) as they are laid out in memory, the
+// index, and a schema footer. load() maps the file, and the columns read the
+// mapped buffers in place until they are first written to.
+void save(const DataFrame& df, const std::string& filename);
+DataFrame load(const std::string& filename, bool memoryMap = true);
+
+// Apache Arrow IPC, as the file format (Feather v2) or the stream format.
+// Integer and floating-point columns map to the Arrow type of the same width
+// and signedness, Bool columns to bool, strings to large_utf8, categoricals
+// to dictionary<int32, large_utf8> and timestamps to timestamp[ns]; a
+// non-default index is written as an "__index_level_0__" column. readArrow()
+// accepts either format, the other string widths, and dates and timestamps
+// of any unit, and borrows buffers from the mapped file when their layout
+// matches a column's (uncompressed, aligned, and for numbers free of nulls).
+enum class ArrowFormat { File, Stream };
+
+void writeArrow(const DataFrame& df, const std::string& filename, ArrowFormat format = ArrowFormat::File);
+DataFrame readArrow(const std::string& filename, bool memoryMap = true);
+
+struct ParquetReadOptions {
+    // Columns to read, in this order; all of them when empty.
+    std::vector<std::string> columns = {};
+    // Only rows passing all of these are read, keeping their row number in
+    // the file (or their index label) as the index.
+    std::vector<ColumnPredicate> where = {};
+    bool memoryMap = true;
+};
+
+// Apache Parquet files with flat columns: booleans, integers (read at the
+// width and signedness of their annotation), floats and doubles, byte
+// arrays read as strings, and DATE and TIMESTAMP columns read as
+// timestamps. Plain, dictionary and RLE encoded pages are read,
+// uncompressed or compressed with snappy, or zstd in builds defining
+// DF_HAVE_ZSTD (build.sh defines it when libzstd is installed).
+DataFrame readParquet(const std::string& filename, const ParquetReadOptions& options = {});
+
+// Reads a CSV file as a sequence of DataFrames of at most chunkRows rows,
+// buffering about one chunk of the file at a time.
+//
+// Columns named in dtype (or dateCols) take that type, and a cell that does
+// not parse as it is NA. The rest are first inferred from the first
+// sampleRows rows the way readCSV infers them (all-NA columns are Double,
+// strings with few distinct values are categorical, and with parseDates
+// strings that all parse as timestamps are timestamps), except that
+// narrowIntegers is ignored. A later chunk whose cells do not fit an inferred
+// column's type widens it, as readCSV would over the whole file: Integer to
+// Int64 to Double, and any type to String (categorical columns stay
+// categorical). That chunk and the ones after it have the wider type;
+// columnTypes() gives the types of the last chunk read. Rows are labelled by
+// their position among the data rows, or by indexCol.
+class CSVChunkReader {
+private:
+    std::unique_ptr<detail::CSVChunkReaderState> state;
+
+public:
+    CSVChunkReader(const std::string& filename, size_t chunkRows,
+                   const CSVReadOptions& options = CSVReadOptions{}, size_t sampleRows = 10000);
+    ~CSVChunkReader();
+
+    CSVChunkReader(const CSVChunkReader&) = delete;
+    CSVChunkReader& operator=(const CSVChunkReader&) = delete;
+
+    const std::vector<std::string>& columnNames() const;
+    const std::vector<DataType>& columnTypes() const;
+
+    // Reads the next chunk into chunk; returns false once the file is exhausted.
+    bool next(DataFrame& chunk);
+};
+
 void toCSV(const DataFrame& df, const std::string& filename, const CSVWriteOptions& options = CSVWriteOptions{});
 
 } // namespace io
@@ -14,6 +14,18 @@ void subtractInPlace(DataFrame& df, const std::string& columnName, const Value&
 void multiplyInPlace(DataFrame& df, const std::string& columnName, const Value& value);
 void divideInPlace(DataFrame& df, const std::string& columnName, const Value& value);
 
+// The whole-frame forms below, in place. Column buffers that are not shared
+// are reused; columns of other types are not touched.
+void addInPlace(DataFrame& df, const DataFrame& other, const Value& fillValue = NA_VALUE);
+void subtractInPlace(DataFrame& df, const DataFrame& other, const Value& fillValue = NA_VALUE);
+void multiplyInPlace(DataFrame& df, const DataFrame& other, const Value& fillValue = NA_VALUE);
+void divideInPlace(DataFrame& df, const DataFrame& other, const Value& fillValue = NA_VALUE);
+
+void addInPlace(DataFrame& df, const Value& value);
+void subtractInPlace(DataFrame& df, const Value& value);
+void multiplyInPlace(DataFrame& df, const Value& value);
+void divideInPlace(DataFrame& df, const Value& value);
+
 DataFrame add(const DataFrame& df, const DataFrame& other, const Value& fillValue = NA_VALUE);
 DataFrame subtract(const DataFrame& df, const DataFrame& other, const Value& fillValue = NA_VALUE);
 DataFrame multiply(const DataFrame& df, const DataFrame& other, const Value& fillValue = NA_VALUE);
@@ -0,0 +1,65 @@
+#ifndef DF_DS_LIBRARY_TIMESTAMP_H
+#define DF_DS_LIBRARY_TIMESTAMP_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace df {
+
+// A point in time as nanoseconds since 1970-01-01T00:00:00 UTC, which spans
+// the years 1677 to 2262. Timestamps compare as their integers.
+struct Timestamp {
+    int64_t nanos = 0;
+
+    Timestamp() = default;
+    constexpr explicit Timestamp(int64_t nanoseconds) : nanos(nanoseconds) {}
+
+    bool operator==(Timestamp other) const { return nanos == other.nanos; }
+    bool operator!=(Timestamp other) const { return nanos != other.nanos; }
+    bool operator<(Timestamp other) const { return nanos < other.nanos; }
+    bool operator>(Timestamp other) const { return nanos > other.nanos; }
+    bool operator<=(Timestamp other) const { return nanos <= other.nanos; }
+    bool operator>=(Timestamp other) const { return nanos >= other.nanos; }
+
+    // "YYYY-MM-DD", followed by " HH:MM:SS" unless it is midnight and by as
+    // many fractional digits (3, 6 or 9) as the time needs.
+    std::string toString() const;
+};
+
+// A layout of timestamps as text, compiled once and then used to parse or
+// format many cells without going through strptime/strftime.
+//
+// The empty format is ISO-8601. Parsing accepts YYYY-MM-DD, optionally
+// followed by 'T' or a space and HH:MM[:SS[.fraction]] with up to nine
+// fractional digits, and then optionally 'Z' or a +HH:MM offset, which is
+// converted to UTC. Formatting writes what Timestamp::toString() does.
+//
+// Other formats are made of literal characters and %Y (four-digit year),
+// %m, %d, %H, %M, %S (one or two digits when parsing, two when formatting),
+// %f (fractional seconds: up to nine digits when parsing; six when
+// formatting, or 3 and 9 as %3f and %9f), %z (Z or a +HH[:MM] offset when
+// parsing, +HHMM when formatting) and %%.
+class TimestampFormat {
+private:
+    struct Step {
+        char directive; // 0 for a literal character
+        char literal;
+        int width;
+    };
+    std::vector<Step> steps;
+
+public:
+    TimestampFormat() = default;
+    explicit TimestampFormat(std::string_view format);
+
+    bool isISO() const { return steps.empty(); }
+    // Parses the whole of text; false when it does not match or is out of range.
+    bool parse(std::string_view text, Timestamp& out) const;
+    void format(Timestamp t, std::string& out) const;
+};
+
+} // namespace df
+
+#endif // DF_DS_LIBRARY_TIMESTAMP_H
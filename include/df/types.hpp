@@ -1,204 +1,123 @@
 #ifndef DF_DS_LIBRARY_TYPES_H
 #define DF_DS_LIBRARY_TYPES_H
 
-#include <vector>
+#include "df/nullable.hpp"
+#include "df/column.hpp"
+#include "df/timestamp.hpp"
+#include <cstdint>
 #include <string>
-#include <variant>
-#include <optional>
 #include <type_traits>
+#include <variant>
 
 namespace df {
 
-struct NA {
-    bool operator==(const NA&) const { return true; }
-    bool operator!=(const NA&) const { return false; }
-    bool operator<(const NA&) const { return false; }
-};
-
-inline constexpr NA NA_VALUE {};
-
-template<typename T>
-class Nullable {
-private:
-    std::optional<T> value;
-
-public:
-    Nullable() : value(std::nullopt) {}
-    Nullable(const T& v) : value(v) {}
-    Nullable(NA) : value(std::nullopt) {}
-
-    template<typename U, typename = std::enable_if_t<
-        std::is_constructible_v<T, const U&> &&
-        !std::is_same_v<std::decay_t<U>, T> &&
-        !std::is_same_v<std::decay_t<U>, Nullable> &&
-        !std::is_same_v<std::decay_t<U>, NA>>>
-    Nullable(const U& v) : value(T(v)) {}
-
-    bool isNA() const { return !value.has_value(); }
-    T valueOr(T defaultVal) const { return value.value_or(defaultVal); }
-    T valueUnsafe() const { return value.value(); }
-
-    // NA == NA returns false (matches pandas).
-    bool operator==(const Nullable& other) const {
-        if (isNA() || other.isNA()) return false;
-        return value.value() == other.value.value();
-    }
-    bool operator!=(const Nullable& other) const { return !(*this == other); }
-
-    bool operator==(const T& other) const {
-        if (isNA()) return false;
-        return value.value() == other;
-    }
-    bool operator!=(const T& other) const { return !(*this == other); }
-
-    bool operator<(const Nullable& other) const {
-        if (isNA() || other.isNA()) return false;
-        return value.value() < other.value.value();
-    }
-    bool operator>(const Nullable& other) const {
-        if (isNA() || other.isNA()) return false;
-        return value.value() > other.value.value();
-    }
-    bool operator<=(const Nullable& other) const {
-        if (isNA() || other.isNA()) return false;
-        return value.value() <= other.value.value();
-    }
-    bool operator>=(const Nullable& other) const {
-        if (isNA() || other.isNA()) return false;
-        return value.value() >= other.value.value();
-    }
-
-    bool operator<(const T& other) const {
-        if (isNA()) return false;
-        return value.value() < other;
-    }
-    bool operator>(const T& other) const {
-        if (isNA()) return false;
-        return value.value() > other;
-    }
-    bool operator<=(const T& other) const {
-        if (isNA()) return false;
-        return value.value() <= other;
-    }
-    bool operator>=(const T& other) const {
-        if (isNA()) return false;
-        return value.value() >= other;
-    }
-
-    template<typename U = T>
-    auto operator+(const Nullable& other) const -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable> {
-        if (isNA() || other.isNA()) return NA_VALUE;
-        return Nullable(value.value() + other.value.value());
-    }
-    template<typename U = T>
-    auto operator-(const Nullable& other) const -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable> {
-        if (isNA() || other.isNA()) return NA_VALUE;
-        return Nullable(value.value() - other.value.value());
-    }
-    template<typename U = T>
-    auto operator*(const Nullable& other) const -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable> {
-        if (isNA() || other.isNA()) return NA_VALUE;
-        return Nullable(value.value() * other.value.value());
-    }
-    template<typename U = T>
-    auto operator/(const Nullable& other) const -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable> {
-        if (isNA() || other.isNA() || other.value.value() == static_cast<T>(0)) return NA_VALUE;
-        return Nullable(value.value() / other.value.value());
-    }
-
-    template<typename U = T>
-    auto operator+(const T& other) const -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable> {
-        if (isNA()) return NA_VALUE;
-        return Nullable(value.value() + other);
-    }
-    template<typename U = T>
-    auto operator-(const T& other) const -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable> {
-        if (isNA()) return NA_VALUE;
-        return Nullable(value.value() - other);
-    }
-    template<typename U = T>
-    auto operator*(const T& other) const -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable> {
-        if (isNA()) return NA_VALUE;
-        return Nullable(value.value() * other);
-    }
-    template<typename U = T>
-    auto operator/(const T& other) const -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable> {
-        if (isNA() || other == static_cast<T>(0)) return NA_VALUE;
-        return Nullable(value.value() / other);
-    }
-
-    template<typename U = T>
-    auto operator+=(const Nullable& other) -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable&> {
-        if (isNA() || other.isNA()) value = std::nullopt;
-        else value = value.value() + other.value.value();
-        return *this;
-    }
-    template<typename U = T>
-    auto operator-=(const Nullable& other) -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable&> {
-        if (isNA() || other.isNA()) value = std::nullopt;
-        else value = value.value() - other.value.value();
-        return *this;
-    }
-    template<typename U = T>
-    auto operator*=(const Nullable& other) -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable&> {
-        if (isNA() || other.isNA()) value = std::nullopt;
-        else value = value.value() * other.value.value();
-        return *this;
-    }
-    template<typename U = T>
-    auto operator/=(const Nullable& other) -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable&> {
-        if (isNA() || other.isNA() || other.value.value() == static_cast<T>(0)) value = std::nullopt;
-        else value = value.value() / other.value.value();
-        return *this;
-    }
-
-    template<typename U = T>
-    auto operator+=(const T& other) -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable&> {
-        if (isNA()) return *this;
-        value = value.value() + other;
-        return *this;
-    }
-    template<typename U = T>
-    auto operator-=(const T& other) -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable&> {
-        if (isNA()) return *this;
-        value = value.value() - other;
-        return *this;
-    }
-    template<typename U = T>
-    auto operator*=(const T& other) -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable&> {
-        if (isNA()) return *this;
-        value = value.value() * other;
-        return *this;
-    }
-    template<typename U = T>
-    auto operator/=(const T& other) -> std::enable_if_t<std::is_arithmetic_v<U>, Nullable&> {
-        if (isNA() || other == static_cast<T>(0)) value = std::nullopt;
-        else value = value.value() / other;
-        return *this;
-    }
-};
-
 using NullableInt = Nullable<int>;
 using NullableDouble = Nullable<double>;
 using NullableBool = Nullable<bool>;
 using NullableString = Nullable<std::string>;
-
-using Value = std::variant<int, double, bool, std::string, NullableInt, NullableDouble, NullableBool, NullableString, NA>;
-
-using IntColumn = std::vector<NullableInt>;
-using DoubleColumn = std::vector<NullableDouble>;
-using BoolColumn = std::vector<NullableBool>;
-using StringColumn = std::vector<NullableString>;
-
-using ColumnData = std::variant<IntColumn, DoubleColumn, BoolColumn, StringColumn>;
-
+using NullableTimestamp = Nullable<Timestamp>;
+using NullableInt8 = Nullable<int8_t>;
+using NullableInt16 = Nullable<int16_t>;
+using NullableInt64 = Nullable<int64_t>;
+using NullableUInt8 = Nullable<uint8_t>;
+using NullableUInt16 = Nullable<uint16_t>;
+using NullableUInt32 = Nullable<uint32_t>;
+using NullableUInt64 = Nullable<uint64_t>;
+using NullableFloat = Nullable<float>;
+
+using Value = std::variant<int, double, bool, std::string, Timestamp, int8_t, int16_t, int64_t, uint8_t, uint16_t,
+                           uint32_t, uint64_t, float, NullableInt, NullableDouble, NullableBool, NullableString,
+                           NullableTimestamp, NullableInt8, NullableInt16, NullableInt64, NullableUInt8,
+                           NullableUInt16, NullableUInt32, NullableUInt64, NullableFloat, NA>;
+
+// IntColumn holds 32-bit ints and DoubleColumn 64-bit floats; the others
+// are named by their width.
+using IntColumn = Column<int>;
+using DoubleColumn = Column<double>;
+using BoolColumn = Column<bool>;
+using TimestampColumn = Column<Timestamp>;
+using Int8Column = Column<int8_t>;
+using Int16Column = Column<int16_t>;
+using Int64Column = Column<int64_t>;
+using UInt8Column = Column<uint8_t>;
+using UInt16Column = Column<uint16_t>;
+using UInt32Column = Column<uint32_t>;
+using UInt64Column = Column<uint64_t>;
+using FloatColumn = Column<float>;
+
+class EncodedColumn; // defined in df/encoding.hpp, included below
+
+using ColumnData = std::variant<IntColumn, DoubleColumn, BoolColumn, StringColumn, CategoricalColumn, TimestampColumn,
+                                Int8Column, Int16Column, Int64Column, UInt8Column, UInt16Column, UInt32Column,
+                                UInt64Column, FloatColumn, EncodedColumn>;
+
+// New types go at the end: the binary format stores these numbers.
 enum class DataType {
     Integer,
     Double,
     Boolean,
-    String
+    String,
+    Categorical,
+    Timestamp,
+    Int8,
+    Int16,
+    Int64,
+    UInt8,
+    UInt16,
+    UInt32,
+    UInt64,
+    Float
 };
 
+// Integer and floating-point columns of any width; bool is neither.
+template<typename Col>
+inline constexpr bool isIntegerColumn = std::is_integral_v<typename Col::element_type> &&
+                                        !std::is_same_v<typename Col::element_type, bool>;
+template<typename Col>
+inline constexpr bool isFloatColumn = std::is_floating_point_v<typename Col::element_type>;
+template<typename Col>
+inline constexpr bool isNumberColumn = isIntegerColumn<Col> || isFloatColumn<Col>;
+
+namespace detail {
+
+template<size_t Bytes>
+using SignedOfSize = std::conditional_t<Bytes == 1, int8_t,
+                     std::conditional_t<Bytes == 2, int16_t, std::conditional_t<Bytes == 4, int, int64_t>>>;
+
+template<typename T, typename U>
+auto commonNumber() {
+    if constexpr (std::is_same_v<T, U> || std::is_same_v<U, bool>) {
+        return T{};
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return U{};
+    } else if constexpr (std::is_floating_point_v<T> || std::is_floating_point_v<U>) {
+        // float keeps 8 and 16-bit integers exact; wider ones need a double.
+        using Other = std::conditional_t<std::is_floating_point_v<T>, U, T>;
+        if constexpr (std::is_same_v<T, double> || std::is_same_v<U, double>) return double{};
+        else if constexpr (std::is_same_v<Other, float> || sizeof(Other) <= 2) return float{};
+        else return double{};
+    } else if constexpr (std::is_signed_v<T> == std::is_signed_v<U>) {
+        return std::conditional_t<(sizeof(T) >= sizeof(U)), T, U>{};
+    } else {
+        // Mixed signedness: the smallest signed type holding both, if any.
+        using Unsigned = std::conditional_t<std::is_signed_v<T>, U, T>;
+        using Signed = std::conditional_t<std::is_signed_v<T>, T, U>;
+        if constexpr (sizeof(Signed) > sizeof(Unsigned)) return Signed{};
+        else if constexpr (sizeof(Unsigned) < 8) return SignedOfSize<sizeof(Unsigned) * 2>{};
+        else return double{};
+    }
+}
+
+} // namespace detail
+
+// The element type arithmetic between columns of T and U produces: the
+// narrowest type holding every value of both (bool counts as 0/1), or
+// double when a signed type meets uint64_t.
+template<typename T, typename U>
+using CommonNumber = decltype(detail::commonNumber<T, U>());
+
 } // namespace df
 
+#include "df/encoding.hpp"
+
 #endif // DF_DS_LIBRARY_TYPES_H
@@ -0,0 +1,1134 @@
+#include "df/io.hpp"
+#include "df/dataframe.hpp"
+#include "df/index.hpp"
+#include "df/csv_reader.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace df {
+
+namespace detail {
+
+// Arrow IPC. A stream is a sequence of encapsulated messages,
+//
+//   u32 0xFFFFFFFF, i32 metadata size, flatbuffer Message (padded to 8), body
+//
+// starting with the Schema, then dictionary and record batches, and ending
+// with a zero metadata size. The file format (Feather v2) is a stream between
+// "ARROW1\0\0" and a footer locating every batch, followed by the i32 footer
+// size and "ARROW1".
+//
+// Only what maps onto DataFrame columns is handled: flat fields of integer,
+// floating point, boolean, string/binary (and their large variants), date,
+// timestamp and dictionary-encoded string type, with uncompressed bodies. A non-default
+// index travels as a column named like the one pandas writes.
+constexpr char arrowMagic[6] = {'A', 'R', 'R', 'O', 'W', '1'};
+constexpr uint32_t arrowContinuation = 0xFFFFFFFF;
+constexpr int16_t arrowMetadataVersion = 4; // V5
+constexpr size_t arrowAlignment = 64;
+constexpr const char* arrowIndexColumn = "__index_level_0__";
+
+enum class ArrowType : uint8_t {
+    Null = 1, Int = 2, FloatingPoint = 3, Binary = 4, Utf8 = 5, Bool = 6, Date = 8, Timestamp = 10,
+    LargeBinary = 19, LargeUtf8 = 20
+};
+enum class ArrowHeader : uint8_t { Schema = 1, DictionaryBatch = 2, RecordBatch = 3 };
+enum class ArrowPrecision : int16_t { Half = 0, Single = 1, Double = 2 };
+// Date units are Day (0) and Millisecond (1); time units go from Second to
+// Nanosecond.
+enum class ArrowTimeUnit : int16_t { Second = 0, Millisecond = 1, Microsecond = 2, Nanosecond = 3 };
+
+struct ArrowBlock {
+    int64_t offset;
+    int32_t metadataLength;
+    int32_t padding;
+    int64_t bodyLength;
+};
+
+struct ArrowFieldNode {
+    int64_t length;
+    int64_t nullCount;
+};
+
+struct ArrowBuffer {
+    int64_t offset;
+    int64_t length;
+};
+
+static bool littleEndian() {
+    const uint16_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+[[noreturn]] static void corruptArrow() { throw std::runtime_error("Corrupt Arrow IPC data."); }
+
+static size_t roundUp(size_t n, size_t alignment) { return (n + alignment - 1) / alignment * alignment; }
+
+// Minimal FlatBuffers encoder for the Arrow metadata. Objects are laid out
+// front to back: a table is preceded by its vtable and followed by the
+// objects it references, so every offset points forward as the format
+// requires.
+class FlatBuilder {
+public:
+    struct Field {
+        uint16_t id;
+        uint8_t size;
+        uint64_t bits;
+        // Writes the referenced object, returning its position; unset for scalars.
+        std::function<size_t(FlatBuilder&)> child;
+    };
+
+    template<typename T>
+    static Field scalar(uint16_t id, T value) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(T));
+        return {id, static_cast<uint8_t>(sizeof(T)), bits, nullptr};
+    }
+    static Field reference(uint16_t id, std::function<size_t(FlatBuilder&)> child) {
+        return {id, 4, 0, std::move(child)};
+    }
+
+    size_t table(std::vector<Field> fields) {
+        // Widest fields first keeps every field aligned without padding.
+        std::stable_sort(fields.begin(), fields.end(), [](const Field& a, const Field& b) { return a.size > b.size; });
+        size_t numSlots = 0;
+        for (const auto& f : fields) numSlots = std::max<size_t>(numSlots, f.id + 1u);
+        std::vector<uint16_t> slots(numSlots, 0);
+        size_t inlineSize = 4;
+        for (const auto& f : fields) {
+            slots[f.id] = static_cast<uint16_t>(inlineSize);
+            inlineSize += f.size;
+        }
+
+        pad(2);
+        size_t vtable = buf.size();
+        put<uint16_t>(static_cast<uint16_t>(4 + 2 * numSlots));
+        put<uint16_t>(static_cast<uint16_t>(inlineSize));
+        for (uint16_t s : slots) put<uint16_t>(s);
+        if (!fields.empty() && fields[0].size == 8) pad(8, 4);
+        else pad(4);
+
+        size_t start = buf.size();
+        put<int32_t>(static_cast<int32_t>(start - vtable));
+        for (const auto& f : fields) buf.append(reinterpret_cast<const char*>(&f.bits), f.size);
+        for (const auto& f : fields) {
+            if (f.child) patch(start + slots[f.id], f.child(*this));
+        }
+        return start;
+    }
+
+    size_t string(std::string_view s) {
+        pad(4);
+        size_t start = buf.size();
+        put<uint32_t>(static_cast<uint32_t>(s.size()));
+        buf.append(s.data(), s.size());
+        buf.push_back('\0');
+        return start;
+    }
+
+    size_t tables(size_t count, const std::function<size_t(FlatBuilder&, size_t)>& element) {
+        pad(4);
+        size_t start = buf.size();
+        put<uint32_t>(static_cast<uint32_t>(count));
+        buf.append(4 * count, '\0');
+        for (size_t i = 0; i < count; ++i) patch(start + 4 + 4 * i, element(*this, i));
+        return start;
+    }
+
+    // A vector of structs (or scalars) of at most 8-byte alignment.
+    template<typename T>
+    size_t structs(const std::vector<T>& elements) {
+        pad(8, 4);
+        size_t start = buf.size();
+        put<uint32_t>(static_cast<uint32_t>(elements.size()));
+        buf.append(reinterpret_cast<const char*>(elements.data()), elements.size() * sizeof(T));
+        return start;
+    }
+
+    // The finished buffer, padded to 8 bytes, with root written by root.
+    std::string finish(const std::function<size_t(FlatBuilder&)>& root) {
+        buf.clear();
+        put<uint32_t>(0);
+        patch(0, root(*this));
+        pad(8);
+        return std::move(buf);
+    }
+
+private:
+    std::string buf;
+
+    template<typename T>
+    void put(T value) { buf.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+    void pad(size_t alignment, size_t remainder = 0) {
+        while (buf.size() % alignment != remainder) buf.push_back('\0');
+    }
+    void patch(size_t at, size_t target) {
+        uint32_t offset = static_cast<uint32_t>(target - at);
+        std::memcpy(&buf[at], &offset, sizeof(offset));
+    }
+};
+
+// Bounds-checked view of a table in a FlatBuffers buffer.
+class FlatTable {
+private:
+    std::string_view buf;
+    size_t pos = 0;
+    size_t vtable = 0;
+    size_t vtableSize = 0;
+
+    template<typename T>
+    T read(size_t at) const {
+        if (at > buf.size() || buf.size() - at < sizeof(T)) corruptArrow();
+        T value;
+        std::memcpy(&value, buf.data() + at, sizeof(T));
+        return value;
+    }
+
+    // Position of field id in the table, or 0 when it is absent.
+    size_t field(uint16_t id) const {
+        size_t slot = 4 + 2 * static_cast<size_t>(id);
+        if (slot + 2 > vtableSize) return 0;
+        uint16_t offset = read<uint16_t>(vtable + slot);
+        return offset == 0 ? 0 : pos + offset;
+    }
+
+    size_t target(uint16_t id) const {
+        size_t at = field(id);
+        if (at == 0) return 0;
+        size_t t = at + read<uint32_t>(at);
+        if (t >= buf.size()) corruptArrow();
+        return t;
+    }
+
+public:
+    FlatTable() = default;
+    FlatTable(std::string_view buffer, size_t position) : buf(buffer), pos(position) {
+        int64_t back = read<int32_t>(pos);
+        if (back > static_cast<int64_t>(pos) || static_cast<int64_t>(pos) - back >= static_cast<int64_t>(buf.size())) {
+            corruptArrow();
+        }
+        vtable = static_cast<size_t>(static_cast<int64_t>(pos) - back);
+        vtableSize = read<uint16_t>(vtable);
+        if (vtableSize < 4 || vtable + vtableSize > buf.size()) corruptArrow();
+    }
+
+    static FlatTable root(std::string_view buffer) {
+        if (buffer.size() < 4) corruptArrow();
+        uint32_t offset;
+        std::memcpy(&offset, buffer.data(), sizeof(offset));
+        return FlatTable(buffer, offset);
+    }
+
+    bool has(uint16_t id) const { return field(id) != 0; }
+
+    template<typename T>
+    T scalar(uint16_t id, T fallback = T{}) const {
+        size_t at = field(id);
+        return at == 0 ? fallback : read<T>(at);
+    }
+
+    FlatTable table(uint16_t id) const {
+        size_t t = target(id);
+        if (t == 0) corruptArrow();
+        return FlatTable(buf, t);
+    }
+
+    std::string_view string(uint16_t id) const {
+        size_t t = target(id);
+        if (t == 0) return {};
+        size_t length = read<uint32_t>(t);
+        if (buf.size() - t - 4 < length) corruptArrow();
+        return buf.substr(t + 4, length);
+    }
+
+    // Number of elements of a vector field (0 when absent); start receives
+    // the position of its first element.
+    size_t vector(uint16_t id, size_t elementSize, size_t& start) const {
+        size_t t = target(id);
+        if (t == 0) return 0;
+        size_t count = read<uint32_t>(t);
+        start = t + 4;
+        if ((buf.size() - start) / elementSize < count) corruptArrow();
+        return count;
+    }
+
+    FlatTable tableAt(size_t start, size_t i) const {
+        size_t at = start + 4 * i;
+        return FlatTable(buf, at + read<uint32_t>(at));
+    }
+
+    template<typename T>
+    T structAt(size_t start, size_t i) const { return read<T>(start + sizeof(T) * i); }
+};
+
+// Record batch body being written: its field nodes, and its buffers as
+// (offset, length) in the body alongside the memory they are written from.
+struct ArrowBody {
+    std::vector<ArrowFieldNode> nodes;
+    std::vector<ArrowBuffer> buffers;
+    std::vector<const char*> sources;
+    std::deque<std::string> scratch;
+    size_t length = 0;
+
+    void add(const void* data, size_t size) {
+        size_t offset = buffers.empty() ? 0 : roundUp(length, arrowAlignment);
+        buffers.push_back({static_cast<int64_t>(offset), static_cast<int64_t>(size)});
+        sources.push_back(static_cast<const char*>(data));
+        length = offset + size;
+    }
+
+    void add(std::string bytes) {
+        scratch.push_back(std::move(bytes));
+        add(scratch.back().data(), scratch.back().size());
+    }
+
+    void addValidity(const Bitmap& validity, size_t nullCount) {
+        if (nullCount == 0) {
+            add(nullptr, 0);
+            return;
+        }
+        std::string bytes(validity.numWords() * 8, '\0');
+        for (size_t k = 0; k < validity.numWords(); ++k) {
+            uint64_t word = validity.wordAt(k);
+            std::memcpy(&bytes[8 * k], &word, sizeof(word));
+        }
+        bytes.resize((validity.size() + 7) / 8);
+        add(std::move(bytes));
+    }
+
+    void addStrings(const StringColumn& strings) {
+        const StringColumn::offset_type* offsets = strings.offsetData();
+        const size_t n = strings.size();
+        if (offsets[0] == 0) {
+            add(offsets, (n + 1) * sizeof(StringColumn::offset_type));
+        } else {
+            std::string rebased((n + 1) * sizeof(StringColumn::offset_type), '\0');
+            for (size_t i = 0; i <= n; ++i) {
+                StringColumn::offset_type offset = offsets[i] - offsets[0];
+                std::memcpy(&rebased[i * sizeof(offset)], &offset, sizeof(offset));
+            }
+            add(std::move(rebased));
+        }
+        add(strings.charData() + offsets[0], strings.numBytes());
+    }
+
+    size_t bodyLength() const { return roundUp(length, 8); }
+};
+
+// One column as it appears in the schema.
+struct ArrowField {
+    std::string name;
+    ArrowType type = ArrowType::Null;
+    int bitWidth = 0;
+    bool isSigned = true;
+    ArrowPrecision precision = ArrowPrecision::Double;
+    int16_t unit = 0; // of a Date or Timestamp
+    bool dictionary = false;
+    int64_t dictionaryId = 0;
+    int indexBitWidth = 32;
+    bool indexSigned = true;
+};
+
+static size_t writeTypeTable(FlatBuilder& fb, const ArrowField& field) {
+    switch (field.type) {
+        case ArrowType::Int:
+            return fb.table({FlatBuilder::scalar<int32_t>(0, field.bitWidth),
+                             FlatBuilder::scalar<uint8_t>(1, field.isSigned)});
+        case ArrowType::FloatingPoint:
+            return fb.table({FlatBuilder::scalar<int16_t>(0, static_cast<int16_t>(field.precision))});
+        case ArrowType::Date:
+        case ArrowType::Timestamp:
+            return fb.table({FlatBuilder::scalar<int16_t>(0, field.unit)});
+        default:
+            return fb.table({});
+    }
+}
+
+static size_t writeFieldTable(FlatBuilder& fb, const ArrowField& field) {
+    std::vector<FlatBuilder::Field> fields = {
+        FlatBuilder::reference(0, [&](FlatBuilder& b) { return b.string(field.name); }),
+        FlatBuilder::scalar<uint8_t>(1, 1),
+        FlatBuilder::scalar<uint8_t>(2, static_cast<uint8_t>(field.type)),
+        FlatBuilder::reference(3, [&](FlatBuilder& b) { return writeTypeTable(b, field); }),
+        FlatBuilder::reference(5, [](FlatBuilder& b) { return b.tables(0, nullptr); }),
+    };
+    if (field.dictionary) {
+        fields.push_back(FlatBuilder::reference(4, [&](FlatBuilder& b) {
+            return b.table({
+                FlatBuilder::scalar<int64_t>(0, field.dictionaryId),
+                FlatBuilder::reference(1, [&](FlatBuilder& c) {
+                    return c.table({FlatBuilder::scalar<int32_t>(0, field.indexBitWidth),
+                                    FlatBuilder::scalar<uint8_t>(1, field.indexSigned)});
+                }),
+            });
+        }));
+    }
+    return fb.table(std::move(fields));
+}
+
+static size_t writeSchemaTable(FlatBuilder& fb, const std::vector<ArrowField>& fields) {
+    return fb.table({
+        FlatBuilder::scalar<int16_t>(0, 0),
+        FlatBuilder::reference(1, [&](FlatBuilder& b) {
+            return b.tables(fields.size(), [&](FlatBuilder& c, size_t i) { return writeFieldTable(c, fields[i]); });
+        }),
+    });
+}
+
+static size_t writeRecordBatchTable(FlatBuilder& fb, size_t rows, const ArrowBody& body) {
+    return fb.table({
+        FlatBuilder::scalar<int64_t>(0, static_cast<int64_t>(rows)),
+        FlatBuilder::reference(1, [&](FlatBuilder& b) { return b.structs(body.nodes); }),
+        FlatBuilder::reference(2, [&](FlatBuilder& b) { return b.structs(body.buffers); }),
+    });
+}
+
+class ArrowWriter {
+private:
+    std::ofstream file;
+    std::string filename;
+    uint64_t pos = 0;
+
+    void padTo(uint64_t target) {
+        static const char zeros[arrowAlignment] = {};
+        while (pos < target) write(zeros, std::min<uint64_t>(target - pos, sizeof(zeros)));
+    }
+
+public:
+    explicit ArrowWriter(const std::string& name) : file(name, std::ios::binary), filename(name) {
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file for writing: " + filename);
+        }
+    }
+
+    void write(const void* data, size_t size) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        pos += size;
+    }
+
+    void writeMagic() {
+        write(arrowMagic, sizeof(arrowMagic));
+        padTo(8);
+    }
+
+    // Writes a message whose header table is written by header.
+    ArrowBlock message(ArrowHeader type, const std::function<size_t(FlatBuilder&)>& header, const ArrowBody* body) {
+        const size_t bodyLength = body ? body->bodyLength() : 0;
+        std::string metadata = FlatBuilder().finish([&](FlatBuilder& fb) {
+            return fb.table({
+                FlatBuilder::scalar<int16_t>(0, arrowMetadataVersion),
+                FlatBuilder::scalar<uint8_t>(1, static_cast<uint8_t>(type)),
+                FlatBuilder::reference(2, header),
+                FlatBuilder::scalar<int64_t>(3, static_cast<int64_t>(bodyLength)),
+            });
+        });
+
+        ArrowBlock block{static_cast<int64_t>(pos), static_cast<int32_t>(8 + metadata.size()), 0,
+                         static_cast<int64_t>(bodyLength)};
+        const int32_t size = static_cast<int32_t>(metadata.size());
+        write(&arrowContinuation, sizeof(arrowContinuation));
+        write(&size, sizeof(size));
+        write(metadata.data(), metadata.size());
+        if (body) {
+            const uint64_t start = pos;
+            for (size_t i = 0; i < body->buffers.size(); ++i) {
+                padTo(start + static_cast<uint64_t>(body->buffers[i].offset));
+                write(body->sources[i], static_cast<size_t>(body->buffers[i].length));
+            }
+            padTo(start + bodyLength);
+        }
+        return block;
+    }
+
+    void endOfStream() {
+        const uint32_t marker[2] = {arrowContinuation, 0};
+        write(marker, sizeof(marker));
+    }
+
+    void footer(const std::vector<ArrowField>& fields, const std::vector<ArrowBlock>& dictionaries,
+                const std::vector<ArrowBlock>& batches) {
+        std::string footer = FlatBuilder().finish([&](FlatBuilder& fb) {
+            return fb.table({
+                FlatBuilder::scalar<int16_t>(0, arrowMetadataVersion),
+                FlatBuilder::reference(1, [&](FlatBuilder& b) { return writeSchemaTable(b, fields); }),
+                FlatBuilder::reference(2, [&](FlatBuilder& b) { return b.structs(dictionaries); }),
+                FlatBuilder::reference(3, [&](FlatBuilder& b) { return b.structs(batches); }),
+            });
+        });
+        write(footer.data(), footer.size());
+        const int32_t size = static_cast<int32_t>(footer.size());
+        write(&size, sizeof(size));
+        write(arrowMagic, sizeof(arrowMagic));
+    }
+
+    void finish() {
+        file.flush();
+        if (!file) {
+            throw std::runtime_error("Failed to write file: " + filename);
+        }
+    }
+};
+
+// Reads the messages of a stream or file held by a mapped file; record batch
+// buffers that need no conversion are borrowed from the mapping.
+class ArrowReader {
+private:
+    std::shared_ptr<const MappedFile> file;
+    std::string_view data;
+    std::vector<ArrowField> fields;
+    std::map<int64_t, std::shared_ptr<CategoryDictionary>> dictionaries;
+
+    // Decoded batches, column by column, and the index labels they carry.
+    std::vector<std::vector<ColumnData>> parts;
+    std::vector<int64_t> intLabels;
+    std::vector<std::string> stringLabels;
+    int indexField = -1;
+
+    struct Message {
+        ArrowHeader type;
+        FlatTable header;
+        std::string_view body;
+    };
+
+    // Reads the message at pos, advancing past it; false at end of stream.
+    bool readMessage(size_t& pos, Message& message) const {
+        if (data.size() - pos < 4) return false;
+        uint32_t size;
+        std::memcpy(&size, data.data() + pos, sizeof(size));
+        pos += 4;
+        if (size == arrowContinuation) {
+            if (data.size() - pos < 4) corruptArrow();
+            std::memcpy(&size, data.data() + pos, sizeof(size));
+            pos += 4;
+        }
+        if (size == 0) return false;
+        if (data.size() - pos < size) corruptArrow();
+        FlatTable root = FlatTable::root(data.substr(pos, size));
+        pos += size;
+
+        int64_t bodyLength = root.scalar<int64_t>(3);
+        if (bodyLength < 0 || data.size() - pos < static_cast<uint64_t>(bodyLength)) corruptArrow();
+        message.type = static_cast<ArrowHeader>(root.scalar<uint8_t>(1));
+        message.header = root.table(2);
+        message.body = data.substr(pos, static_cast<size_t>(bodyLength));
+        pos += static_cast<size_t>(bodyLength);
+        return true;
+    }
+
+    static ArrowField readField(const FlatTable& table) {
+        ArrowField field;
+        field.name = std::string(table.string(0));
+        field.type = static_cast<ArrowType>(table.scalar<uint8_t>(2));
+        size_t start = 0;
+        if (table.vector(5, 4, start) != 0) {
+            throw std::runtime_error("Nested Arrow type in column '" + field.name + "' is not supported.");
+        }
+        switch (field.type) {
+            case ArrowType::Int: {
+                FlatTable type = table.table(3);
+                field.bitWidth = type.scalar<int32_t>(0);
+                field.isSigned = type.scalar<uint8_t>(1) != 0;
+                if (field.bitWidth != 8 && field.bitWidth != 16 && field.bitWidth != 32 && field.bitWidth != 64) {
+                    corruptArrow();
+                }
+                break;
+            }
+            case ArrowType::FloatingPoint:
+                field.precision = static_cast<ArrowPrecision>(table.table(3).scalar<int16_t>(0));
+                if (field.precision == ArrowPrecision::Half) {
+                    throw std::runtime_error("Half-precision Arrow column '" + field.name + "' is not supported.");
+                }
+                break;
+            case ArrowType::Date:
+            case ArrowType::Timestamp:
+                // Timestamps are UTC whatever their time zone, which is dropped.
+                // An omitted Date unit is Millisecond.
+                field.unit = table.table(3).scalar<int16_t>(0, field.type == ArrowType::Date ? 1 : 0);
+                if (field.unit < 0 || field.unit > (field.type == ArrowType::Date ? 1 : 3)) corruptArrow();
+                break;
+            case ArrowType::Null:
+            case ArrowType::Binary:
+            case ArrowType::Utf8:
+            case ArrowType::Bool:
+            case ArrowType::LargeBinary:
+            case ArrowType::LargeUtf8:
+                break;
+            default:
+                throw std::runtime_error("Unsupported Arrow type in column '" + field.name + "'.");
+        }
+        if (table.has(4)) {
+            FlatTable encoding = table.table(4);
+            field.dictionary = true;
+            field.dictionaryId = encoding.scalar<int64_t>(0);
+            if (encoding.has(1)) {
+                FlatTable indexType = encoding.table(1);
+                field.indexBitWidth = indexType.scalar<int32_t>(0);
+                field.indexSigned = indexType.scalar<uint8_t>(1) != 0;
+            }
+            if (field.indexBitWidth != 8 && field.indexBitWidth != 16 && field.indexBitWidth != 32 &&
+                field.indexBitWidth != 64) {
+                corruptArrow();
+            }
+            if (field.type != ArrowType::Utf8 && field.type != ArrowType::LargeUtf8 &&
+                field.type != ArrowType::Binary && field.type != ArrowType::LargeBinary) {
+                throw std::runtime_error("Dictionary-encoded Arrow column '" + field.name +
+                                         "' must have string values.");
+            }
+        }
+        return field;
+    }
+
+    void readSchema(const FlatTable& schema) {
+        if (schema.scalar<int16_t>(0) != 0) {
+            throw std::runtime_error("Big-endian Arrow data is not supported.");
+        }
+        size_t start = 0;
+        size_t count = schema.vector(1, 4, start);
+        fields.clear();
+        for (size_t i = 0; i < count; ++i) {
+            fields.push_back(readField(schema.tableAt(start, i)));
+            if (fields.back().name == arrowIndexColumn && !fields.back().dictionary &&
+                (fields.back().type == ArrowType::Int || fields.back().type == ArrowType::Utf8 ||
+                 fields.back().type == ArrowType::LargeUtf8)) {
+                indexField = static_cast<int>(i);
+            }
+        }
+    }
+
+    // Walks the field nodes and buffers of one record batch in schema order.
+    class Batch {
+    private:
+        const ArrowReader& reader;
+        FlatTable table;
+        std::string_view body;
+        size_t nodesStart = 0, numNodes = 0, nextNode = 0;
+        size_t buffersStart = 0, numBuffers = 0, nextBuffer = 0;
+
+    public:
+        Batch(const ArrowReader& owner, const FlatTable& batch, std::string_view bodyData)
+            : reader(owner), table(batch), body(bodyData) {
+            if (table.has(3)) {
+                throw std::runtime_error("Compressed Arrow record batches are not supported.");
+            }
+            numNodes = table.vector(1, sizeof(ArrowFieldNode), nodesStart);
+            numBuffers = table.vector(2, sizeof(ArrowBuffer), buffersStart);
+        }
+
+        size_t length() const {
+            int64_t n = table.scalar<int64_t>(0);
+            if (n < 0) corruptArrow();
+            return static_cast<size_t>(n);
+        }
+
+        ArrowFieldNode node() {
+            if (nextNode == numNodes) corruptArrow();
+            ArrowFieldNode n = table.structAt<ArrowFieldNode>(nodesStart, nextNode++);
+            if (static_cast<uint64_t>(n.length) != length() || n.nullCount < 0 || n.nullCount > n.length) corruptArrow();
+            return n;
+        }
+
+        std::string_view buffer() {
+            if (nextBuffer == numBuffers) corruptArrow();
+            ArrowBuffer b = table.structAt<ArrowBuffer>(buffersStart, nextBuffer++);
+            if (b.offset < 0 || b.length < 0 || static_cast<uint64_t>(b.offset) > body.size() ||
+                body.size() - static_cast<size_t>(b.offset) < static_cast<uint64_t>(b.length)) {
+                corruptArrow();
+            }
+            return body.substr(static_cast<size_t>(b.offset), static_cast<size_t>(b.length));
+        }
+
+        Bitmap validity(size_t n, size_t nullCount) {
+            std::string_view bits = buffer();
+            // Every other layout needs at least a bit per row.
+            if (n / 8 > body.size()) corruptArrow();
+            if (nullCount == 0) return Bitmap(n, true);
+            if (bits.size() < (n + 7) / 8) corruptArrow();
+            // Buffers are padded to 8 bytes, so whole words can be read in place.
+            const size_t words = (n + 63) / 64;
+            const size_t readable = static_cast<size_t>(body.data() + body.size() - bits.data());
+            if (reinterpret_cast<uintptr_t>(bits.data()) % alignof(uint64_t) == 0 && readable >= words * 8) {
+                return Bitmap(SharedBuffer<uint64_t>::borrow(reinterpret_cast<const uint64_t*>(bits.data()), words,
+                                                              reader.file), n);
+            }
+            std::vector<uint64_t> packed(words, 0);
+            std::memcpy(packed.data(), bits.data(), (n + 7) / 8);
+            return Bitmap(SharedBuffer<uint64_t>(std::move(packed)), n);
+        }
+
+        // Values stored as T, borrowed when aligned and free of nulls (NA
+        // slots must hold T{}, which Arrow does not promise).
+        template<typename T>
+        SharedBuffer<T> values(size_t n, const Bitmap& validity, size_t nullCount) {
+            std::string_view bytes = buffer();
+            if (bytes.size() / sizeof(T) < n) corruptArrow();
+            if (nullCount == 0 && reinterpret_cast<uintptr_t>(bytes.data()) % alignof(T) == 0) {
+                return SharedBuffer<T>::borrow(reinterpret_cast<const T*>(bytes.data()), n, reader.file);
+            }
+            std::vector<T> out(n);
+            if (n > 0) std::memcpy(out.data(), bytes.data(), n * sizeof(T));
+            if (nullCount > 0) {
+                for (size_t i = 0; i < n; ++i) {
+                    if (!validity.get(i)) out[i] = T{};
+                }
+            }
+            return SharedBuffer<T>(std::move(out));
+        }
+
+        template<typename T>
+        ColumnData numbers(size_t n, Bitmap valid, size_t nullCount) {
+            SharedBuffer<T> data = values<T>(n, valid, nullCount);
+            return Column<T>(std::move(data), std::move(valid));
+        }
+
+        // Values stored as In and converted to Out, which must hold every valid one.
+        template<typename Out, typename In>
+        std::vector<Out> convert(size_t n, const Bitmap& validity, const std::string& name) {
+            std::string_view bytes = buffer();
+            if (bytes.size() / sizeof(In) < n) corruptArrow();
+            std::vector<Out> out(n);
+            for (size_t i = 0; i < n; ++i) {
+                if (!validity.get(i)) continue;
+                In value;
+                std::memcpy(&value, bytes.data() + i * sizeof(In), sizeof(In));
+                if constexpr (std::is_integral_v<Out>) {
+                    if ((std::is_signed_v<In> && static_cast<int64_t>(value) < std::numeric_limits<Out>::min()) ||
+                        (value > 0 && static_cast<uint64_t>(value) > static_cast<uint64_t>(std::numeric_limits<Out>::max()))) {
+                        throw std::runtime_error("Arrow column '" + name + "' has a value out of range for its column type.");
+                    }
+                }
+                out[i] = static_cast<Out>(value);
+            }
+            return out;
+        }
+
+        template<typename Out>
+        std::vector<Out> integers(int bitWidth, bool isSigned, size_t n, const Bitmap& validity, const std::string& name) {
+            switch (bitWidth) {
+                case 8: return isSigned ? convert<Out, int8_t>(n, validity, name) : convert<Out, uint8_t>(n, validity, name);
+                case 16: return isSigned ? convert<Out, int16_t>(n, validity, name) : convert<Out, uint16_t>(n, validity, name);
+                case 32: return isSigned ? convert<Out, int32_t>(n, validity, name) : convert<Out, uint32_t>(n, validity, name);
+                default: return isSigned ? convert<Out, int64_t>(n, validity, name) : convert<Out, uint64_t>(n, validity, name);
+            }
+        }
+
+        // Times stored as counts of In units of nanosPerUnit nanoseconds.
+        template<typename In>
+        std::vector<Timestamp> times(size_t n, const Bitmap& validity, int64_t nanosPerUnit, const std::string& name) {
+            std::vector<int64_t> counts = convert<int64_t, In>(n, validity, name);
+            std::vector<Timestamp> out(n);
+            for (size_t i = 0; i < n; ++i) {
+                if (!validity.get(i)) continue;
+                if (counts[i] > std::numeric_limits<int64_t>::max() / nanosPerUnit ||
+                    counts[i] < std::numeric_limits<int64_t>::min() / nanosPerUnit) {
+                    throw std::runtime_error("Arrow column '" + name + "' has a time out of range for TimestampColumn.");
+                }
+                out[i] = Timestamp(counts[i] * nanosPerUnit);
+            }
+            return out;
+        }
+
+        StringColumn strings(ArrowType type, size_t n, Bitmap validity) {
+            using offset_type = StringColumn::offset_type;
+            SharedBuffer<offset_type> offsets;
+            if (type == ArrowType::LargeUtf8 || type == ArrowType::LargeBinary) {
+                offsets = values<offset_type>(n + 1, Bitmap(n + 1, true), 0);
+                for (size_t i = 0; i < n; ++i) {
+                    if (offsets[i + 1] < offsets[i]) corruptArrow();
+                }
+            } else {
+                std::string_view bytes = buffer();
+                if (bytes.size() / sizeof(int32_t) < n + 1) corruptArrow();
+                std::vector<offset_type> wide(n + 1);
+                for (size_t i = 0; i <= n; ++i) {
+                    int32_t offset;
+                    std::memcpy(&offset, bytes.data() + i * sizeof(offset), sizeof(offset));
+                    wide[i] = offset;
+                    if (i > 0 && wide[i] < wide[i - 1]) corruptArrow();
+                }
+                offsets = SharedBuffer<offset_type>(std::move(wide));
+            }
+            std::string_view chars = buffer();
+            if (offsets[0] < 0 || static_cast<uint64_t>(offsets[n]) > chars.size()) corruptArrow();
+            return StringColumn(std::move(offsets), SharedBuffer<char>::borrow(chars.data(), chars.size(), reader.file),
+                                std::move(validity));
+        }
+
+        ColumnData column(const ArrowField& field) {
+            ArrowFieldNode info = node();
+            const size_t n = static_cast<size_t>(info.length);
+            const size_t nullCount = static_cast<size_t>(info.nullCount);
+            if (field.type == ArrowType::Null) {
+                return DoubleColumn(SharedBuffer<double>(std::vector<double>(n)), Bitmap(n, false));
+            }
+            Bitmap valid = validity(n, nullCount);
+
+            if (field.dictionary) {
+                auto it = reader.dictionaries.find(field.dictionaryId);
+                if (it == reader.dictionaries.end()) corruptArrow();
+                SharedBuffer<CategoricalColumn::code_type> codes;
+                if (field.indexBitWidth == 32 && field.indexSigned) {
+                    codes = values<CategoricalColumn::code_type>(n, valid, nullCount);
+                } else {
+                    codes = SharedBuffer<CategoricalColumn::code_type>(integers<CategoricalColumn::code_type>(
+                        field.indexBitWidth, field.indexSigned, n, valid, field.name));
+                }
+                const auto numCategories = static_cast<CategoricalColumn::code_type>(it->second->size());
+                for (size_t i = 0; i < n; ++i) {
+                    if ((codes[i] < 0 || codes[i] >= numCategories) && valid.get(i)) corruptArrow();
+                }
+                return CategoricalColumn(std::move(codes), std::move(valid), it->second);
+            }
+
+            switch (field.type) {
+                case ArrowType::Int:
+                    switch (field.bitWidth) {
+                        case 8: return field.isSigned ? numbers<int8_t>(n, std::move(valid), nullCount)
+                                                      : numbers<uint8_t>(n, std::move(valid), nullCount);
+                        case 16: return field.isSigned ? numbers<int16_t>(n, std::move(valid), nullCount)
+                                                       : numbers<uint16_t>(n, std::move(valid), nullCount);
+                        case 32: return field.isSigned ? numbers<int>(n, std::move(valid), nullCount)
+                                                       : numbers<uint32_t>(n, std::move(valid), nullCount);
+                        default: return field.isSigned ? numbers<int64_t>(n, std::move(valid), nullCount)
+                                                       : numbers<uint64_t>(n, std::move(valid), nullCount);
+                    }
+                case ArrowType::FloatingPoint:
+                    return field.precision == ArrowPrecision::Double ? numbers<double>(n, std::move(valid), nullCount)
+                                                                     : numbers<float>(n, std::move(valid), nullCount);
+                case ArrowType::Bool: {
+                    std::string_view bits = buffer();
+                    if (bits.size() < (n + 7) / 8) corruptArrow();
+                    std::vector<BoolColumn::storage_type> flags(n);
+                    for (size_t i = 0; i < n; ++i) {
+                        flags[i] = valid.get(i) && ((static_cast<unsigned char>(bits[i >> 3]) >> (i & 7)) & 1);
+                    }
+                    return BoolColumn(SharedBuffer<BoolColumn::storage_type>(std::move(flags)), std::move(valid));
+                }
+                case ArrowType::Date: {
+                    std::vector<Timestamp> dates = field.unit == 0
+                        ? times<int32_t>(n, valid, 86400LL * 1000000000, field.name)
+                        : times<int64_t>(n, valid, 1000000, field.name);
+                    return TimestampColumn(SharedBuffer<Timestamp>(std::move(dates)), std::move(valid));
+                }
+                case ArrowType::Timestamp: {
+                    static constexpr int64_t nanosPerUnit[] = {1000000000, 1000000, 1000, 1};
+                    SharedBuffer<Timestamp> stamps =
+                        field.unit == static_cast<int16_t>(ArrowTimeUnit::Nanosecond)
+                            ? values<Timestamp>(n, valid, nullCount)
+                            : SharedBuffer<Timestamp>(times<int64_t>(n, valid, nanosPerUnit[field.unit], field.name));
+                    return TimestampColumn(std::move(stamps), std::move(valid));
+                }
+                default:
+                    return strings(field.type, n, std::move(valid));
+            }
+        }
+
+        // The index column's labels, appended to ints or labels.
+        void indexLabels(const ArrowField& field, std::vector<int64_t>& ints, std::vector<std::string>& labels) {
+            ArrowFieldNode info = node();
+            const size_t n = static_cast<size_t>(info.length);
+            Bitmap valid = validity(n, static_cast<size_t>(info.nullCount));
+            if (field.type == ArrowType::Int) {
+                std::vector<int64_t> values = integers<int64_t>(field.bitWidth, field.isSigned, n, valid, field.name);
+                ints.insert(ints.end(), values.begin(), values.end());
+            } else {
+                StringColumn strings = this->strings(field.type, n, std::move(valid));
+                for (size_t i = 0; i < n; ++i) labels.emplace_back(strings.value(i));
+            }
+        }
+    };
+
+    void readDictionaryBatch(const Message& message) {
+        const int64_t id = message.header.scalar<int64_t>(0);
+        if (message.header.scalar<uint8_t>(2) != 0) {
+            throw std::runtime_error("Arrow delta dictionaries are not supported.");
+        }
+        const ArrowField* field = nullptr;
+        for (const auto& f : fields) {
+            if (f.dictionary && f.dictionaryId == id) field = &f;
+        }
+        if (!field) corruptArrow();
+        Batch batch(*this, message.header.table(1), message.body);
+        ArrowFieldNode info = batch.node();
+        const size_t n = static_cast<size_t>(info.length);
+        Bitmap valid = batch.validity(n, static_cast<size_t>(info.nullCount));
+        if (info.nullCount != 0) {
+            throw std::runtime_error("Arrow dictionary of column '" + field->name + "' has null categories.");
+        }
+        dictionaries[id] = std::make_shared<CategoryDictionary>(batch.strings(field->type, n, std::move(valid)));
+    }
+
+    void readRecordBatch(const Message& message) {
+        Batch batch(*this, message.header, message.body);
+        std::vector<ColumnData> columns;
+        for (size_t i = 0; i < fields.size(); ++i) {
+            if (static_cast<int>(i) == indexField) {
+                batch.indexLabels(fields[i], intLabels, stringLabels);
+                continue;
+            }
+            columns.push_back(batch.column(fields[i]));
+        }
+        parts.push_back(std::move(columns));
+    }
+
+    ColumnData emptyColumn(const ArrowField& field) const {
+        if (field.dictionary) {
+            auto it = dictionaries.find(field.dictionaryId);
+            return CategoricalColumn(SharedBuffer<CategoricalColumn::code_type>(), Bitmap(),
+                                     it == dictionaries.end() ? nullptr : it->second);
+        }
+        switch (field.type) {
+            case ArrowType::Int:
+                switch (field.bitWidth) {
+                    case 8: return field.isSigned ? ColumnData(Int8Column()) : ColumnData(UInt8Column());
+                    case 16: return field.isSigned ? ColumnData(Int16Column()) : ColumnData(UInt16Column());
+                    case 32: return field.isSigned ? ColumnData(IntColumn()) : ColumnData(UInt32Column());
+                    default: return field.isSigned ? ColumnData(Int64Column()) : ColumnData(UInt64Column());
+                }
+            case ArrowType::Bool: return BoolColumn();
+            case ArrowType::Date:
+            case ArrowType::Timestamp: return TimestampColumn();
+            case ArrowType::FloatingPoint:
+                if (field.precision == ArrowPrecision::Single) return FloatColumn();
+                return DoubleColumn();
+            case ArrowType::Null: return DoubleColumn();
+            default: return StringColumn();
+        }
+    }
+
+    void dispatch(const Message& message) {
+        switch (message.type) {
+            case ArrowHeader::Schema:
+                readSchema(message.header);
+                break;
+            case ArrowHeader::DictionaryBatch:
+                readDictionaryBatch(message);
+                break;
+            case ArrowHeader::RecordBatch:
+                readRecordBatch(message);
+                break;
+            default:
+                throw std::runtime_error("Unsupported Arrow IPC message.");
+        }
+    }
+
+public:
+    ArrowReader(const std::string& filename, bool memoryMap)
+        : file(std::make_shared<const MappedFile>(filename, memoryMap)), data(file->view()) {}
+
+    void read() {
+        const size_t trailer = sizeof(int32_t) + sizeof(arrowMagic);
+        const bool fileFormat = data.size() >= 8 + trailer && std::memcmp(data.data(), arrowMagic, sizeof(arrowMagic)) == 0;
+        if (!fileFormat) {
+            size_t pos = 0;
+            Message message;
+            bool first = true;
+            while (readMessage(pos, message)) {
+                if (first != (message.type == ArrowHeader::Schema)) corruptArrow();
+                first = false;
+                dispatch(message);
+            }
+            if (first) throw std::runtime_error("Not an Arrow IPC file or stream.");
+            return;
+        }
+
+        if (std::memcmp(data.data() + data.size() - sizeof(arrowMagic), arrowMagic, sizeof(arrowMagic)) != 0) {
+            corruptArrow();
+        }
+        int32_t footerSize;
+        std::memcpy(&footerSize, data.data() + data.size() - trailer, sizeof(footerSize));
+        if (footerSize <= 0 || static_cast<size_t>(footerSize) > data.size() - 8 - trailer) corruptArrow();
+        FlatTable footer = FlatTable::root(data.substr(data.size() - trailer - static_cast<size_t>(footerSize),
+                                                       static_cast<size_t>(footerSize)));
+        readSchema(footer.table(1));
+
+        auto readBlocks = [&](uint16_t id) {
+            size_t start = 0;
+            size_t count = footer.vector(id, sizeof(ArrowBlock), start);
+            for (size_t i = 0; i < count; ++i) {
+                ArrowBlock block = footer.structAt<ArrowBlock>(start, i);
+                if (block.offset < 8 || static_cast<uint64_t>(block.offset) >= data.size()) corruptArrow();
+                size_t pos = static_cast<size_t>(block.offset);
+                Message message;
+                if (!readMessage(pos, message)) corruptArrow();
+                dispatch(message);
+            }
+        };
+        readBlocks(2);
+        readBlocks(3);
+    }
+
+    DataFrame frame() {
+        DataFrame df;
+        size_t column = 0;
+        for (size_t i = 0; i < fields.size(); ++i) {
+            if (static_cast<int>(i) == indexField) continue;
+            ColumnData result;
+            if (parts.empty()) {
+                result = emptyColumn(fields[i]);
+            } else {
+                result = std::move(parts[0][column]);
+                for (size_t b = 1; b < parts.size(); ++b) {
+                    visitDecodedInPlace([&](auto& col) {
+                        col.append(std::get<std::decay_t<decltype(col)>>(parts[b][column]));
+                    }, result);
+                }
+            }
+            df.addColumn(fields[i].name, result);
+            ++column;
+        }
+        if (df.numColumns() > 0 && indexField >= 0) {
+            if (fields[indexField].type == ArrowType::Int) df.setIndex(Index(Int64Index(std::move(intLabels))));
+            else df.setIndex(Index(StringIndex(std::move(stringLabels))));
+        }
+        return df;
+    }
+};
+
+} // namespace detail
+
+namespace io {
+
+void writeArrow(const DataFrame& df, const std::string& filename, ArrowFormat format) {
+    if (!detail::littleEndian()) {
+        throw std::runtime_error("Arrow IPC files are only supported on little-endian hosts.");
+    }
+    const size_t rows = df.numRows();
+    std::vector<detail::ArrowField> fields;
+    std::vector<const CategoricalColumn*> categoricals;
+    detail::ArrowBody body;
+    // The body points into the columns; encoded ones are written from
+    // decoded copies, kept here.
+    std::vector<ColumnData> decoded;
+    decoded.reserve(df.numColumns());
+
+    for (const auto& [name, column] : df.getColumns()) {
+        const auto* encoded = std::get_if<EncodedColumn>(&column);
+        const ColumnData& data = encoded ? decoded.emplace_back(encoded->decode()) : column;
+        detail::ArrowField field;
+        field.name = name;
+        visitDecoded([&](const auto& col) {
+            using Col = std::decay_t<decltype(col)>;
+            const size_t n = col.size();
+            const size_t nulls = n - col.validity().count();
+            body.nodes.push_back({static_cast<int64_t>(n), static_cast<int64_t>(nulls)});
+            body.addValidity(col.validity(), nulls);
+            if constexpr (isIntegerColumn<Col>) {
+                using T = typename Col::element_type;
+                field.type = detail::ArrowType::Int;
+                field.bitWidth = static_cast<int>(sizeof(T) * 8);
+                field.isSigned = std::is_signed_v<T>;
+                body.add(col.data(), n * sizeof(T));
+            } else if constexpr (isFloatColumn<Col>) {
+                using T = typename Col::element_type;
+                field.type = detail::ArrowType::FloatingPoint;
+                field.precision = std::is_same_v<T, float> ? detail::ArrowPrecision::Single : detail::ArrowPrecision::Double;
+                body.add(col.data(), n * sizeof(T));
+            } else if constexpr (std::is_same_v<Col, BoolColumn>) {
+                field.type = detail::ArrowType::Bool;
+                std::string bits((n + 7) / 8, '\0');
+                const auto* flags = col.data();
+                for (size_t i = 0; i < n; ++i) {
+                    if (flags[i]) bits[i >> 3] = static_cast<char>(bits[i >> 3] | (1 << (i & 7)));
+                }
+                body.add(std::move(bits));
+            } else if constexpr (std::is_same_v<Col, StringColumn>) {
+                field.type = detail::ArrowType::LargeUtf8;
+                body.addStrings(col);
+            } else if constexpr (std::is_same_v<Col, TimestampColumn>) {
+                field.type = detail::ArrowType::Timestamp;
+                field.unit = static_cast<int16_t>(detail::ArrowTimeUnit::Nanosecond);
+                body.add(col.data(), n * sizeof(Timestamp));
+            } else {
+                field.type = detail::ArrowType::LargeUtf8;
+                field.dictionary = true;
+                field.dictionaryId = static_cast<int64_t>(categoricals.size());
+                categoricals.push_back(&col);
+                body.add(col.codeData(), n * sizeof(CategoricalColumn::code_type));
+            }
+        }, data);
+        fields.push_back(std::move(field));
+    }
+
+    const Index& index = df.getIndex();
+    const RangeIndex* range = index.asRange();
+    StringColumn stringLabels;
+    if (df.numColumns() > 0 && !(range && range->getStart() == 0 && range->getStep() == 1)) {
+        detail::ArrowField field;
+        field.name = detail::arrowIndexColumn;
+        body.nodes.push_back({static_cast<int64_t>(rows), 0});
+        body.add(nullptr, 0);
+        if (const StringIndex* labels = index.asStrings()) {
+            field.type = detail::ArrowType::LargeUtf8;
+            stringLabels.reserve(rows);
+            for (size_t i = 0; i < rows; ++i) stringLabels.push_back(labels->at(i));
+            body.addStrings(stringLabels);
+        } else {
+            field.type = detail::ArrowType::Int;
+            field.bitWidth = 64;
+            if (const Int64Index* ints = index.asInt64()) {
+                body.add(ints->data(), rows * sizeof(int64_t));
+            } else {
+                std::string labels(rows * sizeof(int64_t), '\0');
+                for (size_t i = 0; i < rows; ++i) {
+                    int64_t label = range->getStart() + range->getStep() * static_cast<int64_t>(i);
+                    std::memcpy(&labels[i * sizeof(label)], &label, sizeof(label));
+                }
+                body.add(std::move(labels));
+            }
+        }
+        fields.push_back(std::move(field));
+    }
+
+    detail::ArrowWriter out(filename);
+    const bool fileFormat = format == ArrowFormat::File;
+    if (fileFormat) out.writeMagic();
+    out.message(detail::ArrowHeader::Schema,
+                [&](detail::FlatBuilder& fb) { return detail::writeSchemaTable(fb, fields); }, nullptr);
+
+    std::vector<detail::ArrowBlock> dictionaryBlocks;
+    for (size_t id = 0; id < categoricals.size(); ++id) {
+        const StringColumn& categories = categoricals[id]->dictionary().categories();
+        detail::ArrowBody dictionary;
+        dictionary.nodes.push_back({static_cast<int64_t>(categories.size()), 0});
+        dictionary.add(nullptr, 0);
+        dictionary.addStrings(categories);
+        dictionaryBlocks.push_back(out.message(detail::ArrowHeader::DictionaryBatch, [&](detail::FlatBuilder& fb) {
+            return fb.table({
+                detail::FlatBuilder::scalar<int64_t>(0, static_cast<int64_t>(id)),
+                detail::FlatBuilder::reference(1, [&](detail::FlatBuilder& b) {
+                    return detail::writeRecordBatchTable(b, categories.size(), dictionary);
+                }),
+            });
+        }, &dictionary));
+    }
+
+    std::vector<detail::ArrowBlock> batchBlocks;
+    batchBlocks.push_back(out.message(detail::ArrowHeader::RecordBatch, [&](detail::FlatBuilder& fb) {
+        return detail::writeRecordBatchTable(fb, rows, body);
+    }, &body));
+    out.endOfStream();
+    if (fileFormat) out.footer(fields, dictionaryBlocks, batchBlocks);
+    out.finish();
+}
+
+DataFrame readArrow(const std::string& filename, bool memoryMap) {
+    if (!detail::littleEndian()) {
+        throw std::runtime_error("Arrow IPC files are only supported on little-endian hosts.");
+    }
+    detail::ArrowReader reader(filename, memoryMap);
+    reader.read();
+    return reader.frame();
+}
+
+} // namespace io
+} // namespace df
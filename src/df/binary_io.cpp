@@ -0,0 +1,365 @@
+#include "df/io.hpp"
+#include "df/dataframe.hpp"
+#include "df/index.hpp"
+#include "df/csv_reader.hpp"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace df {
+
+namespace detail {
+
+// File layout (little-endian):
+//
+//   "DFRAME01"
+//   buffers, each starting on a 64-byte boundary
+//   footer
+//   u64 footer size, "DFRAME01"
+//
+// The footer holds the row and column counts, then per column its name, its
+// DataType and the (offset, size) of each of its buffers, then the index.
+// Validity bitmaps are packed u64 words; string offsets are i64 and start at
+// zero; categorical columns store their categories as string buffers;
+// timestamps are i64 nanoseconds since the epoch; numbers are stored at
+// their own width.
+constexpr char binaryMagic[8] = {'D', 'F', 'R', 'A', 'M', 'E', '0', '1'};
+constexpr size_t binaryAlignment = 64;
+
+template<typename Col>
+constexpr DataType binaryTypeOf() {
+    if constexpr (std::is_same_v<Col, IntColumn>) return DataType::Integer;
+    else if constexpr (std::is_same_v<Col, DoubleColumn>) return DataType::Double;
+    else if constexpr (std::is_same_v<Col, BoolColumn>) return DataType::Boolean;
+    else if constexpr (std::is_same_v<Col, StringColumn>) return DataType::String;
+    else if constexpr (std::is_same_v<Col, CategoricalColumn>) return DataType::Categorical;
+    else if constexpr (std::is_same_v<Col, TimestampColumn>) return DataType::Timestamp;
+    else if constexpr (std::is_same_v<Col, Int8Column>) return DataType::Int8;
+    else if constexpr (std::is_same_v<Col, Int16Column>) return DataType::Int16;
+    else if constexpr (std::is_same_v<Col, Int64Column>) return DataType::Int64;
+    else if constexpr (std::is_same_v<Col, UInt8Column>) return DataType::UInt8;
+    else if constexpr (std::is_same_v<Col, UInt16Column>) return DataType::UInt16;
+    else if constexpr (std::is_same_v<Col, UInt32Column>) return DataType::UInt32;
+    else if constexpr (std::is_same_v<Col, UInt64Column>) return DataType::UInt64;
+    else return DataType::Float;
+}
+
+enum class BinaryIndexKind : uint8_t { Range, Int64, String };
+
+struct BufferRef {
+    uint64_t offset;
+    uint64_t size;
+};
+
+static bool littleEndian() {
+    const uint16_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+class BinaryWriter {
+private:
+    std::ofstream file;
+    uint64_t pos = 0;
+    std::string footer;
+
+public:
+    explicit BinaryWriter(const std::string& filename) : file(filename, std::ios::binary) {
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file for writing: " + filename);
+        }
+        write(binaryMagic, sizeof(binaryMagic));
+    }
+
+    void write(const void* data, size_t size) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        pos += size;
+    }
+
+    BufferRef buffer(const void* data, size_t size) {
+        static const char zeros[binaryAlignment] = {};
+        write(zeros, (binaryAlignment - pos % binaryAlignment) % binaryAlignment);
+        BufferRef ref{pos, size};
+        write(data, size);
+        return ref;
+    }
+
+    template<typename T>
+    void put(T value) { footer.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+    void put(const std::string& s) {
+        put<uint64_t>(s.size());
+        footer += s;
+    }
+    void put(const BufferRef& ref) {
+        put<uint64_t>(ref.offset);
+        put<uint64_t>(ref.size);
+    }
+
+    template<typename T>
+    void putBuffer(const T* data, size_t count) { put(buffer(data, count * sizeof(T))); }
+
+    void putBitmap(const Bitmap& bitmap) {
+        std::vector<uint64_t> words(bitmap.numWords());
+        for (size_t k = 0; k < words.size(); ++k) words[k] = bitmap.wordAt(k);
+        putBuffer(words.data(), words.size());
+    }
+
+    void putStrings(const StringColumn& strings) {
+        const StringColumn::offset_type* offsets = strings.offsetData();
+        const size_t n = strings.size();
+        if (offsets[0] == 0) {
+            putBuffer(offsets, n + 1);
+        } else {
+            std::vector<StringColumn::offset_type> rebased(n + 1);
+            for (size_t i = 0; i <= n; ++i) rebased[i] = offsets[i] - offsets[0];
+            putBuffer(rebased.data(), rebased.size());
+        }
+        putBuffer(strings.charData() + offsets[0], strings.numBytes());
+    }
+
+    void finish(const std::string& filename) {
+        write(footer.data(), footer.size());
+        uint64_t footerSize = footer.size();
+        write(&footerSize, sizeof(footerSize));
+        write(binaryMagic, sizeof(binaryMagic));
+        file.flush();
+        if (!file) {
+            throw std::runtime_error("Failed to write file: " + filename);
+        }
+    }
+};
+
+// Reads the footer of a mapped file and hands out its buffers in place.
+class BinaryReader {
+private:
+    std::shared_ptr<const MappedFile> file;
+    std::string_view data;
+    size_t cursor = 0;
+    size_t end = 0;
+
+    [[noreturn]] static void corrupt() { throw std::runtime_error("Corrupt binary DataFrame file."); }
+
+public:
+    BinaryReader(const std::string& filename, bool memoryMap)
+        : file(std::make_shared<const MappedFile>(filename, memoryMap)), data(file->view()) {
+        const size_t trailer = sizeof(uint64_t) + sizeof(binaryMagic);
+        if (data.size() < sizeof(binaryMagic) + trailer ||
+            std::memcmp(data.data(), binaryMagic, sizeof(binaryMagic)) != 0 ||
+            std::memcmp(data.data() + data.size() - sizeof(binaryMagic), binaryMagic, sizeof(binaryMagic)) != 0) {
+            throw std::runtime_error("Not a binary DataFrame file: " + filename);
+        }
+        uint64_t footerSize;
+        std::memcpy(&footerSize, data.data() + data.size() - trailer, sizeof(footerSize));
+        if (footerSize > data.size() - sizeof(binaryMagic) - trailer) corrupt();
+        end = data.size() - trailer;
+        cursor = end - footerSize;
+    }
+
+    template<typename T>
+    T get() {
+        if (end - cursor < sizeof(T)) corrupt();
+        T value;
+        std::memcpy(&value, data.data() + cursor, sizeof(T));
+        cursor += sizeof(T);
+        return value;
+    }
+
+    std::string getString() {
+        uint64_t size = get<uint64_t>();
+        if (end - cursor < size) corrupt();
+        std::string s(data.data() + cursor, size);
+        cursor += size;
+        return s;
+    }
+
+    // The next buffer in the footer, which must hold count values of T.
+    template<typename T>
+    SharedBuffer<T> getBuffer(size_t count) {
+        BufferRef ref{get<uint64_t>(), get<uint64_t>()};
+        if (ref.size != count * sizeof(T) || ref.offset > data.size() || data.size() - ref.offset < ref.size ||
+            (reinterpret_cast<uintptr_t>(data.data()) + ref.offset) % alignof(T) != 0) {
+            corrupt();
+        }
+        return SharedBuffer<T>::borrow(reinterpret_cast<const T*>(data.data() + ref.offset), count, file);
+    }
+
+    // A buffer of T whose size is only known from the file.
+    template<typename T>
+    SharedBuffer<T> getBuffer() {
+        size_t save = cursor;
+        get<uint64_t>();
+        uint64_t size = get<uint64_t>();
+        cursor = save;
+        if (size % sizeof(T) != 0) corrupt();
+        return getBuffer<T>(size / sizeof(T));
+    }
+
+    Bitmap getBitmap(size_t bits) { return Bitmap(getBuffer<uint64_t>((bits + 63) / 64), bits); }
+
+    StringColumn getStrings(size_t n, Bitmap validity) {
+        SharedBuffer<StringColumn::offset_type> offsets = getBuffer<StringColumn::offset_type>(n + 1);
+        SharedBuffer<char> chars = getBuffer<char>();
+        if (offsets[0] < 0 || static_cast<size_t>(offsets[n]) > chars.size()) corrupt();
+        for (size_t i = 0; i < n; ++i) {
+            if (offsets[i + 1] < offsets[i]) corrupt();
+        }
+        return StringColumn(std::move(offsets), std::move(chars), std::move(validity));
+    }
+};
+
+} // namespace detail
+
+namespace io {
+
+void save(const DataFrame& df, const std::string& filename) {
+    if (!detail::littleEndian()) {
+        throw std::runtime_error("Binary DataFrame files are only supported on little-endian hosts.");
+    }
+    detail::BinaryWriter out(filename);
+    const size_t rows = df.numRows();
+    out.put<uint64_t>(rows);
+    out.put<uint64_t>(df.numColumns());
+
+    for (const auto& [name, data] : df.getColumns()) {
+        out.put(name);
+        // Encoded columns are stored decoded.
+        visitDecoded([&](const auto& col) {
+            using Col = std::decay_t<decltype(col)>;
+            out.put(static_cast<uint8_t>(detail::binaryTypeOf<Col>()));
+
+            out.putBitmap(col.validity());
+            if constexpr (std::is_same_v<Col, StringColumn>) {
+                out.putStrings(col);
+            } else if constexpr (std::is_same_v<Col, CategoricalColumn>) {
+                out.putBuffer(col.codeData(), col.size());
+                const StringColumn& categories = col.dictionary().categories();
+                out.put<uint64_t>(categories.size());
+                out.putStrings(categories);
+            } else {
+                out.putBuffer(col.data(), col.size());
+            }
+        }, data);
+    }
+
+    const Index& index = df.getIndex();
+    if (const RangeIndex* range = index.asRange()) {
+        out.put(detail::BinaryIndexKind::Range);
+        out.put<int64_t>(range->getStart());
+        out.put<int64_t>(range->getStep());
+    } else if (const Int64Index* ints = index.asInt64()) {
+        out.put(detail::BinaryIndexKind::Int64);
+        out.putBuffer(ints->data(), ints->size());
+    } else {
+        const StringIndex& labels = *index.asStrings();
+        StringColumn strings;
+        strings.reserve(labels.size());
+        for (size_t i = 0; i < labels.size(); ++i) strings.push_back(labels.at(i));
+        out.put(detail::BinaryIndexKind::String);
+        out.putStrings(strings);
+    }
+    out.finish(filename);
+}
+
+DataFrame load(const std::string& filename, bool memoryMap) {
+    if (!detail::littleEndian()) {
+        throw std::runtime_error("Binary DataFrame files are only supported on little-endian hosts.");
+    }
+    detail::BinaryReader in(filename, memoryMap);
+    const size_t rows = in.get<uint64_t>();
+    const size_t numColumns = in.get<uint64_t>();
+
+    DataFrame df;
+    for (size_t c = 0; c < numColumns; ++c) {
+        std::string name = in.getString();
+        auto type = static_cast<DataType>(in.get<uint8_t>());
+        Bitmap validity = in.getBitmap(rows);
+        switch (type) {
+            case DataType::Integer:
+                df.addColumn(name, IntColumn(in.getBuffer<int>(rows), std::move(validity)));
+                break;
+            case DataType::Double:
+                df.addColumn(name, DoubleColumn(in.getBuffer<double>(rows), std::move(validity)));
+                break;
+            case DataType::Boolean:
+                df.addColumn(name, BoolColumn(in.getBuffer<BoolColumn::storage_type>(rows), std::move(validity)));
+                break;
+            case DataType::String:
+                df.addColumn(name, in.getStrings(rows, std::move(validity)));
+                break;
+            case DataType::Timestamp:
+                df.addColumn(name, TimestampColumn(in.getBuffer<Timestamp>(rows), std::move(validity)));
+                break;
+            case DataType::Int8:
+                df.addColumn(name, Int8Column(in.getBuffer<int8_t>(rows), std::move(validity)));
+                break;
+            case DataType::Int16:
+                df.addColumn(name, Int16Column(in.getBuffer<int16_t>(rows), std::move(validity)));
+                break;
+            case DataType::Int64:
+                df.addColumn(name, Int64Column(in.getBuffer<int64_t>(rows), std::move(validity)));
+                break;
+            case DataType::UInt8:
+                df.addColumn(name, UInt8Column(in.getBuffer<uint8_t>(rows), std::move(validity)));
+                break;
+            case DataType::UInt16:
+                df.addColumn(name, UInt16Column(in.getBuffer<uint16_t>(rows), std::move(validity)));
+                break;
+            case DataType::UInt32:
+                df.addColumn(name, UInt32Column(in.getBuffer<uint32_t>(rows), std::move(validity)));
+                break;
+            case DataType::UInt64:
+                df.addColumn(name, UInt64Column(in.getBuffer<uint64_t>(rows), std::move(validity)));
+                break;
+            case DataType::Float:
+                df.addColumn(name, FloatColumn(in.getBuffer<float>(rows), std::move(validity)));
+                break;
+            case DataType::Categorical: {
+                auto codes = in.getBuffer<CategoricalColumn::code_type>(rows);
+                size_t numCategories = in.get<uint64_t>();
+                auto dictionary = std::make_shared<CategoryDictionary>(
+                    in.getStrings(numCategories, Bitmap(numCategories, true)));
+                for (size_t i = 0; i < rows; ++i) {
+                    if ((codes[i] < 0 || static_cast<size_t>(codes[i]) >= numCategories) && validity.get(i)) {
+                        throw std::runtime_error("Corrupt binary DataFrame file.");
+                    }
+                }
+                df.addColumn(name, CategoricalColumn(std::move(codes), std::move(validity), std::move(dictionary)));
+                break;
+            }
+            default:
+                throw std::runtime_error("Corrupt binary DataFrame file.");
+        }
+    }
+
+    std::optional<Index> index;
+    switch (in.get<detail::BinaryIndexKind>()) {
+        case detail::BinaryIndexKind::Range: {
+            long long start = in.get<int64_t>();
+            long long step = in.get<int64_t>();
+            index = Index(RangeIndex(start, start + step * static_cast<long long>(rows), step));
+            break;
+        }
+        case detail::BinaryIndexKind::Int64: {
+            auto values = in.getBuffer<int64_t>(rows);
+            index = Index(Int64Index(std::vector<int64_t>(values.data(), values.data() + rows)));
+            break;
+        }
+        case detail::BinaryIndexKind::String: {
+            StringColumn strings = in.getStrings(rows, Bitmap(rows, true));
+            std::vector<std::string> labels;
+            labels.reserve(rows);
+            for (size_t i = 0; i < rows; ++i) labels.emplace_back(strings.value(i));
+            index = Index(StringIndex(std::move(labels)));
+            break;
+        }
+        default:
+            throw std::runtime_error("Corrupt binary DataFrame file.");
+    }
+    if (numColumns > 0) df.setIndex(*index);
+    return df;
+}
+
+} // namespace io
+} // namespace df
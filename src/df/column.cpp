@@ -0,0 +1,260 @@
+#include "df/column.hpp"
+#include <algorithm>
+
+namespace df {
+
+StringColumn::StringColumn(size_t n) : offsets(std::vector<offset_type>(n + 1, 0)), valid(n, false) {}
+
+StringColumn::StringColumn(size_t n, const Nullable<std::string>& fill) {
+    reserve(n);
+    if (!fill.isNA()) reserveBytes(n * fill.valueUnsafe().size());
+    for (size_t i = 0; i < n; ++i) push_back(fill);
+}
+
+StringColumn::StringColumn(std::initializer_list<Nullable<std::string>> init) {
+    reserve(init.size());
+    for (const auto& v : init) push_back(v);
+}
+
+StringColumn::StringColumn(SharedBuffer<offset_type> offsetBuffer, SharedBuffer<char> charBuffer, Bitmap validity)
+    : offsets(std::move(offsetBuffer)), chars(std::move(charBuffer)), valid(std::move(validity)) {
+    if (offsets.size() != valid.size() + 1) {
+        throw std::invalid_argument("Offset buffer and validity bitmap size mismatch.");
+    }
+    if (offsets[0] < 0 || offsets[valid.size()] < offsets[0] ||
+        static_cast<size_t>(offsets[valid.size()]) > chars.size()) {
+        throw std::invalid_argument("String offsets out of range.");
+    }
+}
+
+void StringColumn::resize(size_t n) {
+    compact();
+    if (n < size()) {
+        chars.mutate().resize(static_cast<size_t>(offsets[n]));
+        offsets.mutate().resize(n + 1);
+        valid.resize(n);
+        return;
+    }
+    offsets.mutate().resize(n + 1, static_cast<offset_type>(chars.size()));
+    valid.resize(n, false);
+}
+
+void StringColumn::splice(size_t i, std::string_view v) {
+    compact();
+    const size_t begin = static_cast<size_t>(offsets[i]);
+    const size_t oldLen = static_cast<size_t>(offsets[i + 1] - offsets[i]);
+    const offset_type delta = static_cast<offset_type>(v.size()) - static_cast<offset_type>(oldLen);
+
+    auto& bytes = chars.mutate();
+    if (v.size() <= oldLen) {
+        std::copy(v.begin(), v.end(), bytes.begin() + begin);
+        bytes.erase(bytes.begin() + begin + v.size(), bytes.begin() + begin + oldLen);
+    } else {
+        std::copy(v.begin(), v.begin() + oldLen, bytes.begin() + begin);
+        bytes.insert(bytes.begin() + begin + oldLen, v.begin() + oldLen, v.end());
+    }
+    if (delta != 0) {
+        auto& offs = offsets.mutate();
+        for (size_t k = i + 1; k < offs.size(); ++k) offs[k] += delta;
+    }
+}
+
+void StringColumn::append(const StringColumn& other) {
+    // The copy shares the buffers, so the writes below detach this column
+    // instead of growing the vectors being read.
+    if (&other == this) {
+        StringColumn source(other);
+        append(source);
+        return;
+    }
+    compact();
+    const size_t n = other.size();
+    const offset_type first = other.offsets[0];
+    const offset_type base = static_cast<offset_type>(chars.size()) - first;
+    const char* src = other.chars.data();
+    auto& bytes = chars.mutate();
+    bytes.insert(bytes.end(), src + first, src + other.offsets[n]);
+    auto& offs = offsets.mutate();
+    offs.reserve(offs.size() + n);
+    for (size_t i = 1; i <= n; ++i) offs.push_back(base + other.offsets[i]);
+    valid.append(other.valid);
+}
+
+StringColumn StringColumn::slice(size_t start, size_t end) const {
+    StringColumn result;
+    result.offsets = offsets.slice(start, end - start + 1);
+    result.chars = chars;
+    result.valid = valid.slice(start, end - start);
+    return result;
+}
+
+// Gives a sliced or adopted column its own character buffer holding only its
+// rows, with offsets rebased to zero, so that writes don't copy the parent's
+// bytes and appends can rely on chars ending at the last offset.
+void StringColumn::compact() {
+    const size_t n = size();
+    if (!offsets.isView() && offsets[0] == 0 && static_cast<size_t>(offsets[n]) == chars.size()) return;
+    const offset_type base = offsets[0];
+    std::vector<offset_type> rebased(n + 1);
+    for (size_t i = 0; i <= n; ++i) rebased[i] = offsets[i] - base;
+    chars = SharedBuffer<char>(std::vector<char>(chars.data() + base, chars.data() + offsets[n]));
+    offsets = SharedBuffer<offset_type>(std::move(rebased));
+}
+
+StringColumn StringColumn::take(const std::vector<size_t>& positions) const {
+    StringColumn result;
+    result.reserve(positions.size());
+    size_t totalBytes = 0;
+    for (size_t pos : positions) totalBytes += static_cast<size_t>(offsets[pos + 1] - offsets[pos]);
+    result.reserveBytes(totalBytes);
+    for (size_t pos : positions) {
+        if (valid.get(pos)) result.push_back(value(pos));
+        else result.pushNA();
+    }
+    return result;
+}
+
+CategoryDictionary::CategoryDictionary(StringColumn categories) : values(std::move(categories)) {
+    lookup.reserve(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (!lookup.emplace(values.value(i), static_cast<int32_t>(i)).second) {
+            throw std::invalid_argument("Duplicate category in dictionary.");
+        }
+    }
+}
+
+void CategoryDictionary::reindex() {
+    lookup.clear();
+    for (size_t i = 0; i < values.size(); ++i) lookup.emplace(values.value(i), static_cast<int32_t>(i));
+}
+
+int32_t CategoryDictionary::find(std::string_view v) const {
+    auto it = lookup.find(v);
+    return it == lookup.end() ? -1 : it->second;
+}
+
+int32_t CategoryDictionary::insert(std::string_view v) {
+    auto it = lookup.find(v);
+    if (it != lookup.end()) return it->second;
+    auto code = static_cast<int32_t>(values.size());
+    const char* bytes = values.empty() ? nullptr : values.value(0).data();
+    values.push_back(v);
+    if (bytes && values.value(0).data() != bytes) reindex();
+    else lookup.emplace(values.value(code), code);
+    return code;
+}
+
+std::vector<int32_t> CategoryDictionary::ranks() const {
+    std::vector<int32_t> order(values.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int32_t>(i);
+    std::sort(order.begin(), order.end(),
+              [this](int32_t a, int32_t b) { return values.value(a) < values.value(b); });
+    std::vector<int32_t> rank(order.size());
+    for (size_t r = 0; r < order.size(); ++r) rank[order[r]] = static_cast<int32_t>(r);
+    return rank;
+}
+
+CategoricalColumn::CategoricalColumn() : dict(std::make_shared<CategoryDictionary>()) {}
+
+CategoricalColumn::CategoricalColumn(size_t n)
+    : codes(std::vector<code_type>(n, 0)), valid(n, false), dict(std::make_shared<CategoryDictionary>()) {}
+
+CategoricalColumn::CategoricalColumn(std::initializer_list<Nullable<std::string>> init)
+    : dict(std::make_shared<CategoryDictionary>()) {
+    reserve(init.size());
+    for (const auto& v : init) push_back(v);
+}
+
+CategoricalColumn::CategoricalColumn(std::vector<code_type> codeData, Bitmap validity,
+                                     std::shared_ptr<CategoryDictionary> dictionary)
+    : codes(std::move(codeData)), valid(std::move(validity)), dict(std::move(dictionary)) {
+    if (codes.size() != valid.size()) {
+        throw std::invalid_argument("Code buffer and validity bitmap size mismatch.");
+    }
+    if (!dict) dict = std::make_shared<CategoryDictionary>();
+}
+
+CategoricalColumn::CategoricalColumn(SharedBuffer<code_type> codeData, Bitmap validity,
+                                     std::shared_ptr<CategoryDictionary> dictionary)
+    : codes(std::move(codeData)), valid(std::move(validity)), dict(std::move(dictionary)) {
+    if (codes.size() != valid.size()) {
+        throw std::invalid_argument("Code buffer and validity bitmap size mismatch.");
+    }
+    if (!dict) dict = std::make_shared<CategoryDictionary>();
+}
+
+CategoricalColumn::CategoricalColumn(const StringColumn& strings)
+    : dict(std::make_shared<CategoryDictionary>()) {
+    reserve(strings.size());
+    for (size_t i = 0; i < strings.size(); ++i) {
+        if (strings.isNA(i)) pushNA();
+        else push_back(strings.value(i));
+    }
+}
+
+CategoryDictionary& CategoricalColumn::mutableDictionary() {
+    if (dict.use_count() > 1) dict = std::make_shared<CategoryDictionary>(*dict);
+    return *dict;
+}
+
+CategoricalColumn::code_type CategoricalColumn::codeFor(std::string_view v) {
+    code_type code = dict->find(v);
+    return code >= 0 ? code : mutableDictionary().insert(v);
+}
+
+void CategoricalColumn::append(const CategoricalColumn& other) {
+    if (&other == this) {
+        CategoricalColumn source(other);
+        append(source);
+        return;
+    }
+    if (other.dict == dict) {
+        const code_type* src = other.codes.data();
+        const size_t n = other.size();
+        auto& dst = codes.mutate();
+        dst.insert(dst.end(), src, src + n);
+        valid.append(other.valid);
+        return;
+    }
+    std::vector<code_type> remap(other.dict->size());
+    for (size_t c = 0; c < remap.size(); ++c) {
+        remap[c] = codeFor(other.dict->at(static_cast<code_type>(c)));
+    }
+    reserve(size() + other.size());
+    for (size_t i = 0; i < other.size(); ++i) {
+        if (other.isNA(i)) pushNA();
+        else pushCode(remap[other.codes[i]]);
+    }
+}
+
+CategoricalColumn CategoricalColumn::slice(size_t start, size_t end) const {
+    CategoricalColumn result;
+    result.codes = codes.slice(start, end - start);
+    result.valid = valid.slice(start, end - start);
+    result.dict = dict;
+    return result;
+}
+
+CategoricalColumn CategoricalColumn::take(const std::vector<size_t>& positions) const {
+    std::vector<code_type> taken;
+    Bitmap takenValid;
+    taken.reserve(positions.size());
+    takenValid.reserve(positions.size());
+    for (size_t pos : positions) {
+        taken.push_back(codes[pos]);
+        takenValid.push_back(valid.get(pos));
+    }
+    return CategoricalColumn(std::move(taken), std::move(takenValid), dict);
+}
+
+StringColumn CategoricalColumn::toStrings() const {
+    StringColumn result;
+    result.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+        if (isNA(i)) result.pushNA();
+        else result.push_back(value(i));
+    }
+    return result;
+}
+
+} // namespace df
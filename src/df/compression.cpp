@@ -0,0 +1,290 @@
+#include "df/compression.hpp"
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include <zlib.h>
+#ifdef DF_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace df {
+namespace detail {
+
+// Compressed bytes are read and written this many at a time.
+constexpr size_t compressedBlockBytes = 1 << 18;
+
+static bool hasExtension(const std::string& filename, std::string_view extension) {
+    return filename.size() >= extension.size() &&
+           std::string_view(filename).substr(filename.size() - extension.size()) == extension;
+}
+
+#ifndef DF_HAVE_ZSTD
+[[noreturn]] static void noZstd() {
+    throw std::runtime_error("zstd-compressed files need a build with DF_HAVE_ZSTD.");
+}
+#endif
+
+io::Compression resolveCompression(const std::string& filename, io::Compression compression, bool reading) {
+    if (compression != io::Compression::Infer) return compression;
+    if (hasExtension(filename, ".gz") || hasExtension(filename, ".gzip")) return io::Compression::Gzip;
+    if (hasExtension(filename, ".zst") || hasExtension(filename, ".zstd")) return io::Compression::Zstd;
+    if (reading) {
+        std::ifstream file(filename, std::ios::binary);
+        unsigned char magic[4] = {};
+        file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+        const auto n = static_cast<size_t>(file.gcount());
+        if (n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) return io::Compression::Gzip;
+        if (n == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+            return io::Compression::Zstd;
+        }
+    }
+    return io::Compression::None;
+}
+
+struct InputStream::State {
+    std::string filename;
+    std::ifstream file;
+    io::Compression compression;
+    std::vector<char> input;
+    size_t inputPos = 0;
+    size_t inputEnd = 0;
+    bool inFrame = false; // whether a compressed frame has begun but not ended
+    z_stream zlib{};
+#ifdef DF_HAVE_ZSTD
+    ZSTD_DStream* zstd = nullptr;
+#endif
+
+    size_t readFile(char* out, size_t n) {
+        file.read(out, static_cast<std::streamsize>(n));
+        if (file.bad()) throw std::runtime_error("Failed to read file: " + filename);
+        return static_cast<size_t>(file.gcount());
+    }
+
+    // Refills the compressed input once used up; false at the end of the file.
+    bool fill() {
+        if (inputPos < inputEnd) return true;
+        inputPos = 0;
+        inputEnd = readFile(input.data(), input.size());
+        return inputEnd > 0;
+    }
+
+    [[noreturn]] void corrupt() const {
+        throw std::runtime_error("Corrupt or truncated compressed file: " + filename);
+    }
+
+    size_t inflateGzip(char* out, size_t n) {
+        size_t produced = 0;
+        while (produced < n && fill()) {
+            zlib.next_in = reinterpret_cast<Bytef*>(input.data() + inputPos);
+            zlib.avail_in = static_cast<uInt>(inputEnd - inputPos);
+            zlib.next_out = reinterpret_cast<Bytef*>(out + produced);
+            zlib.avail_out = static_cast<uInt>(std::min<size_t>(n - produced, std::numeric_limits<uInt>::max()));
+            const uInt before = zlib.avail_out;
+            int rc = inflate(&zlib, Z_NO_FLUSH);
+            produced += before - zlib.avail_out;
+            inputPos = inputEnd - zlib.avail_in;
+            inFrame = true;
+            if (rc == Z_STREAM_END) {
+                // Concatenated gzip members decompress to their concatenation.
+                inflateReset(&zlib);
+                inFrame = false;
+            } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+                corrupt();
+            }
+        }
+        if (produced < n && inFrame) corrupt();
+        return produced;
+    }
+
+    size_t inflateZstd(char* out, size_t n) {
+#ifdef DF_HAVE_ZSTD
+        size_t produced = 0;
+        while (produced < n && fill()) {
+            ZSTD_inBuffer in{input.data(), inputEnd, inputPos};
+            ZSTD_outBuffer dst{out, n, produced};
+            size_t rc = ZSTD_decompressStream(zstd, &dst, &in);
+            if (ZSTD_isError(rc)) corrupt();
+            produced = dst.pos;
+            inputPos = in.pos;
+            inFrame = rc != 0;
+        }
+        if (produced < n && inFrame) corrupt();
+        return produced;
+#else
+        (void)out;
+        (void)n;
+        noZstd();
+#endif
+    }
+};
+
+InputStream::InputStream(const std::string& filename, io::Compression compression) : state(std::make_unique<State>()) {
+    state->filename = filename;
+    state->compression = resolveCompression(filename, compression, true);
+    state->file.open(filename, std::ios::binary);
+    if (!state->file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    switch (state->compression) {
+        case io::Compression::Gzip:
+            // 15 + 32: the largest window, with a gzip or zlib header
+            if (inflateInit2(&state->zlib, 15 + 32) != Z_OK) {
+                throw std::runtime_error("Failed to start gzip decompression.");
+            }
+            state->input.resize(compressedBlockBytes);
+            break;
+        case io::Compression::Zstd:
+#ifdef DF_HAVE_ZSTD
+            state->zstd = ZSTD_createDStream();
+            if (!state->zstd || ZSTD_isError(ZSTD_initDStream(state->zstd))) {
+                throw std::runtime_error("Failed to start zstd decompression.");
+            }
+            state->input.resize(compressedBlockBytes);
+            break;
+#else
+            noZstd();
+#endif
+        default:
+            break;
+    }
+}
+
+InputStream::~InputStream() {
+    if (state->compression == io::Compression::Gzip) inflateEnd(&state->zlib);
+#ifdef DF_HAVE_ZSTD
+    if (state->zstd) ZSTD_freeDStream(state->zstd);
+#endif
+}
+
+size_t InputStream::read(char* out, size_t n) {
+    switch (state->compression) {
+        case io::Compression::Gzip: return state->inflateGzip(out, n);
+        case io::Compression::Zstd: return state->inflateZstd(out, n);
+        default: return state->readFile(out, n);
+    }
+}
+
+struct OutputStream::State {
+    std::string filename;
+    std::ofstream file;
+    io::Compression compression;
+    std::vector<char> output;
+    z_stream zlib{};
+    bool zlibStarted = false;
+#ifdef DF_HAVE_ZSTD
+    ZSTD_CStream* zstd = nullptr;
+#endif
+
+    void writeFile(const char* data, size_t n) { file.write(data, static_cast<std::streamsize>(n)); }
+
+    // Feeds n bytes to deflate, or with flush Z_FINISH ends the stream.
+    void deflateGzip(const char* data, size_t n, int flush) {
+        zlib.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        zlib.avail_in = static_cast<uInt>(n);
+        int rc;
+        do {
+            zlib.next_out = reinterpret_cast<Bytef*>(output.data());
+            zlib.avail_out = static_cast<uInt>(output.size());
+            rc = deflate(&zlib, flush);
+            if (rc == Z_STREAM_ERROR) throw std::runtime_error("gzip compression failed.");
+            writeFile(output.data(), output.size() - zlib.avail_out);
+        } while (zlib.avail_out == 0 || (flush == Z_FINISH && rc != Z_STREAM_END));
+    }
+
+#ifdef DF_HAVE_ZSTD
+    void deflateZstd(const char* data, size_t n, bool end) {
+        ZSTD_inBuffer in{data, n, 0};
+        size_t remaining;
+        do {
+            ZSTD_outBuffer dst{output.data(), output.size(), 0};
+            remaining = end ? ZSTD_endStream(zstd, &dst) : ZSTD_compressStream(zstd, &dst, &in);
+            if (ZSTD_isError(remaining)) throw std::runtime_error("zstd compression failed.");
+            writeFile(output.data(), dst.pos);
+        } while (end ? remaining != 0 : in.pos < in.size);
+    }
+#endif
+};
+
+OutputStream::OutputStream(const std::string& filename, io::Compression compression, std::optional<int> level)
+    : state(std::make_unique<State>()) {
+    state->filename = filename;
+    state->compression = resolveCompression(filename, compression, false);
+    if (state->compression == io::Compression::Zstd) {
+#ifndef DF_HAVE_ZSTD
+        noZstd();
+#endif
+    }
+    state->file.open(filename, std::ios::binary);
+    if (!state->file.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + filename);
+    }
+    switch (state->compression) {
+        case io::Compression::Gzip:
+            if (level && (*level < 0 || *level > 9)) {
+                throw std::invalid_argument("gzip compression level must be between 0 and 9.");
+            }
+            // 15 + 16: the largest window, with a gzip header
+            if (deflateInit2(&state->zlib, level.value_or(Z_DEFAULT_COMPRESSION), Z_DEFLATED, 15 + 16, 8,
+                             Z_DEFAULT_STRATEGY) != Z_OK) {
+                throw std::runtime_error("Failed to start gzip compression.");
+            }
+            state->zlibStarted = true;
+            state->output.resize(compressedBlockBytes);
+            break;
+        case io::Compression::Zstd:
+#ifdef DF_HAVE_ZSTD
+            state->zstd = ZSTD_createCStream();
+            if (!state->zstd || ZSTD_isError(ZSTD_initCStream(state->zstd, level.value_or(0)))) {
+                throw std::runtime_error("Failed to start zstd compression.");
+            }
+            state->output.resize(compressedBlockBytes);
+#endif
+            break;
+        default:
+            break;
+    }
+}
+
+OutputStream::~OutputStream() {
+    if (state->zlibStarted) deflateEnd(&state->zlib);
+#ifdef DF_HAVE_ZSTD
+    if (state->zstd) ZSTD_freeCStream(state->zstd);
+#endif
+}
+
+void OutputStream::write(const char* data, size_t n) {
+    switch (state->compression) {
+        case io::Compression::Gzip:
+            // deflate takes at most a uInt of input at a time
+            for (size_t done = 0; done < n;) {
+                size_t part = std::min<size_t>(n - done, std::numeric_limits<uInt>::max());
+                state->deflateGzip(data + done, part, Z_NO_FLUSH);
+                done += part;
+            }
+            break;
+#ifdef DF_HAVE_ZSTD
+        case io::Compression::Zstd:
+            state->deflateZstd(data, n, false);
+            break;
+#endif
+        default:
+            state->writeFile(data, n);
+            break;
+    }
+}
+
+void OutputStream::finish() {
+    if (state->compression == io::Compression::Gzip) state->deflateGzip(nullptr, 0, Z_FINISH);
+#ifdef DF_HAVE_ZSTD
+    if (state->compression == io::Compression::Zstd) state->deflateZstd(nullptr, 0, true);
+#endif
+    state->file.flush();
+    if (!state->file) {
+        throw std::runtime_error("Failed to write file: " + state->filename);
+    }
+}
+
+} // namespace detail
+} // namespace df
@@ -0,0 +1,485 @@
+#include "df/csv_reader.hpp"
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <glob.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DF_HAVE_MMAP 1
+#define DF_HAVE_GLOB 1
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define DF_HAVE_X86_SIMD 1
+#endif
+
+namespace df {
+namespace detail {
+
+namespace {
+
+BlockMasks scanBlockScalar(const char* data, size_t len, char delimiter, char quotechar) {
+    BlockMasks masks{0, 0, 0};
+    for (size_t i = 0; i < len; ++i) {
+        uint64_t bit = uint64_t(1) << i;
+        if (data[i] == quotechar) masks.quotes |= bit;
+        else if (data[i] == delimiter) masks.delimiters |= bit;
+        else if (data[i] == '\n') masks.newlines |= bit;
+    }
+    return masks;
+}
+
+#ifdef DF_HAVE_X86_SIMD
+
+BlockMasks scanBlockSSE2(const char* data, char delimiter, char quotechar) {
+    const __m128i q = _mm_set1_epi8(quotechar);
+    const __m128i d = _mm_set1_epi8(delimiter);
+    const __m128i nl = _mm_set1_epi8('\n');
+    BlockMasks masks{0, 0, 0};
+    for (int k = 0; k < 4; ++k) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * k));
+        int shift = 16 * k;
+        masks.quotes |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, q)))) << shift;
+        masks.delimiters |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, d)))) << shift;
+        masks.newlines |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)))) << shift;
+    }
+    return masks;
+}
+
+__attribute__((target("avx2")))
+BlockMasks scanBlockAVX2(const char* data, char delimiter, char quotechar) {
+    const __m256i q = _mm256_set1_epi8(quotechar);
+    const __m256i d = _mm256_set1_epi8(delimiter);
+    const __m256i nl = _mm256_set1_epi8('\n');
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+    BlockMasks masks;
+    masks.quotes = uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, q)))) |
+                   uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, q)))) << 32;
+    masks.delimiters = uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, d)))) |
+                       uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, d)))) << 32;
+    masks.newlines = uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, nl)))) |
+                     uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, nl)))) << 32;
+    return masks;
+}
+
+BlockMasks scanFullBlockScalar(const char* data, char delimiter, char quotechar) {
+    return scanBlockScalar(data, 64, delimiter, quotechar);
+}
+
+using FullBlockScanner = BlockMasks (*)(const char*, char, char);
+
+bool hasAVX2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+FullBlockScanner pickFullBlockScanner() {
+    return hasAVX2() ? scanBlockAVX2 : scanBlockSSE2;
+}
+
+// Read by every scanning thread; useBlockScanner() may swap it meanwhile.
+std::atomic<FullBlockScanner> scanFullBlock{pickFullBlockScanner()};
+
+#endif
+
+// Bit i of the result is the XOR of bits 0..i of x.
+uint64_t prefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// Bits [lo, hi) of a word, for lo <= hi <= 64.
+uint64_t bitRange(size_t lo, size_t hi) {
+    if (lo >= hi) return 0;
+    uint64_t below = hi >= 64 ? ~uint64_t(0) : (uint64_t(1) << hi) - 1;
+    return below & (~uint64_t(0) << lo);
+}
+
+} // namespace
+
+BlockMasks scanBlock(const char* data, size_t len, char delimiter, char quotechar) {
+#ifdef DF_HAVE_X86_SIMD
+    if (len == 64) return scanFullBlock.load(std::memory_order_relaxed)(data, delimiter, quotechar);
+#endif
+    return scanBlockScalar(data, len, delimiter, quotechar);
+}
+
+bool useBlockScanner(BlockScanner scanner) {
+#ifdef DF_HAVE_X86_SIMD
+    switch (scanner) {
+        case BlockScanner::Auto: scanFullBlock.store(pickFullBlockScanner()); return true;
+        case BlockScanner::Scalar: scanFullBlock.store(scanFullBlockScalar); return true;
+        case BlockScanner::SSE2: scanFullBlock.store(scanBlockSSE2); return true;
+        case BlockScanner::AVX2:
+            if (!hasAVX2()) return false;
+            scanFullBlock.store(scanBlockAVX2);
+            return true;
+    }
+    return false;
+#else
+    return scanner == BlockScanner::Auto || scanner == BlockScanner::Scalar;
+#endif
+}
+
+MappedFile::MappedFile(const std::string& filename, bool memoryMap) {
+#ifdef DF_HAVE_MMAP
+    if (memoryMap) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open file: " + filename);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+            length = static_cast<size_t>(st.st_size);
+            if (length == 0) {
+                ::close(fd);
+                return;
+            }
+            void* addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                ::madvise(addr, length, MADV_SEQUENTIAL);
+                mapped = static_cast<const char*>(addr);
+                ::close(fd);
+                return;
+            }
+        }
+        length = 0;
+        ::close(fd);
+    }
+#else
+    (void)memoryMap;
+#endif
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    buffer = contents.str();
+}
+
+MappedFile::~MappedFile() {
+#ifdef DF_HAVE_MMAP
+    if (mapped) ::munmap(const_cast<char*>(mapped), length);
+#endif
+}
+
+CSVTokenizer::CSVTokenizer(std::string_view input, char delimiter, char quotechar)
+    : input(input), delimiter(delimiter), quotechar(quotechar) {}
+
+void CSVTokenizer::rewind() {
+    pos = 0;
+    blockBase = scanned = 0;
+    structural = quoteCarry = 0;
+    quoteBits = breakBits = prevQuoteBits = 0;
+    lastQuote = lastBreak = npos;
+}
+
+void CSVTokenizer::project(const std::vector<size_t>& columns) {
+    size_t width = 0;
+    for (size_t column : columns) width = std::max(width, column + 1);
+    slots.assign(width, noSlot);
+    for (size_t i = 0; i < columns.size(); ++i) slots[columns[i]] = i;
+    numSlots = columns.size();
+    projected = true;
+}
+
+// Scans the next block; false once the input is exhausted.
+bool CSVTokenizer::loadBlock() {
+    if (scanned >= input.size()) return false;
+    size_t len = std::min<size_t>(64, input.size() - scanned);
+    BlockMasks masks = scanBlock(input.data() + scanned, len, delimiter, quotechar);
+    uint64_t quoted = prefixXor(masks.quotes) ^ quoteCarry;
+    quoteCarry = static_cast<uint64_t>(static_cast<int64_t>(quoted) >> 63);
+    structural = (masks.delimiters | masks.newlines) & ~quoted;
+    if (quoteBits) lastQuote = blockBase + 63 - static_cast<size_t>(__builtin_clzll(quoteBits));
+    if (breakBits) lastBreak = blockBase + 63 - static_cast<size_t>(__builtin_clzll(breakBits));
+    prevQuoteBits = quoteBits;
+    quoteBits = masks.quotes;
+    breakBits = masks.newlines;
+    blockBase = scanned;
+    scanned += len;
+    return true;
+}
+
+// Whether a byte in [begin, end) is marked, given the marks of the current
+// block and the last mark before it. end is at most one past the current
+// block; a field ending before the block ends on a '\r' or a structural
+// byte, which are not marked, so no later mark can sit between it and the
+// block.
+bool CSVTokenizer::marked(uint64_t bits, size_t last, size_t begin, size_t end) const {
+    if (begin >= end) return false;
+    if (begin < blockBase && last != npos && last >= begin && last < end) return true;
+    if (end <= blockBase) return false;
+    return (bits & bitRange(begin > blockBase ? begin - blockBase : 0, end - blockBase)) != 0;
+}
+
+std::string_view CSVTokenizer::field(size_t begin, size_t end) {
+    const char* data = input.data();
+    if (begin >= blockBase) {
+        // The usual case: a field within the current block.
+        if (!(quoteBits & bitRange(begin - blockBase, end - blockBase))) {
+            return std::string_view(data + begin, end - begin);
+        }
+    } else if (!marked(quoteBits, lastQuote, begin, end)) {
+        return std::string_view(data + begin, end - begin);
+    }
+
+    // A field wholly wrapped in one pair of quotes is the text between them,
+    // unless a line break inside may need a '\r' dropped.
+    const bool hasBreak = marked(breakBits, lastBreak, begin, end);
+    if (end - begin >= 2 && data[begin] == quotechar && data[end - 1] == quotechar && !hasBreak &&
+        !std::memchr(data + begin + 1, quotechar, end - begin - 2)) {
+        return std::string_view(data + begin + 1, end - begin - 2);
+    }
+    return unescape(begin, end, hasBreak);
+}
+
+// Decodes a field with quotes into the decoded blocks; decoding never makes
+// it longer. A field within this block and the one before is copied a run at
+// a time between the quotes the masks mark, which avoids branching on every
+// byte; others, and those where a "\r\n" inside quotes loses its '\r', go
+// byte by byte.
+std::string_view CSVTokenizer::unescape(size_t begin, size_t end, bool hasBreak) {
+    constexpr size_t blockBytes = 64 * 1024;
+    if (decodedLeft < end - begin) {
+        decodedLeft = std::max(blockBytes, end - begin);
+        decoded.push_back(std::make_unique<char[]>(decodedLeft));
+        decodedNext = decoded.back().get();
+    }
+    char* const first = decodedNext;
+    char* w = first;
+    const char* data = input.data();
+    const bool dropsCR = hasBreak && std::memchr(data + begin, '\r', end - begin);
+    bool inQuotes = false;
+
+    if (!dropsCR && begin + 64 >= blockBase) {
+        const size_t prevBase = blockBase - 64;
+        uint64_t words[2] = {0, 0};
+        if (begin < blockBase) {
+            words[0] = prevQuoteBits & bitRange(begin - prevBase, std::min<size_t>(end - prevBase, 64));
+        }
+        if (end > blockBase) {
+            words[1] = quoteBits & bitRange(begin > blockBase ? begin - blockBase : 0, end - blockBase);
+        }
+        size_t i = begin;
+        bool skip = false;
+        for (int k = 0; k < 2; ++k) {
+            const size_t base = k == 0 ? prevBase : blockBase;
+            for (uint64_t bits = words[k]; bits; bits &= bits - 1) {
+                if (skip) {
+                    skip = false;
+                    continue;
+                }
+                const size_t q = base + static_cast<size_t>(__builtin_ctzll(bits));
+                std::memcpy(w, data + i, q - i);
+                w += q - i;
+                if (inQuotes && q + 1 < end && data[q + 1] == quotechar) {
+                    *w++ = quotechar;
+                    skip = true;
+                    i = q + 2;
+                } else {
+                    inQuotes = !inQuotes;
+                    i = q + 1;
+                }
+            }
+        }
+        std::memcpy(w, data + i, end - i);
+        w += end - i;
+    } else {
+        for (size_t i = begin; i < end; ++i) {
+            char c = data[i];
+            if (c == quotechar) {
+                if (inQuotes && i + 1 < end && data[i + 1] == quotechar) {
+                    *w++ = quotechar;
+                    ++i;
+                } else {
+                    inQuotes = !inQuotes;
+                }
+            } else if (!(dropsCR && inQuotes && c == '\r' && i + 1 < end && data[i + 1] == '\n')) {
+                *w++ = c;
+            }
+        }
+    }
+    const size_t length = static_cast<size_t>(w - first);
+    decodedNext += length;
+    decodedLeft -= length;
+    return std::string_view(first, length);
+}
+
+void CSVTokenizer::emit(std::vector<std::string_view>& fields, size_t column, size_t begin, size_t end) {
+    if (!projected) {
+        fields.push_back(field(begin, end));
+    } else if (column < slots.size() && slots[column] != noSlot) {
+        fields[slots[column]] = field(begin, end);
+    }
+}
+
+bool CSVTokenizer::next(std::vector<std::string_view>& fields) {
+    const size_t n = input.size();
+    if (pos >= n) {
+        fields.clear();
+        return false;
+    }
+    if (projected) fields.assign(numSlots, std::string_view());
+    else fields.clear();
+
+    const char* data = input.data();
+    size_t begin = pos;
+    size_t column = 0;
+    while (structural != 0 || loadBlock()) {
+        if (structural == 0) continue;
+        const size_t offset = static_cast<size_t>(__builtin_ctzll(structural));
+        structural &= structural - 1;
+        const size_t p = blockBase + offset;
+        if (!((breakBits >> offset) & 1)) {
+            emit(fields, column++, begin, p);
+            begin = p + 1;
+        } else {
+            size_t end = (p > begin && data[p - 1] == '\r') ? p - 1 : p;
+            emit(fields, column, begin, end);
+            pos = p + 1;
+            return true;
+        }
+    }
+
+    size_t end = (n > begin && data[n - 1] == '\r') ? n - 1 : n;
+    emit(fields, column, begin, end);
+    pos = n;
+    return true;
+}
+
+void parallelFor(size_t n, const std::function<void(size_t)>& fn) {
+    std::vector<std::exception_ptr> errors(n);
+    auto run = [&](size_t i) {
+        try {
+            fn(i);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(n > 0 ? n - 1 : 0);
+    for (size_t i = 1; i < n; ++i) workers.emplace_back(run, i);
+    if (n > 0) run(0);
+    for (auto& worker : workers) worker.join();
+
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+void parallelTasks(size_t n, size_t workers, const std::function<void(size_t)>& fn) {
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    parallelFor(std::min(workers, n), [&](size_t) {
+        for (size_t i; !failed && (i = next++) < n;) {
+            try {
+                fn(i);
+            } catch (...) {
+                failed = true;
+                throw;
+            }
+        }
+    });
+}
+
+std::vector<std::string> globFiles(const std::string& pattern) {
+    std::vector<std::string> paths;
+#ifdef DF_HAVE_GLOB
+    glob_t matches;
+    int rc = ::glob(pattern.c_str(), 0, nullptr, &matches);
+    if (rc == 0) {
+        for (size_t i = 0; i < matches.gl_pathc; ++i) paths.emplace_back(matches.gl_pathv[i]);
+    }
+    globfree(&matches);
+    if (rc != 0 && rc != GLOB_NOMATCH) {
+        throw std::runtime_error("Failed to expand file pattern: " + pattern);
+    }
+#else
+    std::ifstream file(pattern);
+    if (file.is_open()) paths.push_back(pattern);
+#endif
+    return paths;
+}
+
+void scanRecords(std::string_view input, size_t from, char quotechar, RecordScan& scan) {
+    const char* data = input.data();
+    uint64_t carry = scan.inQuotes ? ~uint64_t(0) : 0;
+    for (size_t p = from; p < input.size(); p += 64) {
+        size_t len = std::min<size_t>(64, input.size() - p);
+        // Only quotes and line breaks matter; the delimiter mask is unused.
+        BlockMasks masks = scanBlock(data + p, len, quotechar, quotechar);
+        uint64_t quoted = prefixXor(masks.quotes) ^ carry;
+        if (__builtin_popcountll(masks.quotes) % 2 == 1) carry = ~carry;
+        uint64_t newlines = masks.newlines & ~quoted;
+        if (newlines) {
+            scan.count += static_cast<size_t>(__builtin_popcountll(newlines));
+            scan.end = p + 64 - static_cast<size_t>(__builtin_clzll(newlines));
+        }
+    }
+    scan.inQuotes = carry != 0;
+}
+
+std::vector<size_t> splitRecords(std::string_view input, size_t parts, char quotechar, size_t workers) {
+    std::vector<size_t> bounds{0};
+    const size_t n = input.size();
+    if (parts <= 1 || n == 0) {
+        bounds.push_back(n);
+        return bounds;
+    }
+
+    const char* data = input.data();
+    const size_t step = n / parts;
+    std::vector<size_t> quotes(parts);
+    auto countQuotes = [&](size_t i) {
+        size_t end = i + 1 == parts ? n : (i + 1) * step;
+        size_t count = 0;
+        for (size_t p = i * step; p < end; p += 64) {
+            BlockMasks masks = scanBlock(data + p, std::min<size_t>(64, end - p), '\n', quotechar);
+            count += static_cast<size_t>(__builtin_popcountll(masks.quotes));
+        }
+        quotes[i] = count;
+    };
+    if (workers <= 1) {
+        for (size_t i = 0; i < parts; ++i) countQuotes(i);
+    } else {
+        parallelTasks(parts, workers, countQuotes);
+    }
+
+    // Every quote toggles the quoted state (an escaped "" toggles twice), so
+    // the parity of the quotes before a point says whether it is quoted.
+    size_t quotesBefore = 0;
+    for (size_t i = 1; i < parts; ++i) {
+        quotesBefore += quotes[i - 1];
+        bool inQuotes = quotesBefore % 2 == 1;
+        size_t p = i * step;
+        for (; p < n; ++p) {
+            if (data[p] == quotechar) inQuotes = !inQuotes;
+            else if (data[p] == '\n' && !inQuotes) break;
+        }
+        if (p + 1 < n && p + 1 > bounds.back()) bounds.push_back(p + 1);
+    }
+    bounds.push_back(n);
+    return bounds;
+}
+
+} // namespace detail
+} // namespace df
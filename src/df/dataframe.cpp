@@ -29,7 +29,7 @@ void DataFrame::addColumn(const std::string& columnName, const ColumnData& data)
 
     if (columns.empty()) {
         rowCount = newRowCount;
-        index = Index(rowCount);
+        if (index.size() != rowCount) index = Index(rowCount);
     } else if (newRowCount != rowCount) {
         throw std::invalid_argument("All columns must have the same number of rows.");
     }
@@ -105,16 +105,18 @@ DataFrame DataFrame::operator()(size_t startRow, size_t endRow) const {
     if (startRow > endRow || endRow > rowCount) {
         throw std::out_of_range("Invalid row indices.");
     }
+    // Columns and index are views over this frame's buffers, so slicing costs
+    // O(columns) regardless of the row range.
     DataFrame sliced;
+    if (!columns.empty()) {
+        sliced.index = index.slice(startRow, endRow);
+        sliced.rowCount = endRow - startRow;
+    }
     for (const auto& [colName, colData] : columns) {
         ColumnData slicedData = std::visit([startRow, endRow](const auto& vec) -> ColumnData {
-            using Vec = std::decay_t<decltype(vec)>;
-            return Vec(vec.begin() + startRow, vec.begin() + endRow);
+            return vec.slice(startRow, endRow);
         }, colData);
-        sliced.addColumn(colName, slicedData);
-    }
-    if (!sliced.columns.empty()) {
-        sliced.setIndex(index.slice(startRow, endRow).getLabels());
+        sliced.addColumn(colName, std::move(slicedData));
     }
     return sliced;
 }
@@ -128,8 +130,17 @@ DataFrame DataFrame::tail(size_t n) const {
     return this->operator()(start, rowCount);
 }
 
+DataFrame DataFrame::loc(long long first, long long last) const {
+    auto [begin, end] = index.locRange(first, last);
+    return this->operator()(begin, end);
+}
+
 DataFrame DataFrame::select(const std::vector<std::string>& columnNames) const {
     DataFrame selected;
+    if (!columnNames.empty()) {
+        selected.index = index;
+        selected.rowCount = rowCount;
+    }
     for (const auto& colName : columnNames) {
         auto it = columnIndex.find(colName);
         if (it == columnIndex.end()) {
@@ -137,34 +148,133 @@ DataFrame DataFrame::select(const std::vector<std::string>& columnNames) const {
         }
         selected.addColumn(colName, columns[it->second].second);
     }
-    if (!selected.empty()) {
-        selected.setIndex(index.getLabels());
-    }
     return selected;
 }
 
+DataFrame DataFrame::takeRows(const std::vector<size_t>& positions) const {
+    DataFrame taken;
+    for (const auto& [colName, colData] : columns) {
+        ColumnData takenData = std::visit([&positions](const auto& vec) -> ColumnData {
+            return vec.take(positions);
+        }, colData);
+        if (const auto* encoded = std::get_if<EncodedColumn>(&colData)) {
+            takenData = EncodedColumn(takenData, encoded->encoding());
+        }
+        taken.addColumn(colName, takenData);
+    }
+
+    if (!positions.empty()) {
+        taken.setIndex(index.take(positions));
+    }
+    return taken;
+}
+
 DataFrame DataFrame::filter(const std::function<bool(const ColumnStore&, size_t)>& condition) const {
     std::vector<size_t> selectedIndices;
     for (size_t i = 0; i < rowCount; ++i) {
         if (condition(columns, i)) selectedIndices.push_back(i);
     }
+    return takeRows(selectedIndices);
+}
 
-    DataFrame filtered;
-    for (const auto& [colName, colData] : columns) {
-        ColumnData filteredData = std::visit([&selectedIndices](const auto& vec) -> ColumnData {
-            using Vec = std::decay_t<decltype(vec)>;
-            Vec result;
-            result.reserve(selectedIndices.size());
-            for (size_t idx : selectedIndices) result.push_back(vec[idx]);
-            return result;
-        }, colData);
-        filtered.addColumn(colName, filteredData);
+namespace {
+
+template<typename T>
+int order(const T& a, const T& b) { return a < b ? -1 : b < a ? 1 : a == b ? 0 : 2; }
+
+// Orders a cell value against a bound: -1, 0 or 1, or 2 when they do not
+// compare. Integers compare exactly, other numbers as doubles.
+template<typename X, typename B>
+int compareTo(const X& x, const B& b) {
+    constexpr bool numberX = std::is_arithmetic_v<X> && !std::is_same_v<X, bool>;
+    constexpr bool numberB = std::is_arithmetic_v<B> && !std::is_same_v<B, bool>;
+    if constexpr (std::is_same_v<X, bool> && std::is_same_v<B, bool>) {
+        return order(x, b);
+    } else if constexpr (numberX && numberB && std::is_integral_v<X> && std::is_integral_v<B>) {
+        return order(static_cast<__int128>(x), static_cast<__int128>(b));
+    } else if constexpr (numberX && numberB) {
+        return order(static_cast<double>(x), static_cast<double>(b));
+    } else if constexpr (std::is_same_v<X, std::string_view> && std::is_same_v<B, std::string>) {
+        return order(x, std::string_view(b));
+    } else if constexpr (std::is_same_v<X, Timestamp> && std::is_same_v<B, Timestamp>) {
+        return order(x, b);
+    } else {
+        return 2;
     }
+}
 
-    if (!selectedIndices.empty()) {
-        filtered.setIndex(index.take(selectedIndices).getLabels());
+template<typename Col>
+int compareAt(const Col& col, size_t i, const Value& bound) {
+    if (col.isNA(i)) return 2;
+    return std::visit([&](const auto& b) -> int {
+        using B = std::decay_t<decltype(b)>;
+        if constexpr (std::is_same_v<B, NA>) {
+            return 2;
+        } else if constexpr (std::is_arithmetic_v<B> || std::is_same_v<B, std::string> ||
+                             std::is_same_v<B, Timestamp>) {
+            return compareTo(col.value(i), b);
+        } else {
+            return b.isNA() ? 2 : compareTo(col.value(i), b.valueUnsafe());
+        }
+    }, bound);
+}
+
+// The rows of column passing predicate, as EncodedColumn::matches reports
+// them.
+Bitmap predicateMatches(const ColumnData& column, const io::ColumnPredicate& predicate) {
+    using Op = io::ColumnPredicate::Op;
+    if (const auto* encoded = std::get_if<EncodedColumn>(&column)) return encoded->matches(predicate);
+    return visitDecoded([&](const auto& col) -> Bitmap {
+        const size_t n = col.size();
+        std::vector<uint64_t> words((n + 63) / 64, 0);
+        for (size_t i = 0; i < n; ++i) {
+            bool pass;
+            if (predicate.op == Op::IsNA || predicate.op == Op::NotNA) {
+                pass = col.isNA(i) == (predicate.op == Op::IsNA);
+            } else {
+                const int c = compareAt(col, i, predicate.value);
+                switch (predicate.op) {
+                    case Op::Equal: pass = c == 0; break;
+                    case Op::NotEqual: pass = c != 0; break;
+                    case Op::Less: pass = c == -1; break;
+                    case Op::LessEqual: pass = c == -1 || c == 0; break;
+                    case Op::Greater: pass = c == 1; break;
+                    case Op::GreaterEqual: pass = c == 0 || c == 1; break;
+                    case Op::Between: {
+                        const int u = compareAt(col, i, predicate.upper);
+                        pass = (c == 0 || c == 1) && (u == -1 || u == 0);
+                        break;
+                    }
+                    default: pass = false;
+                }
+            }
+            if (pass) words[i >> 6] |= uint64_t(1) << (i & 63);
+        }
+        return Bitmap(SharedBuffer<uint64_t>(std::move(words)), n);
+    }, column);
+}
+
+} // namespace
+
+DataFrame DataFrame::filter(const std::vector<io::ColumnPredicate>& predicates) const {
+    std::vector<uint64_t> passing((rowCount + 63) / 64, ~uint64_t(0));
+    for (const auto& predicate : predicates) {
+        auto it = columnIndex.find(predicate.column);
+        if (it == columnIndex.end()) {
+            throw std::out_of_range("Column does not exist: " + predicate.column);
+        }
+        const Bitmap matches = predicateMatches(columns[it->second].second, predicate);
+        for (size_t k = 0; k < passing.size(); ++k) passing[k] &= matches.wordAt(k);
+    }
+
+    std::vector<size_t> selectedIndices;
+    for (size_t k = 0; k < passing.size(); ++k) {
+        for (uint64_t word = passing[k]; word != 0; word &= word - 1) {
+            const size_t i = k * 64 + static_cast<size_t>(__builtin_ctzll(word));
+            if (i < rowCount) selectedIndices.push_back(i);
+        }
     }
-    return filtered;
+    return takeRows(selectedIndices);
 }
 
 void DataFrame::sort(const std::string& columnName, bool ascending) {
@@ -176,61 +286,86 @@ void DataFrame::sort(const std::string& columnName, bool ascending) {
     std::iota(indices.begin(), indices.end(), 0);
 
     const auto& sortColData = columns[columnIndex.at(columnName)].second;
-    std::visit([&](const auto& vec) {
-        std::sort(indices.begin(), indices.end(), [&](size_t i1, size_t i2) {
-            bool na1 = vec[i1].isNA();
-            bool na2 = vec[i2].isNA();
-            if (na1) return false;
-            if (na2) return true;
-            return ascending
-                ? vec[i1].valueUnsafe() < vec[i2].valueUnsafe()
-                : vec[i1].valueUnsafe() > vec[i2].valueUnsafe();
-        });
+    visitDecoded([&](const auto& vec) {
+        using Vec = std::decay_t<decltype(vec)>;
+        auto sortByKey = [&](const auto& key) {
+            std::sort(indices.begin(), indices.end(), [&](size_t i1, size_t i2) {
+                bool na1 = vec.isNA(i1);
+                bool na2 = vec.isNA(i2);
+                if (na1) return false;
+                if (na2) return true;
+                return ascending ? key(i1) < key(i2) : key(i1) > key(i2);
+            });
+        };
+        if constexpr (std::is_same_v<Vec, CategoricalColumn>) {
+            std::vector<int32_t> rank = vec.dictionary().ranks();
+            const auto* codes = vec.codeData();
+            sortByKey([&](size_t i) { return rank[codes[i]]; });
+        } else {
+            sortByKey([&](size_t i) { return vec.value(i); });
+        }
     }, sortColData);
 
-    std::vector<std::string> newLabels;
-    newLabels.reserve(rowCount);
-    for (size_t i = 0; i < rowCount; ++i) {
-        newLabels.push_back(index.at(indices[i]));
-    }
-    index = Index(newLabels);
+    index = index.take(indices);
 
     for (auto& [_, colData] : columns) {
-        std::visit([&indices, this](auto& vec) {
-            using Vec = std::decay_t<decltype(vec)>;
-            Vec sorted(rowCount);
-            for (size_t i = 0; i < rowCount; ++i) sorted[i] = vec[indices[i]];
-            vec = std::move(sorted);
+        ColumnData sorted = std::visit([&indices](const auto& vec) -> ColumnData {
+            return vec.take(indices);
         }, colData);
+        if (const auto* encoded = std::get_if<EncodedColumn>(&colData)) {
+            sorted = EncodedColumn(sorted, encoded->encoding());
+        }
+        colData = std::move(sorted);
     }
 }
 
+namespace {
+
+// The number value holds as E. Integer columns are only filled with integers
+// they can hold; floating-point ones with any number within their range.
+// Other values fill nothing rather than wrapping.
+template<typename E>
+std::optional<E> numericFill(const Value& value) {
+    return std::visit([](const auto& x) -> std::optional<E> {
+        using X = std::decay_t<decltype(x)>;
+        if constexpr (std::is_same_v<X, bool> || std::is_same_v<X, NA> || std::is_same_v<X, std::string> ||
+                      std::is_same_v<X, Timestamp>) {
+            return std::nullopt;
+        } else if constexpr (std::is_arithmetic_v<X>) {
+            if constexpr (std::is_floating_point_v<X> && !std::is_floating_point_v<E>) {
+                return std::nullopt;
+            } else if constexpr (std::is_integral_v<E>) {
+                const auto wide = static_cast<__int128>(x);
+                if (wide < std::numeric_limits<E>::min() || wide > std::numeric_limits<E>::max()) return std::nullopt;
+                return static_cast<E>(x);
+            } else {
+                const auto wide = static_cast<long double>(x);
+                if (std::isfinite(wide) && std::fabs(wide) > std::numeric_limits<E>::max()) return std::nullopt;
+                return static_cast<E>(x);
+            }
+        } else {
+            if (x.isNA()) return std::nullopt;
+            return numericFill<E>(Value(x.valueUnsafe()));
+        }
+    }, value);
+}
+
+} // namespace
+
 void DataFrame::fillna(const Value& value) {
     for (auto& [colName, colData] : columns) {
-        std::visit([&value](auto& vec) {
+        if (std::visit([](const auto& vec) { return vec.nullCount(); }, colData) == 0) continue;
+        visitDecodedInPlace([&value](auto& vec) {
             using V = typename std::decay_t<decltype(vec)>::value_type;
-
-            if constexpr (std::is_same_v<V, NullableInt>) {
-                std::optional<int> fill;
-                if (std::holds_alternative<int>(value)) fill = std::get<int>(value);
-                else if (std::holds_alternative<NullableInt>(value)) {
-                    const auto& n = std::get<NullableInt>(value);
-                    if (!n.isNA()) fill = n.valueUnsafe();
+            auto fillMissing = [&vec](const auto& fill) {
+                if (!fill) return;
+                for (size_t i = 0; i < vec.size(); ++i) {
+                    if (vec.isNA(i)) vec.set(i, *fill);
                 }
-                if (fill) for (auto& e : vec) if (e.isNA()) e = *fill;
-            }
-            else if constexpr (std::is_same_v<V, NullableDouble>) {
-                std::optional<double> fill;
-                if (std::holds_alternative<double>(value)) fill = std::get<double>(value);
-                else if (std::holds_alternative<int>(value)) fill = static_cast<double>(std::get<int>(value));
-                else if (std::holds_alternative<NullableDouble>(value)) {
-                    const auto& n = std::get<NullableDouble>(value);
-                    if (!n.isNA()) fill = n.valueUnsafe();
-                } else if (std::holds_alternative<NullableInt>(value)) {
-                    const auto& n = std::get<NullableInt>(value);
-                    if (!n.isNA()) fill = static_cast<double>(n.valueUnsafe());
-                }
-                if (fill) for (auto& e : vec) if (e.isNA()) e = *fill;
+            };
+
+            if constexpr (isNumberColumn<std::decay_t<decltype(vec)>>) {
+                fillMissing(numericFill<typename std::decay_t<decltype(vec)>::element_type>(value));
             }
             else if constexpr (std::is_same_v<V, NullableBool>) {
                 std::optional<bool> fill;
@@ -239,7 +374,7 @@ void DataFrame::fillna(const Value& value) {
                     const auto& n = std::get<NullableBool>(value);
                     if (!n.isNA()) fill = n.valueUnsafe();
                 }
-                if (fill) for (auto& e : vec) if (e.isNA()) e = *fill;
+                fillMissing(fill);
             }
             else if constexpr (std::is_same_v<V, NullableString>) {
                 std::optional<std::string> fill;
@@ -248,17 +383,68 @@ void DataFrame::fillna(const Value& value) {
                     const auto& n = std::get<NullableString>(value);
                     if (!n.isNA()) fill = n.valueUnsafe();
                 }
-                if (fill) for (auto& e : vec) if (e.isNA()) e = *fill;
+                if (!fill || vec.nullCount() == 0) return;
+                if constexpr (std::is_same_v<std::decay_t<decltype(vec)>, CategoricalColumn>) {
+                    fillMissing(fill);
+                } else {
+                    // Overwriting rows in place would shift the character buffer
+                    // once per NA, so rebuild the column in a single pass.
+                    StringColumn filled;
+                    filled.reserve(vec.size());
+                    filled.reserveBytes(vec.numBytes() + vec.nullCount() * fill->size());
+                    for (size_t i = 0; i < vec.size(); ++i) {
+                        if (vec.isNA(i)) filled.push_back(*fill);
+                        else filled.push_back(vec.value(i));
+                    }
+                    vec = std::move(filled);
+                }
             }
+            else if constexpr (std::is_same_v<V, NullableTimestamp>) {
+                std::optional<Timestamp> fill;
+                if (std::holds_alternative<Timestamp>(value)) fill = std::get<Timestamp>(value);
+                else if (std::holds_alternative<NullableTimestamp>(value)) {
+                    const auto& n = std::get<NullableTimestamp>(value);
+                    if (!n.isNA()) fill = n.valueUnsafe();
+                }
+                fillMissing(fill);
+            }
+        }, colData);
+    }
+}
+
+void DataFrame::encode(const std::string& columnName, Encoding encoding) {
+    ColumnData& column = (*this)[columnName];
+    column = EncodedColumn(column, encoding);
+}
+
+void DataFrame::encode(Encoding encoding) {
+    for (auto& [_, colData] : columns) {
+        if (std::holds_alternative<EncodedColumn>(colData) || !EncodedColumn::supports(colData)) continue;
+        EncodedColumn encoded(colData, encoding);
+        const size_t plainBytes = visitDecoded([](const auto& vec) -> size_t {
+            using Vec = std::decay_t<decltype(vec)>;
+            if constexpr (std::is_same_v<Vec, StringColumn> || std::is_same_v<Vec, CategoricalColumn>) return 0;
+            else return vec.size() * sizeof(typename Vec::storage_type) + vec.validity().numWords() * sizeof(uint64_t);
         }, colData);
+        if (encoded.encodedBytes() < plainBytes) colData = std::move(encoded);
+    }
+}
+
+void DataFrame::decode(const std::string& columnName) {
+    ColumnData& column = (*this)[columnName];
+    if (const auto* encoded = std::get_if<EncodedColumn>(&column)) column = encoded->decode();
+}
+
+void DataFrame::decode() {
+    for (auto& [_, colData] : columns) {
+        if (const auto* encoded = std::get_if<EncodedColumn>(&colData)) colData = encoded->decode();
     }
 }
 
 DataFrame DataFrame::describe() const {
     std::vector<std::string> numericColumns;
     for (const auto& [colName, colData] : columns) {
-        if (std::holds_alternative<IntColumn>(colData) ||
-            std::holds_alternative<DoubleColumn>(colData)) {
+        if (visitType([](const auto& vec) { return isNumberColumn<std::decay_t<decltype(vec)>>; }, colData)) {
             numericColumns.push_back(colName);
         }
     }
@@ -273,11 +459,13 @@ DataFrame DataFrame::describe() const {
         const auto& colData = columns[columnIndex.at(colName)].second;
 
         std::vector<double> values;
-        std::visit([&values](const auto& vec) {
+        visitDecoded([&values](const auto& vec) {
             using Vec = std::decay_t<decltype(vec)>;
-            if constexpr (std::is_same_v<Vec, IntColumn> || std::is_same_v<Vec, DoubleColumn>) {
-                for (const auto& v : vec) {
-                    if (!v.isNA()) values.push_back(static_cast<double>(v.valueUnsafe()));
+            if constexpr (isNumberColumn<Vec>) {
+                values.reserve(vec.size());
+                const auto* data = vec.data();
+                for (size_t i = 0; i < vec.size(); ++i) {
+                    if (vec.isValid(i)) values.push_back(static_cast<double>(data[i]));
                 }
             }
         }, colData);
@@ -286,9 +474,8 @@ DataFrame DataFrame::describe() const {
         if (values.empty()) {
             for (size_t i = 0; i < statNames.size(); ++i) statCol.push_back(NA_VALUE);
         } else {
-            double sum = 0.0;
-            for (double v : values) sum += v;
-            double mean = sum / values.size();
+            // As mean() reports it: integers are summed exactly.
+            double mean = std::get<double>(stats::mean(colData));
 
             double sumSq = 0.0;
             for (double v : values) sumSq += (v - mean) * (v - mean);
@@ -331,6 +518,13 @@ void DataFrame::setIndex(const std::vector<std::string>& labels) {
     index = Index(labels);
 }
 
+void DataFrame::setIndex(const Index& newIndex) {
+    if (newIndex.size() != rowCount) {
+        throw std::invalid_argument("Index size must match the number of rows");
+    }
+    index = newIndex;
+}
+
 const Index& DataFrame::getIndex() const { return index; }
 
 std::vector<std::string> DataFrame::getColumnNames() const {
@@ -354,39 +548,102 @@ Value DataFrame::count(const std::string& columnName) const  { return stats::cou
 DataFrame DataFrame::corr() const { return stats::corr(*this); }
 DataFrame DataFrame::cov() const  { return stats::cov(*this); }
 
-DataFrame DataFrame::add(const DataFrame& other, const Value& fillValue) const {
+DataFrame DataFrame::add(const DataFrame& other, const Value& fillValue) const& {
     return math::add(*this, other, fillValue);
 }
-DataFrame DataFrame::sub(const DataFrame& other, const Value& fillValue) const {
+DataFrame DataFrame::sub(const DataFrame& other, const Value& fillValue) const& {
     return math::subtract(*this, other, fillValue);
 }
-DataFrame DataFrame::mul(const DataFrame& other, const Value& fillValue) const {
+DataFrame DataFrame::mul(const DataFrame& other, const Value& fillValue) const& {
     return math::multiply(*this, other, fillValue);
 }
-DataFrame DataFrame::div(const DataFrame& other, const Value& fillValue) const {
+DataFrame DataFrame::div(const DataFrame& other, const Value& fillValue) const& {
     return math::divide(*this, other, fillValue);
 }
 
+DataFrame DataFrame::add(const DataFrame& other, const Value& fillValue) && {
+    addInPlace(other, fillValue);
+    return std::move(*this);
+}
+DataFrame DataFrame::sub(const DataFrame& other, const Value& fillValue) && {
+    subInPlace(other, fillValue);
+    return std::move(*this);
+}
+DataFrame DataFrame::mul(const DataFrame& other, const Value& fillValue) && {
+    mulInPlace(other, fillValue);
+    return std::move(*this);
+}
+DataFrame DataFrame::div(const DataFrame& other, const Value& fillValue) && {
+    divInPlace(other, fillValue);
+    return std::move(*this);
+}
+
+void DataFrame::addInPlace(const DataFrame& other, const Value& fillValue) { math::addInPlace(*this, other, fillValue); }
+void DataFrame::subInPlace(const DataFrame& other, const Value& fillValue) { math::subtractInPlace(*this, other, fillValue); }
+void DataFrame::mulInPlace(const DataFrame& other, const Value& fillValue) { math::multiplyInPlace(*this, other, fillValue); }
+void DataFrame::divInPlace(const DataFrame& other, const Value& fillValue) { math::divideInPlace(*this, other, fillValue); }
+
 template<typename T>
-DataFrame DataFrame::add(const T& scalar) const { return math::add(*this, scalar); }
+DataFrame DataFrame::add(const T& scalar) const& { return math::add(*this, scalar); }
 template<typename T>
-DataFrame DataFrame::sub(const T& scalar) const { return math::subtract(*this, scalar); }
+DataFrame DataFrame::sub(const T& scalar) const& { return math::subtract(*this, scalar); }
 template<typename T>
-DataFrame DataFrame::mul(const T& scalar) const { return math::multiply(*this, scalar); }
+DataFrame DataFrame::mul(const T& scalar) const& { return math::multiply(*this, scalar); }
 template<typename T>
-DataFrame DataFrame::div(const T& scalar) const { return math::divide(*this, scalar); }
-
-template DataFrame DataFrame::add<int>(const int& scalar) const;
-template DataFrame DataFrame::add<double>(const double& scalar) const;
-template DataFrame DataFrame::sub<int>(const int& scalar) const;
-template DataFrame DataFrame::sub<double>(const double& scalar) const;
-template DataFrame DataFrame::mul<int>(const int& scalar) const;
-template DataFrame DataFrame::mul<double>(const double& scalar) const;
-template DataFrame DataFrame::div<int>(const int& scalar) const;
-template DataFrame DataFrame::div<double>(const double& scalar) const;
+DataFrame DataFrame::div(const T& scalar) const& { return math::divide(*this, scalar); }
+template<typename T>
+DataFrame DataFrame::add(const T& scalar) && {
+    addInPlace(scalar);
+    return std::move(*this);
+}
+template<typename T>
+DataFrame DataFrame::sub(const T& scalar) && {
+    subInPlace(scalar);
+    return std::move(*this);
+}
+template<typename T>
+DataFrame DataFrame::mul(const T& scalar) && {
+    mulInPlace(scalar);
+    return std::move(*this);
+}
+template<typename T>
+DataFrame DataFrame::div(const T& scalar) && {
+    divInPlace(scalar);
+    return std::move(*this);
+}
+template<typename T>
+void DataFrame::addInPlace(const T& scalar) { math::addInPlace(*this, scalar); }
+template<typename T>
+void DataFrame::subInPlace(const T& scalar) { math::subtractInPlace(*this, scalar); }
+template<typename T>
+void DataFrame::mulInPlace(const T& scalar) { math::multiplyInPlace(*this, scalar); }
+template<typename T>
+void DataFrame::divInPlace(const T& scalar) { math::divideInPlace(*this, scalar); }
+
+#define DF_INSTANTIATE_SCALAR_OPS(T)                        \
+    template DataFrame DataFrame::add<T>(const T&) const&;  \
+    template DataFrame DataFrame::sub<T>(const T&) const&;  \
+    template DataFrame DataFrame::mul<T>(const T&) const&;  \
+    template DataFrame DataFrame::div<T>(const T&) const&;  \
+    template DataFrame DataFrame::add<T>(const T&) &&;      \
+    template DataFrame DataFrame::sub<T>(const T&) &&;      \
+    template DataFrame DataFrame::mul<T>(const T&) &&;      \
+    template DataFrame DataFrame::div<T>(const T&) &&;      \
+    template void DataFrame::addInPlace<T>(const T&);       \
+    template void DataFrame::subInPlace<T>(const T&);       \
+    template void DataFrame::mulInPlace<T>(const T&);       \
+    template void DataFrame::divInPlace<T>(const T&);
+
+DF_INSTANTIATE_SCALAR_OPS(int)
+DF_INSTANTIATE_SCALAR_OPS(double)
+DF_INSTANTIATE_SCALAR_OPS(int64_t)
+DF_INSTANTIATE_SCALAR_OPS(float)
+
+#undef DF_INSTANTIATE_SCALAR_OPS
 
 void DataFrame::display(size_t n) const {
-    size_t displayRows = std::min(n, rowCount);
+    // Encoded columns are decoded once for the rows shown, not per cell.
+    const DataFrame shown = head(n);
 
     std::cout << "\t";
     for (const auto& [colName, _] : columns) {
@@ -394,17 +651,22 @@ void DataFrame::display(size_t n) const {
     }
     std::cout << "\n";
 
-    for (size_t i = 0; i < displayRows; ++i) {
-        std::cout << index.at(i) << "\t";
-        for (const auto& [_, colData] : columns) {
-            std::visit([i](const auto& vec) {
+    for (size_t i = 0; i < shown.rowCount; ++i) {
+        std::cout << shown.index.at(i) << "\t";
+        for (const auto& [_, colData] : shown.columns) {
+            visitDecoded([i](const auto& vec) {
                 using Vec = std::decay_t<decltype(vec)>;
-                if (vec[i].isNA()) {
+                if (vec.isNA(i)) {
                     std::cout << "NA";
                 } else if constexpr (std::is_same_v<Vec, BoolColumn>) {
-                    std::cout << (vec[i].valueUnsafe() ? "true" : "false");
+                    std::cout << (vec.value(i) ? "true" : "false");
+                } else if constexpr (std::is_same_v<Vec, TimestampColumn>) {
+                    std::cout << vec.value(i).toString();
+                } else if constexpr (isIntegerColumn<Vec>) {
+                    // Promoted so that 8-bit integers print as numbers, not characters.
+                    std::cout << +vec.value(i);
                 } else {
-                    std::cout << vec[i].valueUnsafe();
+                    std::cout << vec.value(i);
                 }
                 std::cout << "\t";
             }, colData);
@@ -426,15 +688,28 @@ void DataFrame::info() const {
 
     std::cout << "\nColumns:" << std::endl;
     for (const auto& [colName, colData] : columns) {
-        std::cout << "  - " << colName;
-        std::visit([](const auto& vec) {
+        std::cout << "  - " << colName << " (";
+        visitType([](const auto& vec) {
             using Vec = std::decay_t<decltype(vec)>;
-            if constexpr (std::is_same_v<Vec, IntColumn>)         std::cout << " (IntColumn)";
-            else if constexpr (std::is_same_v<Vec, DoubleColumn>) std::cout << " (DoubleColumn)";
-            else if constexpr (std::is_same_v<Vec, BoolColumn>)   std::cout << " (BoolColumn)";
-            else if constexpr (std::is_same_v<Vec, StringColumn>) std::cout << " (StringColumn)";
+            if constexpr (std::is_same_v<Vec, IntColumn>)         std::cout << "IntColumn";
+            else if constexpr (std::is_same_v<Vec, DoubleColumn>) std::cout << "DoubleColumn";
+            else if constexpr (std::is_same_v<Vec, BoolColumn>)   std::cout << "BoolColumn";
+            else if constexpr (std::is_same_v<Vec, StringColumn>) std::cout << "StringColumn";
+            else if constexpr (std::is_same_v<Vec, CategoricalColumn>) std::cout << "CategoricalColumn";
+            else if constexpr (std::is_same_v<Vec, TimestampColumn>) std::cout << "TimestampColumn";
+            else if constexpr (std::is_same_v<Vec, Int8Column>) std::cout << "Int8Column";
+            else if constexpr (std::is_same_v<Vec, Int16Column>) std::cout << "Int16Column";
+            else if constexpr (std::is_same_v<Vec, Int64Column>) std::cout << "Int64Column";
+            else if constexpr (std::is_same_v<Vec, UInt8Column>) std::cout << "UInt8Column";
+            else if constexpr (std::is_same_v<Vec, UInt16Column>) std::cout << "UInt16Column";
+            else if constexpr (std::is_same_v<Vec, UInt32Column>) std::cout << "UInt32Column";
+            else if constexpr (std::is_same_v<Vec, UInt64Column>) std::cout << "UInt64Column";
+            else if constexpr (std::is_same_v<Vec, FloatColumn>) std::cout << "FloatColumn";
         }, colData);
-        std::cout << std::endl;
+        if (const auto* encoded = std::get_if<EncodedColumn>(&colData)) {
+            std::cout << ", encoded in " << encoded->encodedBytes() << " bytes";
+        }
+        std::cout << ")" << std::endl;
     }
 }
 
@@ -446,4 +721,29 @@ DataFrame DataFrame::readCSV(const std::string& filename, const io::CSVReadOptio
     return io::readCSV(filename, options);
 }
 
+DataFrame DataFrame::readCSVMany(const std::vector<std::string>& paths, const io::CSVReadOptions& options,
+                                 const std::string& sourceColumn) {
+    return io::readCSVMany(paths, options, sourceColumn);
+}
+
+void DataFrame::save(const std::string& filename) const {
+    io::save(*this, filename);
+}
+
+DataFrame DataFrame::load(const std::string& filename, bool memoryMap) {
+    return io::load(filename, memoryMap);
+}
+
+void DataFrame::toArrow(const std::string& filename, io::ArrowFormat format) const {
+    io::writeArrow(*this, filename, format);
+}
+
+DataFrame DataFrame::readArrow(const std::string& filename, bool memoryMap) {
+    return io::readArrow(filename, memoryMap);
+}
+
+DataFrame DataFrame::readParquet(const std::string& filename, const io::ParquetReadOptions& options) {
+    return io::readParquet(filename, options);
+}
+
 } // namespace df
@@ -0,0 +1,645 @@
+#include "df/encoding.hpp"
+#include "df/io.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace df {
+
+namespace detail {
+
+struct EncodedBlock {
+    Encoding encoding = Encoding::FrameOfReference;
+    uint8_t width = 0;    // bits of each packed value
+    uint8_t runWidth = 0; // bits of each packed run length, for RLE
+    uint32_t runs = 0;    // for RLE
+    uint32_t validCount = 0;
+    uint64_t base = 0;    // the smallest key, or for Delta the first
+    uint64_t step = 0;    // the smallest difference between neighbouring keys, for Delta
+    uint64_t min = 0;     // of the valid keys
+    uint64_t max = 0;
+    size_t offset = 0;    // of the block's first word
+};
+
+// Values are stored as keys: unsigned integers ordered as the values are,
+// so that frames of reference and ranges work the same for every type.
+struct EncodedColumnState {
+    DataType type = DataType::Integer;
+    Encoding encoding = Encoding::Auto;
+    size_t rows = 0;
+    Bitmap validity;
+    std::vector<EncodedBlock> blocks;
+    std::vector<uint64_t> words;
+};
+
+} // namespace detail
+
+namespace {
+
+using detail::EncodedBlock;
+using detail::EncodedColumnState;
+using Op = io::ColumnPredicate::Op;
+
+constexpr uint64_t signBit = uint64_t(1) << 63;
+constexpr size_t blockRows = EncodedColumn::blockRows;
+
+template<typename F>
+decltype(auto) withElementType(DataType type, F&& f) {
+    switch (type) {
+        case DataType::Boolean: return f(bool{});
+        case DataType::Timestamp: return f(Timestamp{});
+        case DataType::Int8: return f(int8_t{});
+        case DataType::Int16: return f(int16_t{});
+        case DataType::Int64: return f(int64_t{});
+        case DataType::UInt8: return f(uint8_t{});
+        case DataType::UInt16: return f(uint16_t{});
+        case DataType::UInt32: return f(uint32_t{});
+        case DataType::UInt64: return f(uint64_t{});
+        default: return f(int{});
+    }
+}
+
+template<typename T>
+constexpr DataType dataTypeOf() {
+    if constexpr (std::is_same_v<T, bool>) return DataType::Boolean;
+    else if constexpr (std::is_same_v<T, Timestamp>) return DataType::Timestamp;
+    else if constexpr (std::is_same_v<T, int8_t>) return DataType::Int8;
+    else if constexpr (std::is_same_v<T, int16_t>) return DataType::Int16;
+    else if constexpr (std::is_same_v<T, int64_t>) return DataType::Int64;
+    else if constexpr (std::is_same_v<T, uint8_t>) return DataType::UInt8;
+    else if constexpr (std::is_same_v<T, uint16_t>) return DataType::UInt16;
+    else if constexpr (std::is_same_v<T, uint32_t>) return DataType::UInt32;
+    else if constexpr (std::is_same_v<T, uint64_t>) return DataType::UInt64;
+    else return DataType::Integer;
+}
+
+template<typename T>
+constexpr bool isSignedKey = std::is_same_v<T, Timestamp> || std::is_signed_v<T>;
+
+bool isSignedType(DataType type) {
+    return withElementType(type, [](auto sample) { return isSignedKey<decltype(sample)>; });
+}
+
+template<typename T>
+uint64_t toKey(T v) {
+    if constexpr (std::is_same_v<T, Timestamp>) return static_cast<uint64_t>(v.nanos) ^ signBit;
+    else if constexpr (std::is_signed_v<T>) return static_cast<uint64_t>(static_cast<int64_t>(v)) ^ signBit;
+    else return static_cast<uint64_t>(v);
+}
+
+template<typename T>
+T fromKey(uint64_t key) {
+    if constexpr (std::is_same_v<T, Timestamp>) return Timestamp(static_cast<int64_t>(key ^ signBit));
+    else if constexpr (std::is_signed_v<T>) return static_cast<T>(static_cast<int64_t>(key ^ signBit));
+    else return static_cast<T>(key);
+}
+
+// The value of a key as an integer, for sums.
+__int128 keyValue(uint64_t key, bool isSigned) {
+    if (isSigned) return static_cast<int64_t>(key ^ signBit);
+    return key;
+}
+
+unsigned bitsFor(uint64_t v) { return v == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(v)); }
+
+size_t wordsFor(size_t n, unsigned width) { return (n * width + 63) / 64; }
+
+// Appends n values of width bits, packed LSB first from a new word.
+void pack(std::vector<uint64_t>& words, const uint64_t* values, size_t n, unsigned width) {
+    if (width == 0) return;
+    const size_t start = words.size();
+    words.resize(start + wordsFor(n, width), 0);
+    uint64_t* out = words.data() + start;
+    size_t bit = 0;
+    for (size_t i = 0; i < n; ++i, bit += width) {
+        const size_t w = bit >> 6, shift = bit & 63;
+        out[w] |= values[i] << shift;
+        if (shift + width > 64) out[w + 1] |= values[i] >> (64 - shift);
+    }
+}
+
+void unpack(const uint64_t* in, size_t n, unsigned width, uint64_t* out) {
+    if (width == 0) {
+        std::fill(out, out + n, uint64_t(0));
+        return;
+    }
+    const uint64_t mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+    size_t bit = 0;
+    for (size_t i = 0; i < n; ++i, bit += width) {
+        const size_t w = bit >> 6, shift = bit & 63;
+        uint64_t v = in[w] >> shift;
+        if (shift + width > 64) v |= in[w + 1] << (64 - shift);
+        out[i] = v & mask;
+    }
+}
+
+uint64_t zigzag(uint64_t key, bool isSigned) {
+    if (!isSigned) return key;
+    const int64_t v = static_cast<int64_t>(key ^ signBit);
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+uint64_t unzigzag(uint64_t packed, bool isSigned) {
+    if (!isSigned) return packed;
+    return ((packed >> 1) ^ (~(packed & 1) + 1)) ^ signBit;
+}
+
+size_t blockLength(const EncodedColumnState& s, size_t b) { return std::min(blockRows, s.rows - b * blockRows); }
+
+// The keys of block b, with whatever the encoding left in NA slots.
+void decodeKeys(const EncodedColumnState& s, size_t b, uint64_t* out) {
+    const EncodedBlock& block = s.blocks[b];
+    const size_t n = blockLength(s, b);
+    const uint64_t* in = s.words.data() + block.offset;
+    switch (block.encoding) {
+        case Encoding::FrameOfReference:
+            unpack(in, n, block.width, out);
+            for (size_t i = 0; i < n; ++i) out[i] += block.base;
+            break;
+        case Encoding::BitPacked: {
+            const bool isSigned = isSignedType(s.type);
+            unpack(in, n, block.width, out);
+            for (size_t i = 0; i < n; ++i) out[i] = unzigzag(out[i], isSigned);
+            break;
+        }
+        case Encoding::Delta:
+            out[0] = block.base;
+            unpack(in, n - 1, block.width, out + 1);
+            for (size_t i = 1; i < n; ++i) out[i] += out[i - 1] + block.step;
+            break;
+        default: {
+            std::vector<uint64_t> values(block.runs), lengths(block.runs);
+            unpack(in, block.runs, block.width, values.data());
+            unpack(in + wordsFor(block.runs, block.width), block.runs, block.runWidth, lengths.data());
+            size_t i = 0;
+            for (size_t r = 0; r < block.runs; ++r) {
+                std::fill(out + i, out + i + lengths[r] + 1, values[r] + block.base);
+                i += lengths[r] + 1;
+            }
+        }
+    }
+}
+
+// Encodes blocks of keys, NA slots included, as the column's next block.
+class BlockEncoder {
+private:
+    EncodedColumnState& state;
+    bool isSigned;
+    std::vector<uint64_t> filled, scratch;
+
+public:
+    explicit BlockEncoder(EncodedColumnState& s)
+        : state(s), isSigned(isSignedType(s.type)), filled(blockRows), scratch(blockRows) {}
+
+    void add(const uint64_t* keys, size_t first, size_t n) {
+        EncodedBlock block;
+        block.offset = state.words.size();
+        uint64_t firstValid = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (!state.validity.get(first + i)) continue;
+            const uint64_t k = keys[i];
+            if (block.validCount++ == 0) block.min = block.max = firstValid = k;
+            block.min = std::min(block.min, k);
+            block.max = std::max(block.max, k);
+        }
+        if (block.validCount == 0) {
+            state.blocks.push_back(block);
+            return;
+        }
+
+        // NA slots repeat the value before them for Delta and RLE, so that
+        // they add no difference and no run.
+        uint64_t zigzagMax = 0, runLengthMax = 0;
+        int64_t deltaMin = 0, deltaMax = 0;
+        size_t runs = 1, runLength = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const bool valid = state.validity.get(first + i);
+            filled[i] = valid ? keys[i] : i > 0 ? filled[i - 1] : firstValid;
+            if (valid) zigzagMax = std::max(zigzagMax, zigzag(keys[i], isSigned));
+            if (i == 0) continue;
+            const auto delta = static_cast<int64_t>(filled[i] - filled[i - 1]);
+            deltaMin = i == 1 ? delta : std::min(deltaMin, delta);
+            deltaMax = i == 1 ? delta : std::max(deltaMax, delta);
+            if (filled[i] == filled[i - 1]) {
+                ++runLength;
+            } else {
+                runLengthMax = std::max<uint64_t>(runLengthMax, runLength);
+                runLength = 0;
+                ++runs;
+            }
+        }
+        runLengthMax = std::max<uint64_t>(runLengthMax, runLength);
+
+        const unsigned rangeWidth = bitsFor(block.max - block.min);
+        const unsigned deltaWidth = bitsFor(static_cast<uint64_t>(deltaMax) - static_cast<uint64_t>(deltaMin));
+        const unsigned zigzagWidth = bitsFor(zigzagMax);
+        const unsigned lengthWidth = bitsFor(runLengthMax);
+        block.encoding = state.encoding;
+        if (block.encoding == Encoding::Auto) {
+            const size_t sizes[] = {wordsFor(n, rangeWidth), wordsFor(runs, rangeWidth) + wordsFor(runs, lengthWidth),
+                                    wordsFor(n - 1, deltaWidth), wordsFor(n, zigzagWidth)};
+            const Encoding encodings[] = {Encoding::FrameOfReference, Encoding::RLE, Encoding::Delta,
+                                          Encoding::BitPacked};
+            block.encoding = encodings[std::min_element(std::begin(sizes), std::end(sizes)) - std::begin(sizes)];
+        }
+
+        switch (block.encoding) {
+            case Encoding::FrameOfReference:
+                block.base = block.min;
+                block.width = static_cast<uint8_t>(rangeWidth);
+                for (size_t i = 0; i < n; ++i) {
+                    scratch[i] = state.validity.get(first + i) ? keys[i] - block.min : 0;
+                }
+                pack(state.words, scratch.data(), n, rangeWidth);
+                break;
+            case Encoding::BitPacked:
+                block.width = static_cast<uint8_t>(zigzagWidth);
+                for (size_t i = 0; i < n; ++i) {
+                    scratch[i] = state.validity.get(first + i) ? zigzag(keys[i], isSigned) : 0;
+                }
+                pack(state.words, scratch.data(), n, zigzagWidth);
+                break;
+            case Encoding::Delta:
+                block.base = filled[0];
+                block.step = static_cast<uint64_t>(deltaMin);
+                block.width = static_cast<uint8_t>(deltaWidth);
+                for (size_t i = 1; i < n; ++i) scratch[i - 1] = filled[i] - filled[i - 1] - block.step;
+                pack(state.words, scratch.data(), n - 1, deltaWidth);
+                break;
+            default: {
+                block.base = block.min;
+                block.width = static_cast<uint8_t>(rangeWidth);
+                block.runWidth = static_cast<uint8_t>(lengthWidth);
+                block.runs = static_cast<uint32_t>(runs);
+                std::vector<uint64_t> lengths;
+                lengths.reserve(runs);
+                size_t r = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    if (i > 0 && filled[i] == filled[i - 1]) {
+                        ++lengths.back();
+                        continue;
+                    }
+                    scratch[r++] = filled[i] - block.min;
+                    lengths.push_back(0);
+                }
+                pack(state.words, scratch.data(), runs, rangeWidth);
+                pack(state.words, lengths.data(), runs, lengthWidth);
+            }
+        }
+        state.blocks.push_back(block);
+    }
+};
+
+template<typename T>
+std::shared_ptr<EncodedColumnState> encodeColumn(const Column<T>& column, Encoding encoding) {
+    auto state = std::make_shared<EncodedColumnState>();
+    state->type = dataTypeOf<T>();
+    state->encoding = encoding;
+    state->rows = column.size();
+    // A compact copy, so a sliced or borrowed bitmap does not keep its source alive.
+    std::vector<uint64_t> validWords(column.validity().numWords());
+    for (size_t k = 0; k < validWords.size(); ++k) validWords[k] = column.validity().wordAt(k);
+    state->validity = Bitmap(SharedBuffer<uint64_t>(std::move(validWords)), column.size());
+
+    BlockEncoder encoder(*state);
+    std::vector<uint64_t> keys(blockRows);
+    const auto* data = column.data();
+    state->blocks.reserve((column.size() + blockRows - 1) / blockRows);
+    for (size_t first = 0; first < column.size(); first += blockRows) {
+        const size_t n = std::min(blockRows, column.size() - first);
+        for (size_t i = 0; i < n; ++i) keys[i] = toKey(static_cast<T>(data[first + i]));
+        encoder.add(keys.data(), first, n);
+    }
+    state->words.shrink_to_fit();
+    return state;
+}
+
+template<typename T>
+Column<T> decodeRows(const EncodedColumnState& s, size_t start, size_t end) {
+    using S = typename Column<T>::storage_type;
+    std::vector<S> values(end - start);
+    std::vector<uint64_t> keys(blockRows);
+    for (size_t b = start / blockRows; b * blockRows < end; ++b) {
+        const size_t first = b * blockRows;
+        const size_t from = std::max(start, first), to = std::min(end, first + blockLength(s, b));
+        if (s.blocks[b].validCount == 0) continue;
+        decodeKeys(s, b, keys.data());
+        for (size_t i = from; i < to; ++i) {
+            values[i - start] = s.validity.get(i) ? static_cast<S>(fromKey<T>(keys[i - first])) : S{};
+        }
+    }
+    return Column<T>(std::move(values), s.validity.slice(start, end - start));
+}
+
+// The sum of the valid values of block b.
+__int128 blockSum(const EncodedColumnState& s, size_t b, std::vector<uint64_t>& keys) {
+    const EncodedBlock& block = s.blocks[b];
+    const size_t n = blockLength(s, b);
+    const size_t first = b * blockRows;
+    const bool isSigned = isSignedType(s.type);
+    if (block.validCount == 0) return 0;
+    const uint64_t* in = s.words.data() + block.offset;
+    __int128 total = 0;
+    // NA slots hold offset 0 under a frame of reference.
+    if (block.encoding == Encoding::FrameOfReference) {
+        unpack(in, n, block.width, keys.data());
+        for (size_t i = 0; i < n; ++i) total += keys[i];
+        return total + keyValue(block.base, isSigned) * block.validCount;
+    }
+    if (block.encoding == Encoding::RLE && block.validCount == n) {
+        std::vector<uint64_t> lengths(block.runs);
+        unpack(in, block.runs, block.width, keys.data());
+        unpack(in + wordsFor(block.runs, block.width), block.runs, block.runWidth, lengths.data());
+        for (size_t r = 0; r < block.runs; ++r) {
+            total += keyValue(keys[r] + block.base, isSigned) * static_cast<__int128>(lengths[r] + 1);
+        }
+        return total;
+    }
+    decodeKeys(s, b, keys.data());
+    for (size_t i = 0; i < n; ++i) {
+        if (s.validity.get(first + i)) total += keyValue(keys[i], isSigned);
+    }
+    return total;
+}
+
+// Sets bits [from, to) of words.
+void setRange(std::vector<uint64_t>& words, size_t from, size_t to) {
+    for (size_t i = from; i < to;) {
+        const size_t w = i >> 6, shift = i & 63;
+        const size_t count = std::min<size_t>(64 - shift, to - i);
+        words[w] |= (count == 64 ? ~uint64_t(0) : ((uint64_t(1) << count) - 1)) << shift;
+        i += count;
+    }
+}
+
+Value plainValue(const Value& v) {
+    return std::visit([](const auto& x) -> Value {
+        using X = std::decay_t<decltype(x)>;
+        if constexpr (std::is_same_v<X, NA> || std::is_same_v<X, std::string> || std::is_arithmetic_v<X> ||
+                      std::is_same_v<X, Timestamp>) {
+            return x;
+        } else {
+            if (x.isNA()) return NA_VALUE;
+            return x.valueUnsafe();
+        }
+    }, v);
+}
+
+constexpr __int128 unbounded = static_cast<__int128>(1) << 100;
+
+// The least and greatest integers at or above, and at or below, a bound of
+// a column holding T; false when the bound is of another kind, or NaN.
+template<typename T>
+bool integerBounds(const Value& bound, __int128& ceiling, __int128& floor) {
+    return std::visit([&](const auto& x) {
+        using X = std::decay_t<decltype(x)>;
+        if constexpr (std::is_same_v<T, Timestamp>) {
+            if constexpr (!std::is_same_v<X, Timestamp>) return false;
+            else ceiling = floor = x.nanos;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            if constexpr (!std::is_same_v<X, bool>) return false;
+            else ceiling = floor = x ? 1 : 0;
+        } else if constexpr (std::is_floating_point_v<X>) {
+            if (std::isnan(x)) return false;
+            const long double limit = 1e30L;
+            const long double v = std::max(-limit, std::min(limit, static_cast<long double>(x)));
+            ceiling = static_cast<__int128>(std::ceil(v));
+            floor = static_cast<__int128>(std::floor(v));
+        } else if constexpr (std::is_arithmetic_v<X> && !std::is_same_v<X, bool>) {
+            ceiling = floor = x;
+        } else {
+            return false;
+        }
+        return true;
+    }, plainValue(bound));
+}
+
+// The keys of the values passing a comparison, as an inclusive range;
+// false when the bound is of another kind than the column.
+template<typename T>
+bool passingKeys(const io::ColumnPredicate& predicate, uint64_t& lo, uint64_t& hi) {
+    __int128 lower = -unbounded, upper = unbounded, ceiling, floor;
+    if (!integerBounds<T>(predicate.value, ceiling, floor)) return false;
+    switch (predicate.op) {
+        case Op::Equal:
+        case Op::NotEqual: lower = ceiling; upper = floor; break;
+        case Op::Less: upper = ceiling - 1; break;
+        case Op::LessEqual: upper = floor; break;
+        case Op::Greater: lower = floor + 1; break;
+        case Op::GreaterEqual: lower = ceiling; break;
+        case Op::Between: {
+            __int128 upperCeiling, upperFloor;
+            if (!integerBounds<T>(predicate.upper, upperCeiling, upperFloor)) return false;
+            lower = ceiling;
+            upper = upperFloor;
+            break;
+        }
+        default: return false;
+    }
+    __int128 least, greatest;
+    if constexpr (std::is_same_v<T, Timestamp>) {
+        least = std::numeric_limits<int64_t>::min();
+        greatest = std::numeric_limits<int64_t>::max();
+    } else {
+        least = std::numeric_limits<T>::min();
+        greatest = std::numeric_limits<T>::max();
+    }
+    lower = std::max(lower, least);
+    upper = std::min(upper, greatest);
+    if (lower > upper) {
+        lo = 1;
+        hi = 0;
+    } else if constexpr (std::is_same_v<T, Timestamp>) {
+        lo = toKey(Timestamp(static_cast<int64_t>(lower)));
+        hi = toKey(Timestamp(static_cast<int64_t>(upper)));
+    } else {
+        lo = toKey(static_cast<T>(lower));
+        hi = toKey(static_cast<T>(upper));
+    }
+    return true;
+}
+
+} // namespace
+
+EncodedColumn::EncodedColumn() : state(std::make_shared<EncodedColumnState>()) {}
+
+EncodedColumn::EncodedColumn(const ColumnData& column, Encoding encoding) {
+    if (const auto* encoded = std::get_if<EncodedColumn>(&column)) {
+        if (encoded->encoding() == encoding) state = encoded->state;
+        else state = EncodedColumn(encoded->decode(), encoding).state;
+        return;
+    }
+    std::visit([&](const auto& col) {
+        using Col = std::decay_t<decltype(col)>;
+        if constexpr (std::is_same_v<Col, EncodedColumn>) {
+            return;
+        } else if constexpr (isIntegerColumn<Col> || std::is_same_v<Col, BoolColumn> ||
+                             std::is_same_v<Col, TimestampColumn>) {
+            state = encodeColumn(col, encoding);
+        } else {
+            throw std::invalid_argument("Only integer, Bool and Timestamp columns can be encoded.");
+        }
+    }, column);
+}
+
+bool EncodedColumn::supports(const ColumnData& column) {
+    return std::visit([](const auto& col) {
+        using Col = std::decay_t<decltype(col)>;
+        if constexpr (std::is_same_v<Col, EncodedColumn>) return true;
+        else return isIntegerColumn<Col> || std::is_same_v<Col, BoolColumn> || std::is_same_v<Col, TimestampColumn>;
+    }, column);
+}
+
+DataType EncodedColumn::type() const { return state->type; }
+Encoding EncodedColumn::encoding() const { return state->encoding; }
+
+size_t EncodedColumn::encodedBytes() const {
+    return sizeof(EncodedColumnState) + state->words.capacity() * sizeof(uint64_t) +
+           state->blocks.capacity() * sizeof(EncodedBlock) + state->validity.numWords() * sizeof(uint64_t);
+}
+
+size_t EncodedColumn::size() const { return state->rows; }
+bool EncodedColumn::isNA(size_t i) const { return !state->validity.get(i); }
+size_t EncodedColumn::nullCount() const { return state->rows - state->validity.count(); }
+const Bitmap& EncodedColumn::validity() const { return state->validity; }
+
+ColumnData EncodedColumn::decode() const { return slice(0, size()); }
+
+ColumnData EncodedColumn::slice(size_t start, size_t end) const {
+    return withElementType(state->type, [&](auto sample) -> ColumnData {
+        return decodeRows<decltype(sample)>(*state, start, end);
+    });
+}
+
+ColumnData EncodedColumn::take(const std::vector<size_t>& positions) const {
+    return withElementType(state->type, [&](auto sample) -> ColumnData {
+        using T = decltype(sample);
+        // Out-of-order positions (a sort's permutation) would decode a block
+        // again each time they cross into another; decode everything once.
+        if (!std::is_sorted(positions.begin(), positions.end())) {
+            return decodeRows<T>(*state, 0, state->rows).take(positions);
+        }
+        Column<T> taken;
+        taken.reserve(positions.size());
+        std::vector<uint64_t> keys(blockRows);
+        size_t decoded = static_cast<size_t>(-1);
+        for (size_t pos : positions) {
+            if (isNA(pos)) {
+                taken.pushNA();
+                continue;
+            }
+            if (pos / blockRows != decoded) {
+                decoded = pos / blockRows;
+                decodeKeys(*state, decoded, keys.data());
+            }
+            taken.push_back(fromKey<T>(keys[pos % blockRows]));
+        }
+        return taken;
+    });
+}
+
+Value EncodedColumn::count() const { return static_cast<int>(size() - nullCount()); }
+
+Value EncodedColumn::min() const {
+    return withElementType(state->type, [&](auto sample) -> Value {
+        using T = decltype(sample);
+        bool any = false;
+        uint64_t least = 0;
+        for (const EncodedBlock& block : state->blocks) {
+            if (block.validCount == 0) continue;
+            least = any ? std::min(least, block.min) : block.min;
+            any = true;
+        }
+        if (!any) return NA_VALUE;
+        return fromKey<T>(least);
+    });
+}
+
+Value EncodedColumn::max() const {
+    return withElementType(state->type, [&](auto sample) -> Value {
+        using T = decltype(sample);
+        bool any = false;
+        uint64_t greatest = 0;
+        for (const EncodedBlock& block : state->blocks) {
+            if (block.validCount == 0) continue;
+            greatest = any ? std::max(greatest, block.max) : block.max;
+            any = true;
+        }
+        if (!any) return NA_VALUE;
+        return fromKey<T>(greatest);
+    });
+}
+
+Value EncodedColumn::sum() const {
+    if (state->type == DataType::Timestamp || size() == nullCount()) return NA_VALUE;
+    std::vector<uint64_t> keys(blockRows);
+    __int128 total = 0;
+    for (size_t b = 0; b < state->blocks.size(); ++b) total += blockSum(*state, b, keys);
+    if (total >= std::numeric_limits<int>::min() && total <= std::numeric_limits<int>::max()) {
+        return static_cast<int>(total);
+    }
+    const bool isUnsigned = !isSignedType(state->type) && state->type != DataType::Boolean;
+    if (isUnsigned && total <= std::numeric_limits<uint64_t>::max()) return static_cast<uint64_t>(total);
+    if (!isUnsigned && total >= std::numeric_limits<int64_t>::min() && total <= std::numeric_limits<int64_t>::max()) {
+        return static_cast<int64_t>(total);
+    }
+    return static_cast<double>(total);
+}
+
+Value EncodedColumn::mean() const {
+    if (state->type == DataType::Timestamp || size() == nullCount()) return NA_VALUE;
+    std::vector<uint64_t> keys(blockRows);
+    __int128 total = 0;
+    for (size_t b = 0; b < state->blocks.size(); ++b) total += blockSum(*state, b, keys);
+    return static_cast<double>(total) / static_cast<double>(size() - nullCount());
+}
+
+Bitmap EncodedColumn::matches(const io::ColumnPredicate& predicate) const {
+    const EncodedColumnState& s = *state;
+    const size_t numWords = s.validity.numWords();
+    std::vector<uint64_t> words(numWords, 0);
+    if (predicate.op == Op::IsNA || predicate.op == Op::NotNA) {
+        for (size_t k = 0; k < numWords; ++k) {
+            words[k] = predicate.op == Op::NotNA ? s.validity.wordAt(k) : ~s.validity.wordAt(k);
+        }
+    } else {
+        uint64_t lo = 1, hi = 0;
+        const bool comparable = withElementType(s.type, [&](auto sample) {
+            return passingKeys<decltype(sample)>(predicate, lo, hi);
+        });
+        std::vector<uint64_t> keys(blockRows);
+        for (size_t b = 0; comparable && lo <= hi && b < s.blocks.size(); ++b) {
+            const EncodedBlock& block = s.blocks[b];
+            const size_t first = b * blockRows, n = blockLength(s, b);
+            if (block.validCount == 0 || hi < block.min || lo > block.max) continue;
+            if (lo <= block.min && block.max <= hi) {
+                setRange(words, first, first + n);
+            } else if (block.encoding == Encoding::RLE) {
+                std::vector<uint64_t> lengths(block.runs);
+                const uint64_t* in = s.words.data() + block.offset;
+                unpack(in, block.runs, block.width, keys.data());
+                unpack(in + wordsFor(block.runs, block.width), block.runs, block.runWidth, lengths.data());
+                size_t i = first;
+                for (size_t r = 0; r < block.runs; ++r) {
+                    const uint64_t key = keys[r] + block.base;
+                    if (lo <= key && key <= hi) setRange(words, i, i + lengths[r] + 1);
+                    i += lengths[r] + 1;
+                }
+            } else {
+                decodeKeys(s, b, keys.data());
+                for (size_t i = 0; i < n; ++i) {
+                    if (lo <= keys[i] && keys[i] <= hi) words[(first + i) >> 6] |= uint64_t(1) << ((first + i) & 63);
+                }
+            }
+        }
+        for (size_t k = 0; k < numWords; ++k) {
+            words[k] &= s.validity.wordAt(k);
+            if (predicate.op == Op::NotEqual) words[k] = ~words[k];
+        }
+    }
+    if (s.rows % 64 != 0 && numWords > 0) words.back() &= (uint64_t(1) << (s.rows % 64)) - 1;
+    return Bitmap(SharedBuffer<uint64_t>(std::move(words)), s.rows);
+}
+
+} // namespace df
@@ -3,6 +3,7 @@
 #include "df/index.hpp"
 #include "df/stats.hpp"
 #include <algorithm>
+#include <optional>
 #include <stdexcept>
 #include <set>
 
@@ -11,25 +12,19 @@ namespace df {
 namespace {
 
 Value extractValueAtRow(const ColumnData& col, size_t row) {
-    return std::visit([row](const auto& vec) -> Value {
-        return vec[row];
+    return visitDecoded([row](const auto& vec) -> Value {
+        return vec.get(row);
     }, col);
 }
 
 ColumnData extractSubColumn(const ColumnData& col, const std::vector<size_t>& indices) {
     return std::visit([&](const auto& vec) -> ColumnData {
-        using VecType = std::decay_t<decltype(vec)>;
-        VecType result;
-        result.reserve(indices.size());
-        for (size_t idx : indices) {
-            result.push_back(vec[idx]);
-        }
-        return result;
+        return vec.take(indices);
     }, col);
 }
 
 ColumnData buildGroupKeyColumn(const ColumnData& sourceCol, const std::vector<Value>& values) {
-    return std::visit([&](const auto& srcVec) -> ColumnData {
+    return visitType([&](const auto& srcVec) -> ColumnData {
         using VecType = std::decay_t<decltype(srcVec)>;
         using ElemType = typename VecType::value_type;
 
@@ -46,96 +41,123 @@ ColumnData buildGroupKeyColumn(const ColumnData& sourceCol, const std::vector<Va
     }, sourceCol);
 }
 
-ColumnData buildAggregatedColumn(const std::vector<Value>& values) {
-    bool hasInt = false, hasDouble = false, hasBool = false, hasString = false;
+template<typename X>
+struct NullableElement { using type = void; };
+template<typename T>
+struct NullableElement<Nullable<T>> { using type = T; };
+
+// v with any Nullable unwrapped: its value, or NA.
+Value plainValue(const Value& v) {
+    return std::visit([](const auto& x) -> Value {
+        using X = std::decay_t<decltype(x)>;
+        if constexpr (std::is_void_v<typename NullableElement<X>::type>) return x;
+        else if (x.isNA()) return NA_VALUE;
+        else return x.valueUnsafe();
+    }, v);
+}
+
+bool isNumber(const Value& v) {
+    return std::visit([](const auto& x) { return std::is_arithmetic_v<std::decay_t<decltype(x)>>; }, v);
+}
 
+// Aggregates of a group go back into one column: strings if any value is a
+// string, timestamps if all are, and otherwise numbers of the type holding
+// every numeric value (see CommonNumber). Values of other kinds are NA.
+ColumnData buildAggregatedColumn(const std::vector<Value>& values) {
+    std::vector<Value> plain;
+    plain.reserve(values.size());
+    bool hasString = false, hasTimestamp = false;
+    std::optional<Value> number; // a value of the common numeric type
     for (const auto& val : values) {
-        if (std::holds_alternative<int>(val))              hasInt = true;
-        else if (std::holds_alternative<double>(val))      hasDouble = true;
-        else if (std::holds_alternative<bool>(val))        hasBool = true;
-        else if (std::holds_alternative<std::string>(val)) hasString = true;
-        else if (std::holds_alternative<NullableInt>(val)    && !std::get<NullableInt>(val).isNA())    hasInt = true;
-        else if (std::holds_alternative<NullableDouble>(val) && !std::get<NullableDouble>(val).isNA()) hasDouble = true;
-        else if (std::holds_alternative<NullableBool>(val)   && !std::get<NullableBool>(val).isNA())   hasBool = true;
-        else if (std::holds_alternative<NullableString>(val) && !std::get<NullableString>(val).isNA()) hasString = true;
+        plain.push_back(plainValue(val));
+        const Value& v = plain.back();
+        if (std::holds_alternative<std::string>(v)) {
+            hasString = true;
+        } else if (std::holds_alternative<Timestamp>(v)) {
+            hasTimestamp = true;
+        } else if (isNumber(v)) {
+            if (!number) {
+                number = v;
+                continue;
+            }
+            number = std::visit([](auto a, auto b) -> Value {
+                using A = decltype(a);
+                using B = decltype(b);
+                if constexpr (std::is_arithmetic_v<A> && std::is_arithmetic_v<B>) return CommonNumber<A, B>{};
+                else return a;
+            }, *number, v);
+        }
     }
 
     if (hasString) {
         StringColumn result;
         result.reserve(values.size());
-        for (const auto& val : values) {
-            if (std::holds_alternative<std::string>(val))         result.push_back(std::get<std::string>(val));
-            else if (std::holds_alternative<NullableString>(val)) result.push_back(std::get<NullableString>(val));
-            else                                                  result.push_back(NA_VALUE);
+        for (const auto& v : plain) {
+            if (std::holds_alternative<std::string>(v)) result.push_back(std::get<std::string>(v));
+            else                                        result.push_back(NA_VALUE);
         }
         return result;
     }
 
-    if (hasDouble) {
-        DoubleColumn result;
+    if (hasTimestamp && !number) {
+        TimestampColumn result;
         result.reserve(values.size());
-        for (const auto& val : values) {
-            if (std::holds_alternative<double>(val)) {
-                result.push_back(std::get<double>(val));
-            } else if (std::holds_alternative<int>(val)) {
-                result.push_back(static_cast<double>(std::get<int>(val)));
-            } else if (std::holds_alternative<bool>(val)) {
-                result.push_back(std::get<bool>(val) ? 1.0 : 0.0);
-            } else if (std::holds_alternative<NullableDouble>(val)) {
-                result.push_back(std::get<NullableDouble>(val));
-            } else if (std::holds_alternative<NullableInt>(val)) {
-                const auto& n = std::get<NullableInt>(val);
-                result.push_back(n.isNA() ? NullableDouble(NA_VALUE)
-                                          : NullableDouble(static_cast<double>(n.valueUnsafe())));
-            } else if (std::holds_alternative<NullableBool>(val)) {
-                const auto& n = std::get<NullableBool>(val);
-                result.push_back(n.isNA() ? NullableDouble(NA_VALUE)
-                                          : NullableDouble(n.valueUnsafe() ? 1.0 : 0.0));
-            } else {
-                result.push_back(NA_VALUE);
-            }
+        for (const auto& v : plain) {
+            if (std::holds_alternative<Timestamp>(v)) result.push_back(std::get<Timestamp>(v));
+            else                                      result.push_back(NA_VALUE);
         }
         return result;
     }
 
-    if (hasInt) {
-        IntColumn result;
-        result.reserve(values.size());
-        for (const auto& val : values) {
-            if (std::holds_alternative<int>(val)) {
-                result.push_back(std::get<int>(val));
-            } else if (std::holds_alternative<bool>(val)) {
-                result.push_back(std::get<bool>(val) ? 1 : 0);
-            } else if (std::holds_alternative<NullableInt>(val)) {
-                result.push_back(std::get<NullableInt>(val));
-            } else if (std::holds_alternative<NullableBool>(val)) {
-                const auto& n = std::get<NullableBool>(val);
-                result.push_back(n.isNA() ? NullableInt(NA_VALUE)
-                                          : NullableInt(n.valueUnsafe() ? 1 : 0));
-            } else {
-                result.push_back(NA_VALUE);
-            }
-        }
-        return result;
+    if (!number) {
+        DoubleColumn allNA(values.size());
+        return allNA;
     }
 
-    if (hasBool) {
-        BoolColumn result;
-        result.reserve(values.size());
-        for (const auto& val : values) {
-            if (std::holds_alternative<bool>(val))              result.push_back(std::get<bool>(val));
-            else if (std::holds_alternative<NullableBool>(val)) result.push_back(std::get<NullableBool>(val));
-            else                                                result.push_back(NA_VALUE);
+    return std::visit([&](const auto& type) -> ColumnData {
+        using T = std::decay_t<decltype(type)>;
+        if constexpr (std::is_arithmetic_v<T>) {
+            Column<T> result;
+            result.reserve(values.size());
+            for (const auto& v : plain) {
+                std::visit([&result](const auto& x) {
+                    using X = std::decay_t<decltype(x)>;
+                    if constexpr (std::is_arithmetic_v<X>) result.push_back(static_cast<T>(x));
+                    else result.pushNA();
+                }, v);
+            }
+            return result;
+        } else {
+            return DoubleColumn(values.size());
         }
-        return result;
-    }
+    }, *number);
+}
 
-    DoubleColumn allNA(values.size());
-    return allNA;
+bool isMissing(const Value& v) {
+    return std::visit([](const auto& x) -> bool {
+        using X = std::decay_t<decltype(x)>;
+        if constexpr (std::is_same_v<X, NA>) return true;
+        else if constexpr (!std::is_void_v<typename NullableElement<X>::type>) return x.isNA();
+        else return false;
+    }, v);
 }
 
 } // anonymous namespace
 
+bool GroupBy::GroupKeyLess::operator()(const GroupKey& a, const GroupKey& b) const {
+    size_t n = std::min(a.size(), b.size());
+    for (size_t k = 0; k < n; ++k) {
+        bool naA = isMissing(a[k]);
+        bool naB = isMissing(b[k]);
+        if (naA || naB) {
+            if (naA != naB) return naB;
+            continue;
+        }
+        if (a[k] < b[k]) return true;
+        if (b[k] < a[k]) return false;
+    }
+    return a.size() < b.size();
+}
 
 GroupBy::GroupBy(const DataFrame& dataframe, const std::vector<std::string>& byColumns)
     : df(std::make_shared<DataFrame>(dataframe)), by(byColumns)
@@ -144,16 +166,55 @@ GroupBy::GroupBy(const DataFrame& dataframe, const std::vector<std::string>& byC
         if (!df->columnExists(colName)) {
             throw std::invalid_argument("GroupBy column does not exist: " + colName);
         }
+        // Keys are read row by row, so they are kept decoded.
+        df->decode(colName);
+    }
+
+    std::vector<const CategoricalColumn*> categoricalKeys;
+    for (const auto& colName : by) {
+        const auto& col = (*df)[colName];
+        categoricalKeys.push_back(std::holds_alternative<CategoricalColumn>(col)
+                                      ? &std::get<CategoricalColumn>(col) : nullptr);
     }
 
     size_t nRows = df->numRows();
+    if (std::any_of(categoricalKeys.begin(), categoricalKeys.end(),
+                    [](const CategoricalColumn* c) { return c == nullptr; })) {
+        for (size_t i = 0; i < nRows; ++i) {
+            GroupKey key;
+            key.reserve(by.size());
+            for (const auto& colName : by) {
+                key.push_back(extractValueAtRow((*df)[colName], i));
+            }
+            groups[key].push_back(i);
+        }
+        return;
+    }
+
+    // Every key is categorical: bucket rows by their codes (-1 for NA), so
+    // category strings are materialised once per group instead of per row.
+    // Codes map one-to-one onto categories, so each bucket is one group and
+    // its rows are already in order.
+    std::map<std::vector<int32_t>, std::vector<size_t>> buckets;
+    std::vector<int32_t> codes(by.size(), 0);
     for (size_t i = 0; i < nRows; ++i) {
-        GroupKey key;
-        key.reserve(by.size());
-        for (const auto& colName : by) {
-            key.push_back(extractValueAtRow((*df)[colName], i));
+        for (size_t k = 0; k < by.size(); ++k) {
+            const CategoricalColumn* cat = categoricalKeys[k];
+            codes[k] = cat->isNA(i) ? -1 : cat->code(i);
+        }
+        auto it = buckets.find(codes);
+        if (it == buckets.end()) it = buckets.emplace(codes, std::vector<size_t>{}).first;
+        it->second.push_back(i);
+    }
+
+    for (auto& [bucketCodes, rows] : buckets) {
+        GroupKey key(by.size());
+        for (size_t k = 0; k < by.size(); ++k) {
+            key[k] = bucketCodes[k] < 0
+                ? NullableString(NA_VALUE)
+                : NullableString(std::string(categoricalKeys[k]->dictionary().at(bucketCodes[k])));
         }
-        groups[key].push_back(i);
+        groups.emplace(std::move(key), std::move(rows));
     }
 }
 
@@ -276,31 +337,38 @@ DataFrame GroupBy::transform(const std::function<ColumnData(const ColumnData&)>&
         if (!bySet.count(name)) nonByColumns.push_back(name);
     }
 
+    // Transformed groups are appended in group order and scattered back to
+    // their original rows with a single take at the end.
     std::map<std::string, ColumnData> resultCols;
     for (const auto& colName : nonByColumns) {
         const auto& srcCol = (*df)[colName];
-        std::visit([&](const auto& vec) {
+        visitType([&](const auto& vec) {
             using VecType = std::decay_t<decltype(vec)>;
-            resultCols[colName] = VecType(nRows);
+            VecType empty;
+            empty.reserve(nRows);
+            resultCols[colName] = std::move(empty);
         }, srcCol);
     }
 
+    std::vector<size_t> positionOfRow(nRows);
+    size_t appended = 0;
     for (const auto& [key, indices] : groups) {
+        for (size_t i = 0; i < indices.size(); ++i) positionOfRow[indices[i]] = appended + i;
+        appended += indices.size();
+
         for (const auto& colName : nonByColumns) {
             ColumnData subCol = extractSubColumn((*df)[colName], indices);
             ColumnData transformed = func(subCol);
 
-            std::visit([&](auto& resultVec) {
+            visitDecodedInPlace([&](auto& resultVec) {
                 using ResultVecType = std::decay_t<decltype(resultVec)>;
-                std::visit([&](const auto& transVec) {
+                visitDecoded([&](const auto& transVec) {
                     using TransVecType = std::decay_t<decltype(transVec)>;
                     if constexpr (std::is_same_v<ResultVecType, TransVecType>) {
                         if (transVec.size() != indices.size()) {
                             throw std::runtime_error("Transform function returned wrong number of rows");
                         }
-                        for (size_t i = 0; i < indices.size(); ++i) {
-                            resultVec[indices[i]] = transVec[i];
-                        }
+                        resultVec.append(transVec);
                     } else {
                         throw std::runtime_error("Transform function returned a different column type");
                     }
@@ -309,6 +377,10 @@ DataFrame GroupBy::transform(const std::function<ColumnData(const ColumnData&)>&
         }
     }
 
+    for (auto& [colName, colData] : resultCols) {
+        visitDecodedInPlace([&positionOfRow](auto& vec) { vec = vec.take(positionOfRow); }, colData);
+    }
+
     std::vector<std::pair<std::string, ColumnData>> resultData;
     for (const auto& colName : colNames) {
         if (bySet.count(colName)) {
@@ -319,7 +391,7 @@ DataFrame GroupBy::transform(const std::function<ColumnData(const ColumnData&)>&
     }
 
     DataFrame result(resultData);
-    result.setIndex(df->getIndex().getLabels());
+    result.setIndex(df->getIndex());
     return result;
 }
 
@@ -346,11 +418,7 @@ DataFrame GroupBy::filter(const std::function<bool(const DataFrame&)>& func) con
 
     DataFrame result(resultData);
     if (!keepIndices.empty()) {
-        std::vector<std::string> indexLabels;
-        indexLabels.reserve(keepIndices.size());
-        const auto& idx = df->getIndex();
-        for (size_t i : keepIndices) indexLabels.push_back(idx.at(i));
-        result.setIndex(indexLabels);
+        result.setIndex(df->getIndex().take(keepIndices));
     }
     return result;
 }
@@ -375,11 +443,7 @@ DataFrame GroupBy::getGroup(const GroupKey& key) const {
     }
 
     DataFrame result(groupData);
-    std::vector<std::string> indexLabels;
-    indexLabels.reserve(indices.size());
-    const auto& idx = df->getIndex();
-    for (size_t i : indices) indexLabels.push_back(idx.at(i));
-    result.setIndex(indexLabels);
+    result.setIndex(df->getIndex().take(indices));
     return result;
 }
 
@@ -1,76 +1,381 @@
 #include "df/index.hpp"
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <limits>
 #include <stdexcept>
+#include <string_view>
 
 namespace df {
 
-Index::Index(size_t size) : isDefaultIndex(true) {
-    labels.reserve(size);
-    for (size_t i = 0; i < size; ++i) {
-        std::string label = std::to_string(i);
-        labels.push_back(label);
-        labelToPos[label] = i;
+namespace {
+
+// Parses the canonical decimal spelling of an integer label, so "07" is not
+// the label "7".
+bool parseIntegerLabel(const std::string& label, long long& value) {
+    const char* first = label.data();
+    const char* last = first + label.size();
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    return ec == std::errc() && ptr == last && std::to_string(value) == label;
+}
+
+size_t hashInt64(int64_t v) {
+    uint64_t x = static_cast<uint64_t>(v);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return static_cast<size_t>(x);
+}
+
+size_t hashString(const std::string& s) {
+    return std::hash<std::string_view>()(s);
+}
+
+long long floorDiv(long long a, long long b) {
+    long long q = a / b;
+    if (a % b != 0 && ((a < 0) != (b < 0))) --q;
+    return q;
+}
+
+long long ceilDiv(long long a, long long b) {
+    long long q = a / b;
+    if (a % b != 0 && ((a < 0) == (b < 0))) ++q;
+    return q;
+}
+
+void checkTableSize(size_t n) {
+    if (n >= std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Index is too large for a hashed lookup table");
     }
 }
 
-Index::Index(const std::vector<std::string>& indexLabels) : isDefaultIndex(false) {
-    labels.reserve(indexLabels.size());
-    for (size_t i = 0; i < indexLabels.size(); ++i) {
-        const std::string& label = indexLabels[i];
-        if (labelToPos.find(label) != labelToPos.end()) {
-            throw std::invalid_argument("Duplicate index label: " + label);
-        }
-        labels.push_back(label);
-        labelToPos[label] = i;
+} // namespace
+
+RangeIndex::RangeIndex(long long start, long long stop, long long step) : start(start), step(step), length(0) {
+    if (step == 0) {
+        throw std::invalid_argument("RangeIndex step must not be zero");
+    }
+    if (step > 0 && stop > start) length = static_cast<size_t>((stop - start + step - 1) / step);
+    if (step < 0 && stop < start) length = static_cast<size_t>((start - stop - step - 1) / -step);
+}
+
+size_t RangeIndex::find(const std::string& label) const {
+    long long v = 0;
+    if (!parseIntegerLabel(label, v)) return length;
+    return find(v);
+}
+
+size_t RangeIndex::find(long long value) const {
+    long long delta = value - start;
+    if (delta % step != 0) return length;
+    long long pos = delta / step;
+    if (pos < 0 || static_cast<size_t>(pos) >= length) return length;
+    return static_cast<size_t>(pos);
+}
+
+const std::vector<std::string>& RangeIndex::getLabels() const {
+    if (!labels) {
+        auto built = std::make_shared<std::vector<std::string>>();
+        built->reserve(length);
+        for (size_t i = 0; i < length; ++i) built->push_back(at(i));
+        labels = std::move(built);
     }
+    return *labels;
 }
 
-const std::string& Index::at(size_t pos) const {
-    if (pos >= labels.size()) {
+std::pair<size_t, size_t> RangeIndex::locRange(long long first, long long last) const {
+    long long begin, end;
+    if (step > 0) {
+        begin = ceilDiv(first - start, step);
+        end = floorDiv(last - start, step) + 1;
+    } else {
+        begin = ceilDiv(last - start, step);
+        end = floorDiv(first - start, step) + 1;
+    }
+    const long long n = static_cast<long long>(length);
+    begin = std::clamp(begin, 0LL, n);
+    end = std::clamp(end, begin, n);
+    return {static_cast<size_t>(begin), static_cast<size_t>(end)};
+}
+
+RangeIndex RangeIndex::slice(size_t begin, size_t end) const {
+    return RangeIndex(valueAt(begin), valueAt(end), step);
+}
+
+Int64Index::Int64Index(std::vector<int64_t> labelValues) {
+    length = labelValues.size();
+    for (size_t i = 1; i < length && sorted; ++i) sorted = labelValues[i - 1] <= labelValues[i];
+    if (sorted) {
+        for (size_t i = 1; i < length && unique; ++i) unique = labelValues[i - 1] != labelValues[i];
+        values = std::make_shared<const std::vector<int64_t>>(std::move(labelValues));
+        return;
+    }
+    checkTableSize(length);
+    values = std::make_shared<const std::vector<int64_t>>(std::move(labelValues));
+    const auto& v = *values;
+    table = std::make_shared<const PositionTable>(
+        length, [&v](size_t i) { return hashInt64(v[i]); }, [&v](size_t i, size_t j) { return v[i] == v[j]; });
+    for (size_t i = 0; i < length && unique; ++i) unique = find(v[i]) == i;
+}
+
+size_t Int64Index::find(const std::string& label) const {
+    long long v = 0;
+    if (!parseIntegerLabel(label, v)) return length;
+    return find(static_cast<int64_t>(v));
+}
+
+size_t Int64Index::find(int64_t value) const {
+    if (sorted) {
+        const int64_t* begin = data();
+        const int64_t* it = std::lower_bound(begin, begin + length, value);
+        return (it != begin + length && *it == value) ? static_cast<size_t>(it - begin) : length;
+    }
+    size_t found = length;
+    const auto& v = *values;
+    table->probe(hashInt64(value), [&](size_t first) { return v[first] == value; }, [&](size_t pos) {
+        if (pos < offset) return false;
+        if (pos < offset + length) found = pos - offset;
+        return true;
+    });
+    return found;
+}
+
+std::vector<size_t> Int64Index::positions(int64_t value) const {
+    std::vector<size_t> result;
+    if (sorted) {
+        const int64_t* begin = data();
+        auto [lo, hi] = std::equal_range(begin, begin + length, value);
+        for (const int64_t* it = lo; it != hi; ++it) result.push_back(static_cast<size_t>(it - begin));
+        return result;
+    }
+    const auto& v = *values;
+    table->probe(hashInt64(value), [&](size_t first) { return v[first] == value; }, [&](size_t pos) {
+        if (pos >= offset + length) return true;
+        if (pos >= offset) result.push_back(pos - offset);
+        return false;
+    });
+    return result;
+}
+
+const std::vector<std::string>& Int64Index::getLabels() const {
+    if (!labels) {
+        auto built = std::make_shared<std::vector<std::string>>();
+        built->reserve(length);
+        for (size_t i = 0; i < length; ++i) built->push_back(at(i));
+        labels = std::move(built);
+    }
+    return *labels;
+}
+
+std::pair<size_t, size_t> Int64Index::locRange(int64_t first, int64_t last) const {
+    if (!sorted) {
+        throw std::invalid_argument("Range lookup requires a sorted index");
+    }
+    const int64_t* begin = data();
+    const int64_t* lo = std::lower_bound(begin, begin + length, first);
+    const int64_t* hi = std::upper_bound(lo, begin + length, last);
+    return {static_cast<size_t>(lo - begin), static_cast<size_t>(std::max(lo, hi) - begin)};
+}
+
+Int64Index Int64Index::slice(size_t begin, size_t end) const {
+    Int64Index sliced(*this);
+    sliced.offset = offset + begin;
+    sliced.length = end - begin;
+    sliced.labels.reset();
+    return sliced;
+}
+
+StringIndex::StringIndex(std::vector<std::string> indexLabels) {
+    checkTableSize(indexLabels.size());
+    length = indexLabels.size();
+    labels = std::make_shared<const std::vector<std::string>>(std::move(indexLabels));
+    const auto& l = *labels;
+    table = std::make_shared<const PositionTable>(
+        length, [&l](size_t i) { return hashString(l[i]); }, [&l](size_t i, size_t j) { return l[i] == l[j]; });
+    for (size_t i = 0; i < length && unique; ++i) unique = find(l[i]) == i;
+}
+
+size_t StringIndex::find(const std::string& label) const {
+    size_t found = length;
+    const auto& l = *labels;
+    table->probe(hashString(label), [&](size_t first) { return l[first] == label; }, [&](size_t pos) {
+        if (pos < offset) return false;
+        if (pos < offset + length) found = pos - offset;
+        return true;
+    });
+    return found;
+}
+
+std::vector<size_t> StringIndex::positions(const std::string& label) const {
+    std::vector<size_t> result;
+    const auto& l = *labels;
+    table->probe(hashString(label), [&](size_t first) { return l[first] == label; }, [&](size_t pos) {
+        if (pos >= offset + length) return true;
+        if (pos >= offset) result.push_back(pos - offset);
+        return false;
+    });
+    return result;
+}
+
+const std::vector<std::string>& StringIndex::getLabels() const {
+    if (!isView()) return *labels;
+    if (!viewLabels) {
+        viewLabels = std::make_shared<const std::vector<std::string>>(
+            labels->begin() + offset, labels->begin() + offset + length);
+    }
+    return *viewLabels;
+}
+
+StringIndex StringIndex::slice(size_t begin, size_t end) const {
+    StringIndex sliced(*this);
+    sliced.offset = offset + begin;
+    sliced.length = end - begin;
+    sliced.viewLabels.reset();
+    return sliced;
+}
+
+Index::Index(size_t size) : impl(RangeIndex(0, static_cast<long long>(size))) {}
+
+Index::Index(const std::vector<std::string>& labels) : impl(StringIndex(labels)) {}
+
+Index::Index(RangeIndex range) : impl(std::move(range)) {}
+
+Index::Index(Int64Index values) : impl(std::move(values)) {}
+
+Index::Index(StringIndex labels) : impl(std::move(labels)) {}
+
+size_t Index::size() const {
+    return std::visit([](const auto& kind) { return kind.size(); }, impl);
+}
+
+std::string Index::at(size_t pos) const {
+    if (pos >= size()) {
         throw std::out_of_range("Index position out of range: " + std::to_string(pos));
     }
-    return labels[pos];
+    return std::visit([pos](const auto& kind) -> std::string { return kind.at(pos); }, impl);
 }
 
 size_t Index::at(const std::string& label) const {
-    auto it = labelToPos.find(label);
-    if (it == labelToPos.end()) {
+    size_t pos = std::visit([&label](const auto& kind) { return kind.find(label); }, impl);
+    if (pos == size()) {
         throw std::out_of_range("Index label not found: " + label);
     }
-    return it->second;
+    return pos;
 }
 
 bool Index::contains(const std::string& label) const {
-    return labelToPos.find(label) != labelToPos.end();
+    return std::visit([&label](const auto& kind) { return kind.find(label) != kind.size(); }, impl);
+}
+
+std::vector<size_t> Index::positions(const std::string& label) const {
+    return std::visit([&label](const auto& kind) -> std::vector<size_t> {
+        using Kind = std::decay_t<decltype(kind)>;
+        if constexpr (std::is_same_v<Kind, StringIndex>) {
+            return kind.positions(label);
+        } else if constexpr (std::is_same_v<Kind, Int64Index>) {
+            long long v = 0;
+            if (!parseIntegerLabel(label, v)) return {};
+            return kind.positions(static_cast<int64_t>(v));
+        } else {
+            size_t pos = kind.find(label);
+            if (pos == kind.size()) return {};
+            return {pos};
+        }
+    }, impl);
+}
+
+const std::vector<std::string>& Index::getLabels() const {
+    return std::visit([](const auto& kind) -> const std::vector<std::string>& { return kind.getLabels(); }, impl);
+}
+
+std::pair<size_t, size_t> Index::locRange(long long first, long long last) const {
+    return std::visit([first, last](const auto& kind) -> std::pair<size_t, size_t> {
+        using Kind = std::decay_t<decltype(kind)>;
+        if constexpr (std::is_same_v<Kind, StringIndex>) {
+            throw std::invalid_argument("Range lookup requires an integer index");
+        } else {
+            return kind.locRange(first, last);
+        }
+    }, impl);
 }
 
 Index Index::slice(size_t start, size_t end) const {
-    if (start > end || end > labels.size()) {
+    if (start > end || end > size()) {
         throw std::out_of_range("Invalid index slice range");
     }
-    std::vector<std::string> slicedLabels;
-    slicedLabels.reserve(end - start);
-    for (size_t i = start; i < end; ++i) {
-        slicedLabels.push_back(labels[i]);
-    }
-    return Index(slicedLabels);
+    return std::visit([start, end](const auto& kind) { return Index(kind.slice(start, end)); }, impl);
 }
 
 Index Index::take(const std::vector<size_t>& positions) const {
-    std::vector<std::string> takenLabels;
-    takenLabels.reserve(positions.size());
     for (size_t pos : positions) {
-        if (pos >= labels.size()) {
+        if (pos >= size()) {
             throw std::out_of_range("Index position out of range: " + std::to_string(pos));
         }
-        takenLabels.push_back(labels[pos]);
     }
-    return Index(takenLabels);
+
+    return std::visit([&positions](const auto& kind) -> Index {
+        using Kind = std::decay_t<decltype(kind)>;
+        if constexpr (std::is_same_v<Kind, StringIndex>) {
+            std::vector<std::string> taken;
+            taken.reserve(positions.size());
+            for (size_t pos : positions) taken.push_back(kind.at(pos));
+            return Index(StringIndex(std::move(taken)));
+        } else {
+            // Evenly spaced positions of a range are themselves a range.
+            if constexpr (std::is_same_v<Kind, RangeIndex>) {
+                if (positions.empty()) return Index(RangeIndex(0, 0));
+                long long stride = positions.size() > 1
+                    ? static_cast<long long>(positions[1]) - static_cast<long long>(positions[0]) : 1;
+                bool evenlySpaced = stride != 0;
+                for (size_t i = 2; evenlySpaced && i < positions.size(); ++i) {
+                    evenlySpaced = static_cast<long long>(positions[i]) -
+                                   static_cast<long long>(positions[i - 1]) == stride;
+                }
+                if (evenlySpaced) {
+                    long long step = kind.getStep() * stride;
+                    long long first = kind.valueAt(positions[0]);
+                    return Index(RangeIndex(first, first + step * static_cast<long long>(positions.size()), step));
+                }
+            }
+            std::vector<int64_t> taken;
+            taken.reserve(positions.size());
+            for (size_t pos : positions) taken.push_back(static_cast<int64_t>(kind.valueAt(pos)));
+            return Index(Int64Index(std::move(taken)));
+        }
+    }, impl);
+}
+
+bool Index::isUnique() const {
+    return std::visit([](const auto& kind) {
+        using Kind = std::decay_t<decltype(kind)>;
+        if constexpr (std::is_same_v<Kind, RangeIndex>) return true;
+        else return kind.isUnique();
+    }, impl);
+}
+
+bool Index::isSorted() const {
+    return std::visit([](const auto& kind) {
+        using Kind = std::decay_t<decltype(kind)>;
+        if constexpr (std::is_same_v<Kind, RangeIndex>) return kind.getStep() > 0 || kind.size() <= 1;
+        else if constexpr (std::is_same_v<Kind, Int64Index>) return kind.isSorted();
+        else return false;
+    }, impl);
+}
+
+bool Index::isDefault() const {
+    const auto* range = std::get_if<RangeIndex>(&impl);
+    return range && range->getStart() == 0 && range->getStep() == 1;
 }
 
 bool Index::operator==(const Index& other) const {
-    if (labels.size() != other.labels.size()) return false;
-    for (size_t i = 0; i < labels.size(); ++i) {
-        if (labels[i] != other.labels[i]) return false;
+    if (size() != other.size()) return false;
+    const auto* a = std::get_if<RangeIndex>(&impl);
+    const auto* b = std::get_if<RangeIndex>(&other.impl);
+    if (a && b) return size() == 0 || (a->getStart() == b->getStart() && (size() == 1 || a->getStep() == b->getStep()));
+    for (size_t i = 0; i < size(); ++i) {
+        if (at(i) != other.at(i)) return false;
     }
     return true;
 }
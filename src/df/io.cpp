@@ -1,370 +1,1372 @@
 #include "df/io.hpp"
 #include "df/dataframe.hpp"
 #include "df/index.hpp"
+#include "df/csv_reader.hpp"
+#include "df/compression.hpp"
 #include <stdexcept>
-#include <fstream>
 #include <vector>
 #include <algorithm>
 #include <set>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <string_view>
+#include <cctype>
+#include <memory>
+#include <thread>
+#include <charconv>
+#include <functional>
+#include <limits>
 
 namespace df {
 
 namespace detail {
 
+// Result of type inference over a run of cells, ordered so that merging two
+// runs can promote (see promote()).
+enum class InferredType { Empty, Integer, Int64, Double, Boolean, String };
+
 struct CSVParseResult {
     std::vector<std::string> headers;
     std::vector<std::pair<std::string, ColumnData>> data;
+    // The type inferred for each column, Empty for those not inferred.
+    // Inferred string columns are left to the caller to make categorical.
+    std::vector<InferredType> types;
+    // With predicates, the data-row positions of the rows kept out of records.
+    std::vector<size_t> kept;
+    size_t records = 0;
 };
 
-static std::vector<std::string> parseCSVLine(const std::string& line, char delimiter, char quotechar) {
-    std::vector<std::string> fields;
-    std::string field;
-    bool inQuotes = false;
-
-    for (size_t i = 0; i < line.size(); ++i) {
-        char c = line[i];
-        if (inQuotes) {
-            if (c == quotechar) {
-                if (i + 1 < line.size() && line[i + 1] == quotechar) {
-                    field += quotechar;
-                    ++i;
+// std::stoi/std::stod accept leading whitespace and a '+' sign; std::from_chars
+// does not, so strip them first to parse the same cells without throwing.
+static std::string_view numericBody(std::string_view s) {
+    size_t i = 0;
+    while (i < s.size() && std::isspace(static_cast<unsigned char>(s[i]))) ++i;
+    if (i + 1 < s.size() && s[i] == '+' && s[i + 1] != '-') ++i;
+    return s.substr(i);
+}
+
+// Integers of any width, or floats; false when s is not a number or out of
+// T's range.
+template<typename T>
+static bool tryParseNumber(std::string_view s, T& out) {
+    s = numericBody(s);
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc() && end == s.data() + s.size();
+}
+
+static bool equalsIgnoreCase(std::string_view s, std::string_view lower) {
+    if (s.size() != lower.size()) return false;
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(s[i])) != lower[i]) return false;
+    }
+    return true;
+}
+
+static bool isNAToken(std::string_view val, const std::vector<std::string>& naValues) {
+    for (const auto& na : naValues) {
+        if (val == na) return true;
+    }
+    return false;
+}
+
+using CellViews = std::vector<std::string_view>;
+
+template<typename Col>
+static Col buildStrings(const CellViews& vals, const io::CSVReadOptions& options) {
+    Col col;
+    col.reserve(vals.size());
+    for (auto v : vals) {
+        if (isNAToken(v, options.naValues)) col.pushNA();
+        else col.push_back(v);
+    }
+    return col;
+}
+
+// Cells that are not numbers in T's range are NA.
+template<typename T>
+static Column<T> buildNumbers(const CellViews& vals, const io::CSVReadOptions& options) {
+    Column<T> col;
+    col.reserve(vals.size());
+    for (auto v : vals) {
+        T tmp;
+        if (v.empty() || isNAToken(v, options.naValues) || !tryParseNumber(v, tmp)) col.pushNA();
+        else col.push_back(tmp);
+    }
+    return col;
+}
+
+static ColumnData buildColumnWithType(DataType dtype, const CellViews& vals, const io::CSVReadOptions& options) {
+    switch (dtype) {
+        case DataType::Integer: return buildNumbers<int>(vals, options);
+        case DataType::Double: return buildNumbers<double>(vals, options);
+        case DataType::Int8: return buildNumbers<int8_t>(vals, options);
+        case DataType::Int16: return buildNumbers<int16_t>(vals, options);
+        case DataType::Int64: return buildNumbers<int64_t>(vals, options);
+        case DataType::UInt8: return buildNumbers<uint8_t>(vals, options);
+        case DataType::UInt16: return buildNumbers<uint16_t>(vals, options);
+        case DataType::UInt32: return buildNumbers<uint32_t>(vals, options);
+        case DataType::UInt64: return buildNumbers<uint64_t>(vals, options);
+        case DataType::Float: return buildNumbers<float>(vals, options);
+        case DataType::Boolean: {
+            BoolColumn col;
+            col.reserve(vals.size());
+            for (auto v : vals) {
+                if (v.empty() || isNAToken(v, options.naValues)) col.pushNA();
+                else if (equalsIgnoreCase(v, "true") || v == "1")  col.push_back(true);
+                else if (equalsIgnoreCase(v, "false") || v == "0") col.push_back(false);
+                else col.pushNA();
+            }
+            return col;
+        }
+        case DataType::String:
+            return buildStrings<StringColumn>(vals, options);
+        case DataType::Categorical:
+            return buildStrings<CategoricalColumn>(vals, options);
+        case DataType::Timestamp: {
+            const TimestampFormat format(options.dateFormat);
+            TimestampColumn col;
+            col.reserve(vals.size());
+            for (auto v : vals) {
+                Timestamp tmp;
+                if (v.empty() || isNAToken(v, options.naValues) || !format.parse(v, tmp)) col.pushNA();
+                else col.push_back(tmp);
+            }
+            return col;
+        }
+    }
+    return buildStrings<StringColumn>(vals, options);
+}
+
+static bool tryParseBoolLabel(std::string_view s, bool& out) {
+    if (equalsIgnoreCase(s, "true")) out = true;
+    else if (equalsIgnoreCase(s, "false")) out = false;
+    else return false;
+    return true;
+}
+
+// Infers the type of a run of cells and converts them in the same pass. Each
+// cell moves the column along Empty -> Integer -> Int64 -> Double -> String
+// or Empty -> Boolean -> String and is parsed once into the column of the
+// current type; widening integers converts the values already parsed, and
+// only falling back to String goes over the cells again.
+static ColumnData inferColumn(const CellViews& values, const io::CSVReadOptions& options, InferredType& type) {
+    const size_t n = values.size();
+    IntColumn ints;
+    Int64Column longs;
+    DoubleColumn doubles;
+    BoolColumn bools;
+    type = InferredType::Empty;
+
+    for (size_t i = 0; i < n; ++i) {
+        std::string_view v = values[i];
+        bool na = v.empty() || isNAToken(v, options.naValues);
+        int intValue;
+        int64_t longValue;
+        double doubleValue;
+        bool boolValue;
+        switch (type) {
+            case InferredType::Empty:
+                if (na) break;
+                // Cells before the first value are all NA.
+                if (tryParseNumber(v, intValue)) {
+                    type = InferredType::Integer;
+                    ints = IntColumn(i);
+                    ints.reserve(n);
+                    ints.push_back(intValue);
+                } else if (tryParseNumber(v, longValue)) {
+                    type = InferredType::Int64;
+                    longs = Int64Column(i);
+                    longs.reserve(n);
+                    longs.push_back(longValue);
+                } else if (tryParseNumber(v, doubleValue)) {
+                    type = InferredType::Double;
+                    doubles = DoubleColumn(i);
+                    doubles.reserve(n);
+                    doubles.push_back(doubleValue);
+                } else if (tryParseBoolLabel(v, boolValue)) {
+                    type = InferredType::Boolean;
+                    bools = BoolColumn(i);
+                    bools.reserve(n);
+                    bools.push_back(boolValue);
                 } else {
-                    inQuotes = false;
+                    type = InferredType::String;
+                    return buildStrings<StringColumn>(values, options);
                 }
-            } else {
-                field += c;
-            }
+                break;
+            case InferredType::Integer:
+                if (na) ints.pushNA();
+                else if (tryParseNumber(v, intValue)) ints.push_back(intValue);
+                else if (tryParseNumber(v, longValue)) {
+                    type = InferredType::Int64;
+                    longs = ints.cast<int64_t>();
+                    ints = IntColumn();
+                    longs.reserve(n);
+                    longs.push_back(longValue);
+                } else if (tryParseNumber(v, doubleValue)) {
+                    type = InferredType::Double;
+                    doubles = ints.cast<double>();
+                    ints = IntColumn();
+                    doubles.reserve(n);
+                    doubles.push_back(doubleValue);
+                } else {
+                    type = InferredType::String;
+                    return buildStrings<StringColumn>(values, options);
+                }
+                break;
+            case InferredType::Int64:
+                if (na) longs.pushNA();
+                else if (tryParseNumber(v, longValue)) longs.push_back(longValue);
+                else if (tryParseNumber(v, doubleValue)) {
+                    type = InferredType::Double;
+                    doubles = longs.cast<double>();
+                    longs = Int64Column();
+                    doubles.reserve(n);
+                    doubles.push_back(doubleValue);
+                } else {
+                    type = InferredType::String;
+                    return buildStrings<StringColumn>(values, options);
+                }
+                break;
+            case InferredType::Double:
+                if (na) doubles.pushNA();
+                else if (tryParseNumber(v, doubleValue)) doubles.push_back(doubleValue);
+                else {
+                    type = InferredType::String;
+                    return buildStrings<StringColumn>(values, options);
+                }
+                break;
+            case InferredType::Boolean:
+                if (na) bools.pushNA();
+                else if (tryParseBoolLabel(v, boolValue)) bools.push_back(boolValue);
+                else {
+                    type = InferredType::String;
+                    return buildStrings<StringColumn>(values, options);
+                }
+                break;
+            case InferredType::String:
+                break;
+        }
+    }
+
+    switch (type) {
+        case InferredType::Integer: return ints;
+        case InferredType::Int64: return longs;
+        case InferredType::Double: return doubles;
+        case InferredType::Boolean: return bools;
+        default: return DoubleColumn(n);
+    }
+}
+
+// The type inferColumn() would give the union of two runs of cells.
+static InferredType promote(InferredType a, InferredType b) {
+    if (a == InferredType::Empty || a == b) return b;
+    if (b == InferredType::Empty) return a;
+    auto numeric = [](InferredType t) { return t >= InferredType::Integer && t <= InferredType::Double; };
+    return numeric(a) && numeric(b) ? std::max(a, b) : InferredType::String;
+}
+
+// Whether a column inferred as from widens to to without its cells: all-NA
+// runs and integers are converted in place, anything else is rebuilt from
+// the cells as strings.
+static bool widensInPlace(InferredType from, InferredType to) {
+    if (from == to) return true;
+    if (from == InferredType::Integer) return to == InferredType::Int64 || to == InferredType::Double;
+    if (from == InferredType::Int64) return to == InferredType::Double;
+    return from == InferredType::Empty && to != InferredType::String;
+}
+
+static ColumnData widenInferred(ColumnData column, InferredType from, InferredType to) {
+    if (from == to) return column;
+    size_t rows = std::visit([](const auto& col) { return col.size(); }, column);
+    switch (to) {
+        case InferredType::Integer:
+            return IntColumn(rows);
+        case InferredType::Int64:
+            if (from == InferredType::Integer) return std::get<IntColumn>(column).cast<int64_t>();
+            return Int64Column(rows);
+        case InferredType::Double:
+            if (from == InferredType::Integer) return std::get<IntColumn>(column).cast<double>();
+            if (from == InferredType::Int64) return std::get<Int64Column>(column).cast<double>();
+            return DoubleColumn(rows);
+        case InferredType::Boolean:
+            return BoolColumn(rows);
+        default:
+            throw std::logic_error("Inferred column cannot be widened in place.");
+    }
+}
+
+// The narrowest of Int8, Int16, Int32 and Int64 holding every value of ints.
+template<typename T>
+static ColumnData narrowIntegers(const Column<T>& ints) {
+    int64_t lo = 0, hi = 0;
+    ints.forEachValid([&](size_t, T v) {
+        lo = std::min<int64_t>(lo, v);
+        hi = std::max<int64_t>(hi, v);
+    });
+    auto holds = [&](auto type) {
+        using N = decltype(type);
+        return lo >= std::numeric_limits<N>::min() && hi <= std::numeric_limits<N>::max();
+    };
+    if (holds(int8_t{})) return ints.template cast<int8_t>();
+    if (holds(int16_t{})) return ints.template cast<int16_t>();
+    if constexpr (!std::is_same_v<T, int>) {
+        if (holds(int{})) return ints.template cast<int>();
+    }
+    return ints;
+}
+
+// strings as timestamps, or nothing when a value does not parse.
+static std::optional<TimestampColumn> parseTimestamps(const StringColumn& strings, const io::CSVReadOptions& options) {
+    const TimestampFormat format(options.dateFormat);
+    std::vector<Timestamp> times(strings.size());
+    for (size_t i = 0; i < strings.size(); ++i) {
+        if (!strings.isNA(i) && !format.parse(strings.value(i), times[i])) return std::nullopt;
+    }
+    return TimestampColumn(std::move(times), strings.validity());
+}
+
+// With narrowIntegers, inferred integer columns take the narrowest type that
+// holds them. With parseDates, inferred string columns whose values all parse
+// as timestamps become timestamp columns; of the rest, those with few
+// distinct values become categorical.
+static ColumnData finishInferred(ColumnData column, const io::CSVReadOptions& options) {
+    if (options.narrowIntegers) {
+        if (const auto* ints = std::get_if<IntColumn>(&column)) return narrowIntegers(*ints);
+        if (const auto* longs = std::get_if<Int64Column>(&column)) return narrowIntegers(*longs);
+    }
+    const auto* strings = std::get_if<StringColumn>(&column);
+    if (!strings) return column;
+    size_t nonNA = strings->size() - strings->nullCount();
+    if (options.parseDates && nonNA > 0) {
+        if (auto times = parseTimestamps(*strings, options)) return std::move(*times);
+    }
+    if (options.categoricalThreshold <= 0 || nonNA == 0) return column;
+    const double limit = options.categoricalThreshold * nonNA;
+    std::unordered_set<std::string_view> distinct;
+    for (size_t i = 0; i < strings->size(); ++i) {
+        if (strings->isNA(i)) continue;
+        distinct.insert(strings->value(i));
+        if (distinct.size() > limit) return column;
+    }
+    return CategoricalColumn(*strings);
+}
+
+static ColumnData concatColumns(std::vector<ColumnData>& parts) {
+    if (parts.size() == 1) return std::move(parts[0]);
+    return std::visit([&parts](auto& first) -> ColumnData {
+        using Col = std::decay_t<decltype(first)>;
+        if constexpr (std::is_same_v<Col, EncodedColumn>) {
+            throw std::logic_error("Parsed columns are never encoded.");
         } else {
-            if (c == quotechar) {
-                inQuotes = true;
-            } else if (c == delimiter) {
-                fields.push_back(field);
-                field.clear();
-            } else {
-                field += c;
+            size_t rows = 0, bytes = 0;
+            for (const auto& part : parts) {
+                rows += std::get<Col>(part).size();
+                if constexpr (std::is_same_v<Col, StringColumn>) bytes += std::get<Col>(part).numBytes();
             }
+            Col result = std::move(first);
+            result.reserve(rows);
+            if constexpr (std::is_same_v<Col, StringColumn>) result.reserveBytes(bytes);
+            for (size_t i = 1; i < parts.size(); ++i) result.append(std::get<Col>(parts[i]));
+            return result;
+        }
+    }, parts[0]);
+}
+
+// A ColumnPredicate bound to its field position, with its bounds reduced to
+// what a cell is compared as.
+struct RowFilter {
+    enum class Kind { None, Integer, Number, Flag, Text, Time };
+    struct Bound {
+        Kind kind = Kind::None;
+        int64_t integer = 0;
+        double number = 0;
+        bool flag = false;
+        std::string text;
+        Timestamp time;
+    };
+
+    size_t position;
+    io::ColumnPredicate::Op op;
+    Bound lower;
+    Bound upper;
+    TimestampFormat dates; // how cells compared with a Time bound are parsed
+};
+
+template<typename T>
+static RowFilter::Bound boundOf(const T& value) {
+    RowFilter::Bound bound;
+    if constexpr (std::is_same_v<T, bool>) {
+        bound.kind = RowFilter::Kind::Flag;
+        bound.flag = value;
+    } else if constexpr (std::is_integral_v<T>) {
+        // Integers compare exactly with integer cells, past where doubles
+        // lose precision.
+        if (!std::is_signed_v<T> && static_cast<uint64_t>(value) > std::numeric_limits<int64_t>::max()) {
+            bound.kind = RowFilter::Kind::Number;
+            bound.number = static_cast<double>(value);
+        } else {
+            bound.kind = RowFilter::Kind::Integer;
+            bound.integer = static_cast<int64_t>(value);
         }
+    } else if constexpr (std::is_floating_point_v<T>) {
+        bound.kind = RowFilter::Kind::Number;
+        bound.number = static_cast<double>(value);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        bound.kind = RowFilter::Kind::Text;
+        bound.text = value;
+    } else if constexpr (std::is_same_v<T, Timestamp>) {
+        bound.kind = RowFilter::Kind::Time;
+        bound.time = value;
+    } else if constexpr (!std::is_same_v<T, NA>) {
+        if (!value.isNA()) return boundOf(value.valueUnsafe());
     }
-    fields.push_back(field);
-    return fields;
+    return bound;
 }
 
-static bool hasUnclosedQuote(const std::string& line, char quotechar) {
-    bool inQuotes = false;
-    for (size_t i = 0; i < line.size(); ++i) {
-        if (line[i] == quotechar) {
-            if (inQuotes && i + 1 < line.size() && line[i + 1] == quotechar) {
-                ++i;
-            } else {
-                inQuotes = !inQuotes;
-            }
+static std::vector<RowFilter> compileFilters(const std::vector<std::string>& headers, const io::CSVReadOptions& options) {
+    using Op = io::ColumnPredicate::Op;
+    std::vector<RowFilter> filters;
+    for (const auto& predicate : options.where) {
+        auto it = std::find(headers.begin(), headers.end(), predicate.column);
+        if (it == headers.end()) {
+            throw std::invalid_argument("Predicate on unknown column: " + predicate.column);
+        }
+        RowFilter filter;
+        filter.position = static_cast<size_t>(it - headers.begin());
+        filter.op = predicate.op;
+        filter.lower = std::visit([](const auto& v) { return boundOf(v); }, predicate.value);
+        filter.upper = std::visit([](const auto& v) { return boundOf(v); }, predicate.upper);
+        if (filter.lower.kind == RowFilter::Kind::Time || filter.upper.kind == RowFilter::Kind::Time) {
+            filter.dates = TimestampFormat(options.dateFormat);
+        }
+        bool needsValue = predicate.op != Op::IsNA && predicate.op != Op::NotNA;
+        if ((needsValue && filter.lower.kind == RowFilter::Kind::None) ||
+            (predicate.op == Op::Between && filter.upper.kind == RowFilter::Kind::None)) {
+            throw std::invalid_argument("Predicate on column " + predicate.column + " has no value.");
         }
+        filters.push_back(std::move(filter));
     }
-    return inQuotes;
+    return filters;
 }
 
-static bool tryParseInt(const std::string& s, int& out) {
-    if (s.empty()) return false;
-    try {
-        size_t pos;
-        out = std::stoi(s, &pos);
-        return pos == s.size();
-    } catch (...) {
-        return false;
+// Orders cell against bound: -1, 0 or 1, or 2 when they do not compare.
+static int compareCell(std::string_view cell, const RowFilter::Bound& bound, const TimestampFormat& dates) {
+    switch (bound.kind) {
+        case RowFilter::Kind::Integer: {
+            int64_t i;
+            if (tryParseNumber(cell, i)) return i < bound.integer ? -1 : i > bound.integer ? 1 : 0;
+            double x;
+            if (!tryParseNumber(cell, x)) return 2;
+            const double b = static_cast<double>(bound.integer);
+            return x < b ? -1 : x > b ? 1 : x == b ? 0 : 2;
+        }
+        case RowFilter::Kind::Number: {
+            double x;
+            if (!tryParseNumber(cell, x)) return 2;
+            return x < bound.number ? -1 : x > bound.number ? 1 : x == bound.number ? 0 : 2;
+        }
+        case RowFilter::Kind::Flag: {
+            bool x;
+            if (cell == "1") x = true;
+            else if (cell == "0") x = false;
+            else if (!tryParseBoolLabel(cell, x)) return 2;
+            return x == bound.flag ? 0 : x ? 1 : -1;
+        }
+        case RowFilter::Kind::Text: {
+            int c = cell.compare(bound.text);
+            return c < 0 ? -1 : c > 0 ? 1 : 0;
+        }
+        case RowFilter::Kind::Time: {
+            Timestamp x;
+            if (!dates.parse(cell, x)) return 2;
+            return x < bound.time ? -1 : x > bound.time ? 1 : 0;
+        }
+        case RowFilter::Kind::None:
+            break;
     }
+    return 2;
 }
 
-static bool tryParseDouble(const std::string& s, double& out) {
-    if (s.empty()) return false;
-    try {
-        size_t pos;
-        out = std::stod(s, &pos);
-        return pos == s.size();
-    } catch (...) {
-        return false;
+static bool passes(const RowFilter& filter, std::string_view cell, const io::CSVReadOptions& options) {
+    using Op = io::ColumnPredicate::Op;
+    bool na = cell.empty() || isNAToken(cell, options.naValues);
+    if (filter.op == Op::IsNA) return na;
+    if (filter.op == Op::NotNA) return !na;
+    int c = na ? 2 : compareCell(cell, filter.lower, filter.dates);
+    switch (filter.op) {
+        case Op::Equal: return c == 0;
+        case Op::NotEqual: return c != 0;
+        case Op::Less: return c == -1;
+        case Op::LessEqual: return c == -1 || c == 0;
+        case Op::Greater: return c == 1;
+        case Op::GreaterEqual: return c == 0 || c == 1;
+        case Op::Between: {
+            if (c != 0 && c != 1) return false;
+            int u = compareCell(cell, filter.upper, filter.dates);
+            return u == -1 || u == 0;
+        }
+        default: return false;
     }
 }
 
-static bool isNAToken(const std::string& val, const std::vector<std::string>& naValues) {
-    for (const auto& na : naValues) {
-        if (val == na) return true;
+// The tokenizer projection for keeping the fields at positions and testing
+// filters: the kept fields first, then any filtered field not among them.
+// slots[i] is where the field of filters[i] lands.
+static std::vector<size_t> filterProjection(std::vector<size_t> positions, const std::vector<RowFilter>& filters,
+                                            std::vector<size_t>& slots) {
+    slots.clear();
+    for (const auto& filter : filters) {
+        auto it = std::find(positions.begin(), positions.end(), filter.position);
+        slots.push_back(static_cast<size_t>(it - positions.begin()));
+        if (it == positions.end()) positions.push_back(filter.position);
     }
-    return false;
+    return positions;
+}
+
+static bool passesAll(const std::vector<RowFilter>& filters, const std::vector<size_t>& slots,
+                      const std::vector<std::string_view>& row, const io::CSVReadOptions& options) {
+    for (size_t f = 0; f < filters.size(); ++f) {
+        if (!passes(filters[f], row[slots[f]], options)) return false;
+    }
+    return true;
+}
+
+// A run of whole records, tokenized and converted on its own thread. While
+// tokenized, its cells point into the input or the tokenizer's decoded fields.
+struct CSVChunk {
+    std::string_view text;
+    std::string buffer; // the text, when it is not a view of the mapped file
+    std::optional<size_t> maxRecords;
+    std::unique_ptr<CSVTokenizer> tokenizer;
+    std::vector<CellViews> cells;
+    std::vector<ColumnData> columns;
+    std::vector<InferredType> types;
+    size_t records = 0;
+    std::vector<size_t> kept; // records passing the filters, when there are any
+};
+
+// Minimum input per chunk; smaller files are not worth splitting.
+constexpr size_t minChunkBytes = 1 << 20;
+// Input per chunk when reading with lowMemory.
+constexpr size_t lowMemoryChunkBytes = 1 << 24;
+
+// Tokenizes the chunk's records, keeping the cells of the fields at positions
+// for the records that pass the filters.
+static void tokenizeChunk(CSVChunk& chunk, const std::vector<size_t>& positions, const std::vector<RowFilter>& filters,
+                          const io::CSVReadOptions& options) {
+    std::vector<size_t> slots;
+    chunk.tokenizer = std::make_unique<CSVTokenizer>(chunk.text, options.delimiter, options.quotechar);
+    chunk.tokenizer->project(filterProjection(positions, filters, slots));
+    chunk.cells.assign(positions.size(), CellViews());
+    chunk.kept.clear();
+    std::vector<std::string_view> row;
+    size_t rowsRead = 0;
+    while (!(chunk.maxRecords.has_value() && rowsRead >= chunk.maxRecords.value()) && chunk.tokenizer->next(row)) {
+        if (filters.empty() || passesAll(filters, slots, row, options)) {
+            for (size_t i = 0; i < positions.size(); ++i) chunk.cells[i].push_back(row[i]);
+            if (!filters.empty()) chunk.kept.push_back(rowsRead);
+        }
+        ++rowsRead;
+    }
+    chunk.records = rowsRead;
+}
+
+static void releaseCells(CSVChunk& chunk) {
+    std::vector<CellViews>().swap(chunk.cells);
+    chunk.tokenizer.reset();
+}
+
+// Runs fn(0) .. fn(n - 1) on at most workers threads at a time.
+static void parallelWaves(size_t n, size_t workers, const std::function<void(size_t)>& fn) {
+    for (size_t first = 0; first < n; first += workers) {
+        parallelFor(std::min(workers, n - first), [&](size_t i) { fn(first + i); });
+    }
+}
+
+// Positions and names of the columns to read. Throws std::invalid_argument
+// when two columns of the header share a name.
+static void selectColumns(const std::vector<std::string>& headers, const io::CSVReadOptions& options,
+                          std::vector<size_t>& selected, std::vector<std::string>& names) {
+    std::set<std::string> seen;
+    for (const auto& header : headers) {
+        if (!seen.insert(header).second) throw std::invalid_argument("Duplicate column name: " + header);
+    }
+    std::set<std::string> useColSet(options.useCols.begin(), options.useCols.end());
+    for (size_t col = 0; col < headers.size(); ++col) {
+        if (!useColSet.empty() && !useColSet.count(headers[col])) continue;
+        selected.push_back(col);
+        names.push_back(headers[col]);
+    }
+}
+
+// The type a column is read as without inference: its dtype, or Timestamp
+// for the dateCols.
+static std::optional<DataType> requestedType(const std::string& name, const io::CSVReadOptions& options) {
+    auto it = options.dtype.find(name);
+    if (it != options.dtype.end()) return it->second;
+    if (std::find(options.dateCols.begin(), options.dateCols.end(), name) != options.dateCols.end()) {
+        return DataType::Timestamp;
+    }
+    return std::nullopt;
 }
 
+// Cells are views into the input (or the tokenizer's decoded fields),
+// converted straight into typed columns and then dropped. Only the selected
+// fields are decoded; the rest are skipped by the tokenizer.
+static void convertChunk(CSVChunk& chunk, const std::vector<size_t>& selected, const std::vector<std::string>& names,
+                         const std::vector<RowFilter>& filters, const io::CSVReadOptions& options) {
+    tokenizeChunk(chunk, selected, filters, options);
+    chunk.types.assign(selected.size(), InferredType::Empty);
+    for (size_t i = 0; i < selected.size(); ++i) {
+        const CellViews& cells = chunk.cells[i];
+        std::optional<DataType> requested = requestedType(names[i], options);
+        if (requested) chunk.columns.push_back(buildColumnWithType(*requested, cells, options));
+        else if (!options.inferTypes) chunk.columns.push_back(buildStrings<StringColumn>(cells, options));
+        else chunk.columns.push_back(inferColumn(cells, options, chunk.types[i]));
+    }
+    releaseCells(chunk);
+}
+
+static std::vector<InferredType> promoteChunks(const std::vector<CSVChunk>& chunks, size_t numSelected) {
+    std::vector<InferredType> columnTypes(numSelected, InferredType::Empty);
+    for (const auto& chunk : chunks) {
+        for (size_t i = 0; i < numSelected; ++i) columnTypes[i] = promote(columnTypes[i], chunk.types[i]);
+    }
+    return columnTypes;
+}
+
+// Widens the chunk's columns that inferred a narrower type than the column
+// as a whole, and returns those that must be tokenized again as strings.
+static std::vector<size_t> widenChunk(CSVChunk& chunk, const std::vector<InferredType>& columnTypes) {
+    std::vector<size_t> rebuilt;
+    for (size_t i = 0; i < columnTypes.size(); ++i) {
+        if (widensInPlace(chunk.types[i], columnTypes[i])) {
+            chunk.columns[i] = widenInferred(std::move(chunk.columns[i]), chunk.types[i], columnTypes[i]);
+        } else {
+            rebuilt.push_back(i);
+        }
+    }
+    return rebuilt;
+}
+
+static void rebuildChunk(CSVChunk& chunk, const std::vector<size_t>& rebuilt, const std::vector<size_t>& selected,
+                         const std::vector<RowFilter>& filters, const io::CSVReadOptions& options) {
+    std::vector<size_t> positions;
+    for (size_t i : rebuilt) positions.push_back(selected[i]);
+    tokenizeChunk(chunk, positions, filters, options);
+    for (size_t k = 0; k < rebuilt.size(); ++k) {
+        chunk.columns[rebuilt[k]] = buildStrings<StringColumn>(chunk.cells[k], options);
+    }
+    releaseCells(chunk);
+}
+
+static bool isInferred(const std::string& name, const io::CSVReadOptions& options) {
+    return options.inferTypes && !requestedType(name, options);
+}
+
+static void assembleChunks(std::vector<CSVChunk>& chunks, const std::vector<std::string>& names,
+                           const std::vector<InferredType>& columnTypes, const io::CSVReadOptions& options,
+                           CSVParseResult& result) {
+    for (size_t i = 0; i < names.size(); ++i) {
+        std::vector<ColumnData> parts;
+        parts.reserve(chunks.size());
+        for (auto& chunk : chunks) parts.push_back(std::move(chunk.columns[i]));
+        result.data.emplace_back(names[i], concatColumns(parts));
+        result.types.push_back(isInferred(names[i], options) ? columnTypes[i] : InferredType::Empty);
+    }
+
+    for (const auto& chunk : chunks) {
+        for (size_t k : chunk.kept) result.kept.push_back(result.records + k);
+        result.records += chunk.records;
+    }
+    result.headers = names;
+}
+
+static CSVParseResult parseCompressedCSV(const std::string& filename, const io::CSVReadOptions& options);
+
 CSVParseResult parseCSV(const std::string& filename, const io::CSVReadOptions& options) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + filename);
+    if (resolveCompression(filename, options.compression, true) != io::Compression::None) {
+        return parseCompressedCSV(filename, options);
     }
+    MappedFile file(filename, options.memoryMap);
+    CSVTokenizer tokenizer(file.view(), options.delimiter, options.quotechar);
 
     CSVParseResult result;
-    std::string line;
+    std::vector<std::string_view> fields;
 
+    if (!tokenizer.next(fields)) return result;
     if (options.header) {
-        if (!std::getline(file, line)) return result;
-        if (!line.empty() && line.back() == '\r') line.pop_back();
-        result.headers = parseCSVLine(line, options.delimiter, options.quotechar);
+        for (auto f : fields) result.headers.emplace_back(f);
     } else {
-        std::streampos startPos = file.tellg();
-        if (!std::getline(file, line)) return result;
-        if (!line.empty() && line.back() == '\r') line.pop_back();
-        auto fields = parseCSVLine(line, options.delimiter, options.quotechar);
         for (size_t i = 0; i < fields.size(); ++i) {
             result.headers.push_back(std::to_string(i));
         }
-        file.seekg(startPos);
+        tokenizer.rewind();
     }
 
     for (size_t i = 0; i < options.skipRows; ++i) {
-        if (!std::getline(file, line)) break;
+        if (!tokenizer.next(fields)) break;
     }
 
-    std::map<std::string, std::vector<std::string>> rawData;
-    for (const auto& header : result.headers) rawData[header] = {};
+    std::vector<size_t> selected;
+    std::vector<std::string> headersToProcess;
+    selectColumns(result.headers, options, selected, headersToProcess);
+    const size_t numSelected = selected.size();
+    const std::vector<RowFilter> filters = compileFilters(result.headers, options);
 
-    size_t rowsRead = 0;
-    while (std::getline(file, line)) {
-        if (options.nRows.has_value() && rowsRead >= options.nRows.value()) break;
-        if (!line.empty() && line.back() == '\r') line.pop_back();
+    // Split the data at record boundaries, one chunk per thread, or into
+    // chunks of bounded size converted a few at a time with lowMemory. A row
+    // limit is read sequentially.
+    const std::string_view data = file.view().substr(tokenizer.offset());
+    size_t threads = options.numThreads == 0 ? std::thread::hardware_concurrency() : options.numThreads;
+    threads = std::min(std::max<size_t>(threads, 1), std::max<size_t>(data.size() / minChunkBytes, 1));
+    size_t numChunks = threads;
+    if (options.lowMemory) numChunks = std::max(numChunks, data.size() / lowMemoryChunkBytes);
+    if (options.nRows.has_value()) threads = numChunks = 1;
+    const std::vector<size_t> bounds = splitRecords(data, numChunks, options.quotechar, threads);
+
+    std::vector<CSVChunk> chunks(bounds.size() - 1);
+    parallelWaves(chunks.size(), threads, [&](size_t c) {
+        CSVChunk& chunk = chunks[c];
+        chunk.text = data.substr(bounds[c], bounds[c + 1] - bounds[c]);
+        chunk.maxRecords = options.nRows;
+        convertChunk(chunk, selected, headersToProcess, filters, options);
+    });
+
+    // Chunks that inferred a narrower type than the column as a whole are
+    // widened to it; columns that become strings are tokenized again.
+    const std::vector<InferredType> columnTypes = promoteChunks(chunks, numSelected);
+    parallelWaves(chunks.size(), threads, [&](size_t c) {
+        std::vector<size_t> rebuilt = widenChunk(chunks[c], columnTypes);
+        if (!rebuilt.empty()) rebuildChunk(chunks[c], rebuilt, selected, filters, options);
+    });
+
+    assembleChunks(chunks, headersToProcess, columnTypes, options, result);
+    return result;
+}
+
+// Reads a file block by block and hands out whole records. Only records not
+// yet handed out, plus at most one partial record, are buffered.
+class CSVStream {
+private:
+    InputStream input;
+    std::string buffer;
+    char delimiter;
+    char quotechar;
+    RecordScan scan;
+    size_t complete = 0;  // end of the last whole record in buffer
+    size_t records = 0;   // whole records in buffer[0, complete)
+    size_t consumed = 0;  // buffer[0, consumed) has been handed out
+    size_t consumedRecords = 0;
+    bool eof = false;
+    std::unique_ptr<CSVTokenizer> tokenizer;
+    std::vector<size_t> projection;
+    bool projected = false;
+
+    bool readBlock() {
+        if (eof) return false;
+        size_t old = buffer.size();
+        buffer.resize(old + minChunkBytes);
+        buffer.resize(old + input.read(&buffer[old], minChunkBytes));
+        if (buffer.size() == old) {
+            // A last record without a line break ends at the end of the file.
+            eof = true;
+            if (buffer.size() > complete) {
+                complete = buffer.size();
+                ++records;
+            }
+            return false;
+        }
+        scanRecords(buffer, old, quotechar, scan);
+        complete = scan.end;
+        records = scan.count;
+        return true;
+    }
+
+    // Drops the text already handed out once all of it has been.
+    void discardConsumed() {
+        buffer.erase(0, consumed);
+        scan.end -= consumed;
+        scan.count -= consumedRecords;
+        complete = records = consumed = consumedRecords = 0;
+    }
+
+    CSVTokenizer& tokenizeBuffered() {
+        tokenizer = std::make_unique<CSVTokenizer>(
+            std::string_view(buffer).substr(consumed, complete - consumed), delimiter, quotechar);
+        if (projected) tokenizer->project(projection);
+        return *tokenizer;
+    }
+
+public:
+    CSVStream(const std::string& filename, io::Compression compression, char delimiter, char quotechar)
+        : input(filename, compression), delimiter(delimiter), quotechar(quotechar) {}
+
+    void project(const std::vector<size_t>& columns) {
+        projection = columns;
+        projected = true;
+    }
 
-        std::string nextLine;
-        while (hasUnclosedQuote(line, options.quotechar) && std::getline(file, nextLine)) {
-            if (!nextLine.empty() && nextLine.back() == '\r') nextLine.pop_back();
-            line += '\n' + nextLine;
+    // Hands up to maxRecords records to onRecord, reading the next block of
+    // the file once the buffered ones are used up. The fields stay valid
+    // until the next call; returns 0 at the end of the file.
+    template<typename F>
+    size_t next(size_t maxRecords, F&& onRecord) {
+        tokenizer.reset();
+        if (consumed == complete) {
+            if (eof) return 0;
+            discardConsumed();
+            while (complete == 0 && readBlock()) {}
+            if (complete == 0) return 0;
         }
+        CSVTokenizer& batch = tokenizeBuffered();
+        std::vector<std::string_view> fields;
+        size_t n = 0;
+        while (n < maxRecords && batch.next(fields)) {
+            onRecord(fields);
+            ++n;
+        }
+        consumed += batch.offset();
+        consumedRecords += n;
+        return n;
+    }
 
-        auto fields = parseCSVLine(line, options.delimiter, options.quotechar);
-        size_t col = 0;
-        for (; col < fields.size() && col < result.headers.size(); ++col) {
-            rawData[result.headers[col]].push_back(fields[col]);
+    // Reads ahead until maxRecords records not yet handed out are buffered or
+    // the file ends, so that one next() call hands them all out.
+    void fill(size_t maxRecords) {
+        tokenizer.reset();
+        if (consumed == complete && !eof) discardConsumed();
+        while (records - consumedRecords < maxRecords && readBlock()) {}
+    }
+
+    // Like next(), but leaves the records to be handed out again, and reads
+    // ahead until maxRecords are buffered or the file ends.
+    template<typename F>
+    size_t peek(size_t maxRecords, F&& onRecord) {
+        tokenizer.reset();
+        while (records - consumedRecords < maxRecords && readBlock()) {}
+        CSVTokenizer& batch = tokenizeBuffered();
+        std::vector<std::string_view> fields;
+        size_t n = 0;
+        while (n < maxRecords && batch.next(fields)) {
+            onRecord(fields);
+            ++n;
         }
-        while (col < result.headers.size()) {
-            rawData[result.headers[col]].push_back("");
-            col++;
+        return n;
+    }
+
+    // Hands out the whole records not yet handed out, reading blocks until
+    // they come to at least minBytes or the file ends; empty at its end.
+    // The same input is always split into the same runs.
+    std::string take(size_t minBytes) {
+        tokenizer.reset();
+        while (complete - consumed < minBytes && readBlock()) {}
+        std::string text = buffer.substr(consumed, complete - consumed);
+        buffer.erase(0, complete);
+        if (!eof) {
+            scan.end -= complete;
+            scan.count -= records;
         }
-        ++rowsRead;
+        complete = records = consumed = consumedRecords = 0;
+        return text;
     }
+};
 
-    std::vector<std::string> headersToProcess;
-    if (!options.useCols.empty()) {
-        std::set<std::string> useColSet(options.useCols.begin(), options.useCols.end());
-        for (const auto& header : result.headers) {
-            if (useColSet.count(header)) headersToProcess.push_back(header);
+// Reads past the header and skipped rows of stream, returning the column
+// names.
+static std::vector<std::string> readHeaders(CSVStream& stream, const io::CSVReadOptions& options) {
+    std::vector<std::string> headers;
+    auto onHeader = [&](const std::vector<std::string_view>& fields) {
+        for (size_t i = 0; i < fields.size(); ++i) {
+            headers.push_back(options.header ? std::string(fields[i]) : std::to_string(i));
         }
-    } else {
-        headersToProcess = result.headers;
-    }
-
-    auto buildColumnWithType = [&](const std::string& hdr, DataType dtype,
-                                   const std::vector<std::string>& vals) {
-        switch (dtype) {
-            case DataType::Integer: {
-                IntColumn col;
-                for (const auto& v : vals) {
-                    if (v.empty() || isNAToken(v, options.naValues)) {
-                        col.push_back(NA_VALUE);
-                    } else {
-                        int tmp;
-                        col.push_back(tryParseInt(v, tmp) ? NullableInt(tmp) : NullableInt(NA_VALUE));
-                    }
-                }
-                result.data.emplace_back(hdr, col);
-                break;
-            }
-            case DataType::Double: {
-                DoubleColumn col;
-                for (const auto& v : vals) {
-                    if (v.empty() || isNAToken(v, options.naValues)) {
-                        col.push_back(NA_VALUE);
-                    } else {
-                        double tmp;
-                        col.push_back(tryParseDouble(v, tmp) ? NullableDouble(tmp) : NullableDouble(NA_VALUE));
-                    }
-                }
-                result.data.emplace_back(hdr, col);
-                break;
-            }
-            case DataType::Boolean: {
-                BoolColumn col;
-                for (const auto& v : vals) {
-                    if (v.empty() || isNAToken(v, options.naValues)) {
-                        col.push_back(NA_VALUE);
-                    } else {
-                        std::string lower = v;
-                        std::transform(lower.begin(), lower.end(), lower.begin(),
-                                       [](unsigned char c) { return std::tolower(c); });
-                        if (lower == "true" || lower == "1")       col.push_back(true);
-                        else if (lower == "false" || lower == "0") col.push_back(false);
-                        else                                       col.push_back(NA_VALUE);
-                    }
-                }
-                result.data.emplace_back(hdr, col);
-                break;
-            }
-            case DataType::String: {
-                StringColumn col;
-                for (const auto& v : vals) {
-                    if (isNAToken(v, options.naValues)) col.push_back(NA_VALUE);
-                    else col.push_back(v);
-                }
-                result.data.emplace_back(hdr, col);
-                break;
+    };
+    if (options.header) stream.next(1, onHeader);
+    else stream.peek(1, onHeader);
+
+    for (size_t skipped = 0; skipped < options.skipRows;) {
+        size_t n = stream.next(options.skipRows - skipped, [](const std::vector<std::string_view>&) {});
+        if (n == 0) break;
+        skipped += n;
+    }
+    return headers;
+}
+
+// parseCSV() for a compressed file, which is decompressed as it is read
+// rather than mapped. Chunks of whole records are read a wave at a time and
+// dropped once converted; chunks with columns that must be rebuilt as
+// strings are read again from a second pass over the file.
+static CSVParseResult parseCompressedCSV(const std::string& filename, const io::CSVReadOptions& options) {
+    CSVParseResult result;
+    auto open = [&] {
+        auto stream = std::make_unique<CSVStream>(filename, options.compression, options.delimiter, options.quotechar);
+        result.headers = readHeaders(*stream, options);
+        return stream;
+    };
+    std::unique_ptr<CSVStream> stream = open();
+    if (result.headers.empty()) return result;
+
+    std::vector<size_t> selected;
+    std::vector<std::string> names;
+    selectColumns(result.headers, options, selected, names);
+    const std::vector<RowFilter> filters = compileFilters(result.headers, options);
+
+    size_t threads = options.numThreads == 0 ? std::thread::hardware_concurrency() : options.numThreads;
+    threads = std::max<size_t>(threads, 1);
+    if (options.nRows.has_value()) threads = 1;
+
+    // Reads the next wave of up to threads chunks into chunks[first, ...);
+    // the number read. A row limit is spread over the chunks in order.
+    std::vector<CSVChunk> chunks;
+    size_t recordsBefore = 0;
+    auto readWave = [&](size_t first) {
+        size_t n = 0;
+        for (; n < threads; ++n) {
+            if (options.nRows.has_value() && recordsBefore >= options.nRows.value()) break;
+            std::string text = stream->take(lowMemoryChunkBytes);
+            if (text.empty()) break;
+            if (first + n == chunks.size()) chunks.emplace_back();
+            CSVChunk& chunk = chunks[first + n];
+            chunk.buffer = std::move(text);
+            // With a row limit there is one chunk per wave, converted before
+            // the next is read, so its record count is known here.
+            if (options.nRows.has_value()) {
+                chunk.text = chunk.buffer;
+                chunk.maxRecords = options.nRows.value() - recordsBefore;
+                convertChunk(chunk, selected, names, filters, options);
+                recordsBefore += chunk.records;
             }
         }
+        return n;
+    };
+    auto dropText = [](CSVChunk& chunk) {
+        std::string().swap(chunk.buffer);
+        chunk.text = {};
     };
 
-    for (const auto& header : headersToProcess) {
-        const auto& values = rawData[header];
-
-        auto dtypeIt = options.dtype.find(header);
-        if (dtypeIt != options.dtype.end()) {
-            buildColumnWithType(header, dtypeIt->second, values);
-            continue;
+    for (size_t first = 0;; first += threads) {
+        size_t n = readWave(first);
+        if (n == 0) break;
+        if (!options.nRows.has_value()) {
+            parallelFor(n, [&](size_t i) {
+                CSVChunk& chunk = chunks[first + i];
+                chunk.text = chunk.buffer;
+                convertChunk(chunk, selected, names, filters, options);
+            });
         }
+        for (size_t i = 0; i < n; ++i) dropText(chunks[first + i]);
+    }
 
-        if (!options.inferTypes) {
-            StringColumn col;
-            for (const auto& v : values) {
-                if (isNAToken(v, options.naValues)) col.push_back(NA_VALUE);
-                else col.push_back(v);
+    const std::vector<InferredType> columnTypes = promoteChunks(chunks, selected.size());
+    std::vector<std::vector<size_t>> rebuilt(chunks.size());
+    size_t lastRebuilt = 0;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        rebuilt[c] = widenChunk(chunks[c], columnTypes);
+        if (!rebuilt[c].empty()) lastRebuilt = c + 1;
+    }
+    if (lastRebuilt > 0) {
+        stream = open();
+        for (size_t first = 0; first < lastRebuilt; first += threads) {
+            const size_t n = std::min(threads, lastRebuilt - first);
+            for (size_t i = 0; i < n; ++i) {
+                CSVChunk& chunk = chunks[first + i];
+                chunk.buffer = stream->take(lowMemoryChunkBytes);
+                chunk.text = chunk.buffer;
             }
-            result.data.emplace_back(header, col);
-            continue;
+            parallelFor(n, [&](size_t i) {
+                size_t c = first + i;
+                if (!rebuilt[c].empty()) rebuildChunk(chunks[c], rebuilt[c], selected, filters, options);
+            });
+            for (size_t i = 0; i < n; ++i) dropText(chunks[first + i]);
         }
+    }
 
-        bool allInt = true, allDouble = true, allBool = true;
-        bool hasAnyNonNA = false;
+    assembleChunks(chunks, names, columnTypes, options, result);
+    return result;
+}
 
-        for (const auto& v : values) {
-            if (v.empty() || isNAToken(v, options.naValues)) continue;
-            hasAnyNonNA = true;
+struct CSVChunkReaderState {
+    io::CSVReadOptions options;
+    size_t chunkRows;
+    CSVStream stream;
+    std::vector<std::string> names;
+    std::vector<DataType> types;
+    std::vector<std::string> chunkNames;
+    std::vector<DataType> chunkTypes;
+    // What inference has found each inferred column to hold so far, String
+    // for categorical and timestamp columns.
+    std::vector<InferredType> inferred;
+    std::vector<RowFilter> filters;
+    std::vector<size_t> filterSlots;
+    size_t recordsRead = 0;
+
+    CSVChunkReaderState(const std::string& filename, size_t chunkRows, const io::CSVReadOptions& options)
+        : options(options), chunkRows(chunkRows),
+          stream(filename, options.compression, options.delimiter, options.quotechar) {}
+};
 
-            int tmpI; double tmpD;
-            if (!tryParseInt(v, tmpI)) allInt = false;
-            if (!tryParseDouble(v, tmpD)) allDouble = false;
+// Converts a chunk's cells of an inferred column, widening the column's type
+// when they need it: numbers along Integer -> Int64 -> Double, and anything
+// to String, as inferColumn() would over the whole file. Categorical columns
+// stay categorical; timestamp columns become strings once a cell does not
+// parse.
+static ColumnData convertInferred(CSVChunkReaderState& state, size_t i, const CellViews& cells) {
+    const io::CSVReadOptions& options = state.options;
+    DataType& type = state.types[i];
+    InferredType& current = state.inferred[i];
 
-            std::string lower = v;
-            std::transform(lower.begin(), lower.end(), lower.begin(),
-                           [](unsigned char c) { return std::tolower(c); });
-            if (lower != "true" && lower != "false") allBool = false;
+    std::optional<StringColumn> strings;
+    if (current == InferredType::String) {
+        strings = buildStrings<StringColumn>(cells, options);
+    } else {
+        InferredType found;
+        ColumnData column = inferColumn(cells, options, found);
+        InferredType wanted = promote(current, found);
+        if (wanted != InferredType::String) {
+            current = wanted;
+            type = wanted == InferredType::Integer ? DataType::Integer
+                 : wanted == InferredType::Int64 ? DataType::Int64
+                 : wanted == InferredType::Boolean ? DataType::Boolean : DataType::Double;
+            return widenInferred(std::move(column), found, wanted);
         }
+        current = InferredType::String;
+        type = DataType::String;
+        if (found == InferredType::String) strings = std::move(std::get<StringColumn>(column));
+        else strings = buildStrings<StringColumn>(cells, options);
+    }
 
-        if (!hasAnyNonNA) {
-            DoubleColumn col(values.size());
-            result.data.emplace_back(header, col);
-        } else if (allInt) {
-            IntColumn col;
-            for (const auto& v : values) {
-                if (v.empty() || isNAToken(v, options.naValues)) col.push_back(NA_VALUE);
-                else col.push_back(std::stoi(v));
-            }
-            result.data.emplace_back(header, col);
-        } else if (allDouble) {
-            DoubleColumn col;
-            for (const auto& v : values) {
-                if (v.empty() || isNAToken(v, options.naValues)) col.push_back(NA_VALUE);
-                else col.push_back(std::stod(v));
-            }
-            result.data.emplace_back(header, col);
-        } else if (allBool) {
-            BoolColumn col;
-            for (const auto& v : values) {
-                if (v.empty() || isNAToken(v, options.naValues)) {
-                    col.push_back(NA_VALUE);
-                } else {
-                    std::string lower = v;
-                    std::transform(lower.begin(), lower.end(), lower.begin(),
-                                   [](unsigned char c) { return std::tolower(c); });
-                    col.push_back(lower == "true");
+    if (type == DataType::Timestamp) {
+        if (auto times = parseTimestamps(*strings, options)) return std::move(*times);
+        type = DataType::String;
+    }
+    if (type == DataType::Categorical) return CategoricalColumn(*strings);
+    return std::move(*strings);
+}
+
+static void applyIndexCol(DataFrame& df, const io::CSVReadOptions& options) {
+    if (options.indexCol.empty() || !df.columnExists(options.indexCol)) return;
+    const auto& colData = df[options.indexCol];
+
+    std::optional<Index> intIndex = visitDecoded([](const auto& vec) -> std::optional<Index> {
+        using VecType = std::decay_t<decltype(vec)>;
+        if constexpr (isIntegerColumn<VecType>) {
+            if (vec.nullCount() > 0) return std::nullopt;
+            std::vector<int64_t> values(vec.size());
+            for (size_t i = 0; i < vec.size(); ++i) {
+                if (!std::is_signed_v<typename VecType::element_type> &&
+                    static_cast<uint64_t>(vec.value(i)) > std::numeric_limits<int64_t>::max()) {
+                    return std::nullopt;
                 }
+                values[i] = static_cast<int64_t>(vec.value(i));
             }
-            result.data.emplace_back(header, col);
-        } else {
-            StringColumn col;
-            for (const auto& v : values) {
-                if (isNAToken(v, options.naValues)) col.push_back(NA_VALUE);
-                else col.push_back(v);
+            return Index(Int64Index(std::move(values)));
+        } else if constexpr (std::is_same_v<VecType, TimestampColumn>) {
+            // Epoch nanoseconds, so time ranges keep binary-search lookups.
+            if (vec.nullCount() > 0) return std::nullopt;
+            std::vector<int64_t> values(vec.size());
+            for (size_t i = 0; i < vec.size(); ++i) values[i] = vec.value(i).nanos;
+            return Index(Int64Index(std::move(values)));
+        }
+        return std::nullopt;
+    }, colData);
+    if (intIndex) {
+        df.removeColumn(options.indexCol);
+        if (intIndex->size() > 0) df.setIndex(*intIndex);
+        return;
+    }
+
+    std::vector<std::string> indexLabels;
+
+    visitDecoded([&](const auto& vec) {
+        using VecType = std::decay_t<decltype(vec)>;
+        for (const auto& val : vec) {
+            if (val.isNA()) {
+                indexLabels.push_back("NA");
+            } else if constexpr (std::is_same_v<VecType, StringColumn> ||
+                                 std::is_same_v<VecType, CategoricalColumn>) {
+                indexLabels.push_back(val.valueUnsafe());
+            } else if constexpr (isNumberColumn<VecType>) {
+                indexLabels.push_back(std::to_string(val.valueUnsafe()));
+            } else if constexpr (std::is_same_v<VecType, BoolColumn>) {
+                indexLabels.push_back(val.valueUnsafe() ? "true" : "false");
+            } else if constexpr (std::is_same_v<VecType, TimestampColumn>) {
+                indexLabels.push_back(val.valueUnsafe().toString());
             }
-            result.data.emplace_back(header, col);
         }
+    }, colData);
+
+    df.removeColumn(options.indexCol);
+    if (!indexLabels.empty()) df.setIndex(indexLabels);
+}
+
+// A column to write, resolved once to its concrete type. Numeric columns of
+// every width are written by appendCell<Col>, which returns false for NA.
+struct CSVOutColumn {
+    const void* numbers = nullptr;
+    bool (*appendNumberAt)(std::string& out, const void* column, size_t row) = nullptr;
+    const BoolColumn* bools = nullptr;
+    const StringColumn* strings = nullptr;
+    const CategoricalColumn* categories = nullptr;
+    const TimestampColumn* times = nullptr;
+    TimestampFormat timeFormat;
+    size_t size = 0;
+};
+
+// Output is flushed once this much is buffered; threads format this many
+// rows at a time.
+constexpr size_t writeBufferBytes = 1 << 20;
+constexpr size_t writeBlockRows = 1 << 16;
+
+template<typename T>
+static void appendNumber(std::string& out, T value) {
+    char buf[64];
+    std::to_chars_result res;
+    // Doubles match what std::ostream writes by default (%g, 6 digits).
+    if constexpr (std::is_floating_point_v<T>) res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, 6);
+    else res = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, res.ptr);
+}
+
+template<typename Col>
+static bool appendCell(std::string& out, const void* column, size_t row) {
+    const Col& col = *static_cast<const Col*>(column);
+    if (col.isNA(row)) return false;
+    appendNumber(out, col.value(row));
+    return true;
+}
+
+static void appendText(std::string& out, std::string_view val, const io::CSVWriteOptions& options) {
+    const char specials[] = {options.delimiter, options.quotechar, '\n'};
+    if (!options.quoteAll && val.find_first_of(std::string_view(specials, 3)) == std::string_view::npos) {
+        out.append(val);
+        return;
+    }
+    out += options.quotechar;
+    size_t start = 0;
+    for (size_t pos; (pos = val.find(options.quotechar, start)) != std::string_view::npos; start = pos + 1) {
+        out.append(val, start, pos + 1 - start);
+        out += options.quotechar;
     }
+    out.append(val, start);
+    out += options.quotechar;
+}
 
-    result.headers = headersToProcess;
-    return result;
+// The layout a timestamp column is written in: format, or when that is
+// empty the ISO-8601 one that fits all of its values: the date alone when
+// all are midnight, else the time to the second and as many fractional
+// digits (3, 6 or 9) as any value needs.
+static TimestampFormat timestampFormatFor(const TimestampColumn& column, const std::string& format) {
+    if (!format.empty()) return TimestampFormat(format);
+    constexpr int64_t nanosPerDay = 86400LL * 1000000000;
+    bool midnight = true;
+    int digits = 0;
+    column.forEachValid([&](size_t, Timestamp t) {
+        int64_t sub = t.nanos % 1000000000;
+        if (t.nanos % nanosPerDay != 0) midnight = false;
+        if (sub % 1000 != 0) digits = 9;
+        else if (sub % 1000000 != 0) digits = std::max(digits, 6);
+        else if (sub != 0) digits = std::max(digits, 3);
+    });
+    if (midnight) return TimestampFormat("%Y-%m-%d");
+    if (digits == 0) return TimestampFormat("%Y-%m-%d %H:%M:%S");
+    return TimestampFormat("%Y-%m-%d %H:%M:%S.%" + std::to_string(digits) + "f");
 }
 
-void writeCSV(const std::string& filename, const DataFrame& df, const io::CSVWriteOptions& options) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file for writing: " + filename);
+static void formatRows(std::string& out, const std::vector<CSVOutColumn>& columns, const Index& idx,
+                       size_t begin, size_t end, const io::CSVWriteOptions& options) {
+    for (size_t row = begin; row < end; ++row) {
+        if (options.index) {
+            out += idx.at(row);
+            out += options.delimiter;
+        }
+        for (size_t col = 0; col < columns.size(); ++col) {
+            if (col > 0) out += options.delimiter;
+            const CSVOutColumn& column = columns[col];
+            if (row >= column.size) {
+                out += options.naRep;
+            } else if (column.numbers) {
+                if (!column.appendNumberAt(out, column.numbers, row)) out += options.naRep;
+            } else if (column.bools) {
+                if (column.bools->isNA(row)) out += options.naRep;
+                else out += column.bools->value(row) ? "true" : "false";
+            } else if (column.strings) {
+                if (column.strings->isNA(row)) out += options.naRep;
+                else appendText(out, column.strings->value(row), options);
+            } else if (column.times) {
+                if (column.times->isNA(row)) out += options.naRep;
+                else column.timeFormat.format(column.times->value(row), out);
+            } else {
+                if (column.categories->isNA(row)) out += options.naRep;
+                else appendText(out, column.categories->value(row), options);
+            }
+        }
+        out += options.lineTerminator;
     }
+}
 
+void writeCSV(const std::string& filename, const DataFrame& df, const io::CSVWriteOptions& options) {
     std::vector<std::string> colNames = options.columns.empty() ? df.getColumnNames() : options.columns;
+    std::vector<CSVOutColumn> columns;
+    columns.reserve(colNames.size());
+    // Encoded columns are written from decoded copies, kept here.
+    std::vector<ColumnData> decoded;
+    decoded.reserve(colNames.size());
+    for (const auto& colName : colNames) {
+        const auto* encoded = std::get_if<EncodedColumn>(&df[colName]);
+        const ColumnData& data = encoded ? decoded.emplace_back(encoded->decode()) : df[colName];
+        CSVOutColumn column;
+        visitDecoded([&column](const auto& vec) {
+            using Col = std::decay_t<decltype(vec)>;
+            if constexpr (isNumberColumn<Col>) {
+                column.numbers = &vec;
+                column.appendNumberAt = appendCell<Col>;
+            }
+        }, data);
+        column.bools = std::get_if<BoolColumn>(&data);
+        column.strings = std::get_if<StringColumn>(&data);
+        column.categories = std::get_if<CategoricalColumn>(&data);
+        column.times = std::get_if<TimestampColumn>(&data);
+        if (column.times) column.timeFormat = timestampFormatFor(*column.times, options.dateFormat);
+        column.size = std::visit([](const auto& vec) { return vec.size(); }, data);
+        columns.push_back(column);
+    }
 
-    std::string delim(1, options.delimiter);
-    std::string lineEnd(1, options.lineTerminator);
+    OutputStream file(filename, options.compression, options.compressionLevel);
 
+    std::string out;
+    out.reserve(writeBufferBytes + writeBufferBytes / 8);
     if (options.header) {
-        if (options.index) file << delim;
+        if (options.index) out += options.delimiter;
         for (size_t i = 0; i < colNames.size(); ++i) {
-            file << colNames[i];
-            if (i < colNames.size() - 1) file << delim;
+            if (i > 0) out += options.delimiter;
+            out += colNames[i];
         }
-        file << lineEnd;
+        out += options.lineTerminator;
     }
 
     const Index& idx = df.getIndex();
+    const size_t rows = df.numRows();
+    size_t threads = options.numThreads == 0 ? std::thread::hardware_concurrency() : options.numThreads;
+    threads = std::min(std::max<size_t>(threads, 1), (rows + writeBlockRows - 1) / writeBlockRows);
 
-    for (size_t row = 0; row < df.numRows(); ++row) {
-        if (options.index) file << idx.at(row) << delim;
+    if (threads <= 1) {
+        for (size_t row = 0; row < rows; ++row) {
+            formatRows(out, columns, idx, row, row + 1, options);
+            if (out.size() >= writeBufferBytes) {
+                file.write(out.data(), out.size());
+                out.clear();
+            }
+        }
+    } else {
+        // Blocks of rows are formatted a wave at a time and written in order.
+        std::vector<std::string> blocks(threads);
+        for (size_t first = 0; first < rows; first += threads * writeBlockRows) {
+            size_t count = std::min(threads, (rows - first + writeBlockRows - 1) / writeBlockRows);
+            parallelFor(count, [&](size_t b) {
+                size_t begin = first + b * writeBlockRows;
+                blocks[b].clear();
+                formatRows(blocks[b], columns, idx, begin, std::min(rows, begin + writeBlockRows), options);
+            });
+            file.write(out.data(), out.size());
+            out.clear();
+            for (size_t b = 0; b < count; ++b) file.write(blocks[b].data(), blocks[b].size());
+        }
+    }
+    file.write(out.data(), out.size());
+    file.finish();
+}
 
-        for (size_t col = 0; col < colNames.size(); ++col) {
-            const auto& colName = colNames[col];
-            const auto& colData = df[colName];
+// Joins the columns parsed from several files into one DataFrame, the way
+// parseCSV() joins its chunks: an inferred column is widened to the type it
+// takes over all files, and the files whose cells must be read again as
+// strings are, for just those columns.
+static DataFrame mergeParsed(const std::vector<std::string>& files, std::vector<CSVParseResult>& results,
+                             const io::CSVReadOptions& options, size_t workers, const std::string& sourceColumn) {
+    constexpr size_t absent = static_cast<size_t>(-1);
+    std::vector<std::string> names;
+    std::unordered_map<std::string, size_t> slots;
+    for (const auto& result : results) {
+        for (const auto& column : result.data) {
+            if (slots.emplace(column.first, names.size()).second) names.push_back(column.first);
+        }
+    }
+    // positions[f][c]: where file f has column c in its results, if it does
+    std::vector<std::vector<size_t>> positions(files.size(), std::vector<size_t>(names.size(), absent));
+    std::vector<InferredType> types(names.size(), InferredType::Empty);
+    std::vector<size_t> rows(files.size(), 0);
+    for (size_t f = 0; f < files.size(); ++f) {
+        const CSVParseResult& result = results[f];
+        for (size_t k = 0; k < result.data.size(); ++k) {
+            size_t c = slots.at(result.data[k].first);
+            positions[f][c] = k;
+            types[c] = promote(types[c], result.types[k]);
+        }
+        if (!result.data.empty()) rows[f] = std::visit([](const auto& col) { return col.size(); }, result.data[0].second);
+    }
 
-            std::visit([&](const auto& vec) {
-                using VecType = std::decay_t<decltype(vec)>;
-                if (row >= vec.size()) { file << options.naRep; return; }
+    std::vector<std::vector<size_t>> rebuilt(files.size());
+    for (size_t f = 0; f < files.size(); ++f) {
+        CSVParseResult& result = results[f];
+        for (size_t k = 0; k < result.data.size(); ++k) {
+            auto& [name, column] = result.data[k];
+            if (!isInferred(name, options)) continue;
+            InferredType to = types[slots.at(name)];
+            if (widensInPlace(result.types[k], to)) column = widenInferred(std::move(column), result.types[k], to);
+            else rebuilt[f].push_back(k);
+        }
+    }
+    parallelTasks(files.size(), workers, [&](size_t f) {
+        if (rebuilt[f].empty()) return;
+        io::CSVReadOptions strings = options;
+        strings.useCols.clear();
+        for (size_t k : rebuilt[f]) {
+            strings.useCols.push_back(results[f].data[k].first);
+            strings.dtype[results[f].data[k].first] = DataType::String;
+        }
+        CSVParseResult again = parseCSV(files[f], strings);
+        for (size_t k : rebuilt[f]) {
+            for (auto& column : again.data) {
+                if (column.first == results[f].data[k].first) results[f].data[k].second = std::move(column.second);
+            }
+        }
+    });
 
-                if constexpr (std::is_same_v<VecType, IntColumn> ||
-                              std::is_same_v<VecType, DoubleColumn>) {
-                    if (vec[row].isNA()) file << options.naRep;
-                    else file << vec[row].valueUnsafe();
-                }
-                else if constexpr (std::is_same_v<VecType, BoolColumn>) {
-                    if (vec[row].isNA()) file << options.naRep;
-                    else file << (vec[row].valueUnsafe() ? "true" : "false");
-                }
-                else if constexpr (std::is_same_v<VecType, StringColumn>) {
-                    if (vec[row].isNA()) {
-                        file << options.naRep;
-                    } else {
-                        std::string val = vec[row].valueUnsafe();
-                        bool needsQuoting = options.quoteAll ||
-                            val.find(options.delimiter) != std::string::npos ||
-                            val.find(options.quotechar) != std::string::npos ||
-                            val.find('\n') != std::string::npos;
-                        if (needsQuoting) {
-                            std::string escaped = val;
-                            std::string qc(1, options.quotechar);
-                            size_t pos = 0;
-                            while ((pos = escaped.find(options.quotechar, pos)) != std::string::npos) {
-                                escaped.insert(pos, qc);
-                                pos += 2;
-                            }
-                            file << options.quotechar << escaped << options.quotechar;
-                        } else {
-                            file << val;
-                        }
-                    }
-                }
-            }, colData);
+    DataFrame df;
+    for (size_t c = 0; c < names.size(); ++c) {
+        // Files without the column get NA rows of the type the others agree on.
+        const ColumnData* like = nullptr;
+        for (size_t f = 0; f < files.size() && !like; ++f) {
+            if (positions[f][c] != absent) like = &results[f].data[positions[f][c]].second;
+        }
+        std::vector<ColumnData> parts;
+        parts.reserve(files.size());
+        for (size_t f = 0; f < files.size(); ++f) {
+            if (positions[f][c] != absent) {
+                parts.push_back(std::move(results[f].data[positions[f][c]].second));
+            } else if (rows[f] > 0) {
+                parts.push_back(visitType([&](const auto& col) -> ColumnData {
+                    return std::decay_t<decltype(col)>(rows[f]);
+                }, *like));
+            }
+        }
+        ColumnData column = concatColumns(parts);
+        df.addColumn(names[c], isInferred(names[c], options) ? finishInferred(std::move(column), options)
+                                                             : std::move(column));
+    }
 
-            if (col < colNames.size() - 1) file << delim;
+    if (!sourceColumn.empty()) {
+        if (df.columnExists(sourceColumn)) {
+            throw std::invalid_argument("Source column is already a column of the files: " + sourceColumn);
         }
-        file << lineEnd;
+        auto dictionary = std::make_shared<CategoryDictionary>();
+        std::vector<CategoricalColumn::code_type> codes;
+        for (size_t f = 0; f < files.size(); ++f) codes.insert(codes.end(), rows[f], dictionary->insert(files[f]));
+        const size_t total = codes.size();
+        df.addColumn(sourceColumn, CategoricalColumn(std::move(codes), Bitmap(total, true), std::move(dictionary)));
     }
+    applyIndexCol(df, options);
+    return df;
 }
 
 } // namespace detail
@@ -375,35 +1377,169 @@ DataFrame readCSV(const std::string& filename, const CSVReadOptions& options) {
     auto parseResult = detail::parseCSV(filename, options);
 
     DataFrame df;
-    for (const auto& [header, colData] : parseResult.data) {
-        df.addColumn(header, colData);
-    }
-
-    if (!options.indexCol.empty() && df.columnExists(options.indexCol)) {
-        const auto& colData = df[options.indexCol];
-        std::vector<std::string> indexLabels;
-
-        std::visit([&](const auto& vec) {
-            using VecType = std::decay_t<decltype(vec)>;
-            for (const auto& val : vec) {
-                if (val.isNA()) {
-                    indexLabels.push_back("NA");
-                } else if constexpr (std::is_same_v<VecType, StringColumn>) {
-                    indexLabels.push_back(val.valueUnsafe());
-                } else if constexpr (std::is_same_v<VecType, IntColumn> ||
-                                     std::is_same_v<VecType, DoubleColumn>) {
-                    indexLabels.push_back(std::to_string(val.valueUnsafe()));
-                } else if constexpr (std::is_same_v<VecType, BoolColumn>) {
-                    indexLabels.push_back(val.valueUnsafe() ? "true" : "false");
-                }
+    for (auto& [header, colData] : parseResult.data) {
+        df.addColumn(header, detail::isInferred(header, options) ? detail::finishInferred(std::move(colData), options)
+                                                                 : std::move(colData));
+    }
+    if (!options.where.empty() && !parseResult.kept.empty() && df.numColumns() > 0) {
+        df.setIndex(Index(parseResult.records).take(parseResult.kept));
+    }
+    detail::applyIndexCol(df, options);
+    return df;
+}
+
+DataFrame readCSVMany(const std::vector<std::string>& paths, const CSVReadOptions& options,
+                      const std::string& sourceColumn) {
+    std::vector<std::string> files;
+    for (const auto& path : paths) {
+        std::vector<std::string> matches = detail::globFiles(path);
+        if (!matches.empty()) {
+            files.insert(files.end(), matches.begin(), matches.end());
+        } else if (path.find_first_of("*?[") != std::string::npos) {
+            throw std::runtime_error("No files match: " + path);
+        } else {
+            files.push_back(path); // fails to open below
+        }
+    }
+
+    size_t threads = options.numThreads == 0 ? std::thread::hardware_concurrency() : options.numThreads;
+    threads = std::max<size_t>(threads, 1);
+    const size_t workers = std::max<size_t>(std::min(threads, files.size()), 1);
+    CSVReadOptions fileOptions = options;
+    fileOptions.numThreads = std::max<size_t>(threads / workers, 1);
+
+    std::vector<detail::CSVParseResult> results(files.size());
+    detail::parallelTasks(files.size(), workers,
+                          [&](size_t f) { results[f] = detail::parseCSV(files[f], fileOptions); });
+    return detail::mergeParsed(files, results, fileOptions, workers, sourceColumn);
+}
+
+CSVChunkReader::CSVChunkReader(const std::string& filename, size_t chunkRows,
+                               const CSVReadOptions& options, size_t sampleRows)
+    : state(std::make_unique<detail::CSVChunkReaderState>(filename, chunkRows, options)) {
+    if (chunkRows == 0) {
+        throw std::invalid_argument("chunkRows must be positive.");
+    }
+    detail::CSVStream& stream = state->stream;
+    const std::vector<std::string> headers = detail::readHeaders(stream, options);
+
+    std::vector<size_t> selected;
+    detail::selectColumns(headers, options, selected, state->names);
+    state->filters = detail::compileFilters(headers, options);
+    stream.project(detail::filterProjection(selected, state->filters, state->filterSlots));
+
+    // Fix the schema from a sample of the rows, which stay buffered for the
+    // first chunk.
+    std::vector<detail::CellViews> sample(selected.size());
+    if (options.nRows.has_value()) sampleRows = std::min(sampleRows, options.nRows.value());
+    stream.peek(sampleRows, [&](const std::vector<std::string_view>& fields) {
+        if (!detail::passesAll(state->filters, state->filterSlots, fields, options)) return;
+        for (size_t i = 0; i < sample.size(); ++i) sample[i].push_back(fields[i]);
+    });
+    for (size_t i = 0; i < selected.size(); ++i) {
+        std::optional<DataType> requested = detail::requestedType(state->names[i], options);
+        DataType type = DataType::String;
+        detail::InferredType inferred = detail::InferredType::String;
+        if (requested) {
+            type = *requested;
+        } else if (options.inferTypes) {
+            ColumnData column = detail::inferColumn(sample[i], options, inferred);
+            switch (inferred) {
+                case detail::InferredType::Integer: type = DataType::Integer; break;
+                case detail::InferredType::Int64: type = DataType::Int64; break;
+                case detail::InferredType::Boolean: type = DataType::Boolean; break;
+                case detail::InferredType::String:
+                    column = detail::finishInferred(std::move(column), options);
+                    if (std::holds_alternative<CategoricalColumn>(column)) type = DataType::Categorical;
+                    if (std::holds_alternative<TimestampColumn>(column)) type = DataType::Timestamp;
+                    break;
+                default:
+                    // All-NA samples are Double, and widen from there.
+                    type = DataType::Double;
+                    inferred = detail::InferredType::Double;
+                    break;
             }
-        }, colData);
+        }
+        state->types.push_back(type);
+        state->inferred.push_back(inferred);
+        if (state->names[i] != options.indexCol) {
+            state->chunkNames.push_back(state->names[i]);
+            state->chunkTypes.push_back(type);
+        }
+    }
+}
 
-        df.removeColumn(options.indexCol);
-        if (!indexLabels.empty()) df.setIndex(indexLabels);
+CSVChunkReader::~CSVChunkReader() = default;
+
+const std::vector<std::string>& CSVChunkReader::columnNames() const {
+    return state->chunkNames;
+}
+
+const std::vector<DataType>& CSVChunkReader::columnTypes() const {
+    return state->chunkTypes;
+}
+
+bool CSVChunkReader::next(DataFrame& chunk) {
+    if (state->names.empty()) return false;
+    const CSVReadOptions& options = state->options;
+    const size_t firstRecord = state->recordsRead;
+
+    // Buffer the chunk's records so that their cells are converted together
+    // and an inferred column widens over all of them at once. When predicates
+    // drop rows and another batch has to be read, the kept cells are copied
+    // out of the stream's buffer first.
+    const size_t numColumns = state->names.size();
+    std::vector<detail::CellViews> cells(numColumns);
+    std::deque<std::string> held;
+    std::vector<size_t> kept;
+    size_t rows = 0;
+    while (rows < state->chunkRows) {
+        size_t limit = state->chunkRows - rows;
+        if (options.nRows.has_value()) limit = std::min(limit, options.nRows.value() - state->recordsRead);
+        if (limit == 0) break;
+        state->stream.fill(limit);
+        size_t n = state->stream.next(limit, [&](const std::vector<std::string_view>& fields) {
+            size_t record = state->recordsRead++;
+            if (!detail::passesAll(state->filters, state->filterSlots, fields, options)) return;
+            for (size_t i = 0; i < numColumns; ++i) cells[i].push_back(fields[i]);
+            kept.push_back(record - firstRecord);
+        });
+        if (n == 0) break;
+        const size_t batchStart = rows;
+        rows = kept.size();
+        if (rows == state->chunkRows) break;
+
+        size_t bytes = 0;
+        for (const auto& column : cells) {
+            for (size_t r = batchStart; r < rows; ++r) bytes += column[r].size();
+        }
+        std::string& copy = held.emplace_back();
+        copy.reserve(bytes);
+        for (auto& column : cells) {
+            for (size_t r = batchStart; r < rows; ++r) {
+                size_t at = copy.size();
+                copy.append(column[r]);
+                column[r] = std::string_view(copy.data() + at, column[r].size());
+            }
+        }
     }
+    if (rows == 0) return false;
 
-    return df;
+    DataFrame result;
+    for (size_t i = 0; i < numColumns; ++i) {
+        result.addColumn(state->names[i], detail::isInferred(state->names[i], options)
+                                              ? detail::convertInferred(*state, i, cells[i])
+                                              : detail::buildColumnWithType(state->types[i], cells[i], options));
+    }
+    state->chunkTypes.clear();
+    for (size_t i = 0; i < numColumns; ++i) {
+        if (state->names[i] != options.indexCol) state->chunkTypes.push_back(state->types[i]);
+    }
+    result.setIndex(Index(RangeIndex(static_cast<long long>(firstRecord), static_cast<long long>(state->recordsRead)))
+                        .take(kept));
+    detail::applyIndexCol(result, options);
+    chunk = std::move(result);
+    return true;
 }
 
 void toCSV(const DataFrame& df, const std::string& filename, const CSVWriteOptions& options) {
@@ -4,204 +4,380 @@
 #include <type_traits>
 #include <optional>
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 
 namespace {
 
-df::IntColumn boolToInt(const df::BoolColumn& boolVec) {
-    df::IntColumn result;
-    result.reserve(boolVec.size());
-    for (const auto& elem : boolVec) {
-        if (elem.isNA()) result.push_back(df::NA_VALUE);
-        else result.push_back(elem.valueUnsafe() ? 1 : 0);
+// Columns arithmetic applies to: numbers of any width, and bools as 0/1.
+template<typename Col>
+constexpr bool isArithmeticColumn = df::isNumberColumn<Col> || std::is_same_v<Col, df::BoolColumn>;
+
+// The number a fill or scalar value holds, if it holds one (bools do not).
+template<typename T>
+std::optional<T> numberAs(const df::Value& v) {
+    return std::visit([](const auto& x) -> std::optional<T> {
+        using X = std::decay_t<decltype(x)>;
+        if constexpr (std::is_arithmetic_v<X> && !std::is_same_v<X, bool>) return static_cast<T>(x);
+        else return std::nullopt;
+    }, v);
+}
+
+// Whether integer v is in the range of integer type T.
+template<typename T, typename S>
+bool fitsIn(S v) {
+    if constexpr (std::is_signed_v<S>) {
+        if (v < 0) {
+            return std::is_signed_v<T> && static_cast<int64_t>(v) >= static_cast<int64_t>(std::numeric_limits<T>::min());
+        }
     }
-    return result;
+    return static_cast<uint64_t>(v) <= static_cast<uint64_t>(std::numeric_limits<T>::max());
 }
 
-df::DoubleColumn intToDouble(const df::IntColumn& intVec) {
-    df::DoubleColumn result;
-    result.reserve(intVec.size());
-    for (const auto& elem : intVec) {
-        if (elem.isNA()) result.push_back(df::NA_VALUE);
-        else result.push_back(static_cast<double>(elem.valueUnsafe()));
+enum class ArithOp { Add, Subtract, Multiply, Divide };
+
+// Integers are added, subtracted and multiplied as unsigned, so that they
+// wrap instead of overflowing (types narrower than int would otherwise be
+// promoted to it); floats as themselves. Vector lanes, which are not
+// promoted, are the unsigned type of T's own width.
+template<typename T, bool = std::is_integral_v<T>>
+struct Wrapping {
+    using type = T;
+    using lane = T;
+};
+
+template<typename T>
+struct Wrapping<T, true> {
+    using type = std::conditional_t<(sizeof(T) < sizeof(unsigned)), unsigned, std::make_unsigned_t<T>>;
+    using lane = std::make_unsigned_t<T>;
+};
+
+// op(a, b) when it has a value; false for division by zero. Integer
+// division by -1 negates, as INT_MIN / -1 would trap.
+template<ArithOp Op, typename T>
+bool arithValue(T a, T b, T& out) {
+    using W = typename Wrapping<T>::type;
+    if constexpr (Op == ArithOp::Add) out = static_cast<T>(static_cast<W>(a) + static_cast<W>(b));
+    else if constexpr (Op == ArithOp::Subtract) out = static_cast<T>(static_cast<W>(a) - static_cast<W>(b));
+    else if constexpr (Op == ArithOp::Multiply) out = static_cast<T>(static_cast<W>(a) * static_cast<W>(b));
+    else {
+        if (b == static_cast<T>(0)) return false;
+        if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            if (b == static_cast<T>(-1)) {
+                out = static_cast<T>(W(0) - static_cast<W>(a));
+                return true;
+            }
+        }
+        out = static_cast<T>(a / b);
+    }
+    return true;
+}
+
+// out[i] = a[i] op b[i] for i in [from, n), or a[i] op scalar when b is
+// null. Rows dividing by zero get 0; the caller marks them NA.
+template<ArithOp Op, typename T>
+inline __attribute__((always_inline)) void arithScalarLoop(const T* a, const T* b, T scalar, T* out,
+                                                           size_t from, size_t n) {
+    for (size_t i = from; i < n; ++i) {
+        if (!arithValue<Op>(a[i], b ? b[i] : scalar, out[i])) out[i] = T{};
     }
-    return result;
 }
 
-bool isIntLikeColumn(const df::ColumnData& col) {
-    return std::holds_alternative<df::IntColumn>(col) ||
-           std::holds_alternative<df::BoolColumn>(col);
+// Kernels run over whole value buffers, NA slots included, with validity
+// worked out separately a 64-row word at a time. On x86-64 they use GCC
+// vector extensions at the widest width the CPU has: AVX2 when
+// __builtin_cpu_supports reports it, else the SSE2 every x86-64 CPU has.
+// Elsewhere they are plain loops for the compiler to vectorise.
+#if defined(__GNUC__) && defined(__x86_64__)
+#define DF_HAVE_VECTOR_KERNELS 1
+
+template<typename T, size_t Bytes>
+struct VectorOf {
+    typedef T type __attribute__((vector_size(Bytes), aligned(1), may_alias));
+};
+
+template<ArithOp Op, size_t Bytes, typename T>
+inline __attribute__((always_inline)) void arithVectorLoop(const T* a, const T* b, T scalar, T* out, size_t n) {
+    size_t i = 0;
+    // There is no vector integer division; those go one at a time.
+    if constexpr (Op != ArithOp::Divide || std::is_floating_point_v<T>) {
+        using W = typename Wrapping<T>::lane;
+        using V = typename VectorOf<W, Bytes>::type;
+        constexpr size_t lanes = Bytes / sizeof(T);
+        const W* x = reinterpret_cast<const W*>(a);
+        const W* y = reinterpret_cast<const W*>(b);
+        W* z = reinterpret_cast<W*>(out);
+        const V s = V{} + static_cast<W>(scalar);
+        for (; i + lanes <= n; i += lanes) {
+            const V u = *reinterpret_cast<const V*>(x + i);
+            const V v = y ? *reinterpret_cast<const V*>(y + i) : s;
+            V& r = *reinterpret_cast<V*>(z + i);
+            if constexpr (Op == ArithOp::Add) r = u + v;
+            else if constexpr (Op == ArithOp::Subtract) r = u - v;
+            else if constexpr (Op == ArithOp::Multiply) r = u * v;
+            else r = u / v;
+        }
+    }
+    arithScalarLoop<Op>(a, b, scalar, out, i, n);
 }
 
-bool isNumericLikeColumn(const df::ColumnData& col) {
-    return isIntLikeColumn(col) || std::holds_alternative<df::DoubleColumn>(col);
+// out[i] = static_cast<To>(in[i]), lanes of the wider type at a time.
+template<size_t Bytes, typename From, typename To>
+inline __attribute__((always_inline)) void convertVectorLoop(const From* in, To* out, size_t n) {
+    constexpr size_t lanes = Bytes / std::max(sizeof(From), sizeof(To));
+    using VF = typename VectorOf<From, lanes * sizeof(From)>::type;
+    using VT = typename VectorOf<To, lanes * sizeof(To)>::type;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        *reinterpret_cast<VT*>(out + i) = __builtin_convertvector(*reinterpret_cast<const VF*>(in + i), VT);
+    }
+    for (; i < n; ++i) out[i] = static_cast<To>(in[i]);
 }
 
-df::IntColumn toIntColumn(const df::ColumnData& col) {
-    if (std::holds_alternative<df::IntColumn>(col)) return std::get<df::IntColumn>(col);
-    if (std::holds_alternative<df::BoolColumn>(col)) return boolToInt(std::get<df::BoolColumn>(col));
-    throw std::invalid_argument("Column is not int-like.");
+template<ArithOp Op, typename T>
+__attribute__((target("avx2"))) void arithAVX2(const T* a, const T* b, T scalar, T* out, size_t n) {
+    arithVectorLoop<Op, 32>(a, b, scalar, out, n);
 }
 
-df::DoubleColumn toDoubleColumn(const df::ColumnData& col) {
-    if (std::holds_alternative<df::DoubleColumn>(col)) return std::get<df::DoubleColumn>(col);
-    return intToDouble(toIntColumn(col));
+template<ArithOp Op, typename T>
+void arithSSE2(const T* a, const T* b, T scalar, T* out, size_t n) {
+    arithVectorLoop<Op, 16>(a, b, scalar, out, n);
 }
 
-std::optional<int> getIntFillValue(const df::Value& fill) {
-    if (std::holds_alternative<int>(fill)) return std::get<int>(fill);
-    if (std::holds_alternative<double>(fill)) return static_cast<int>(std::get<double>(fill));
-    return std::nullopt;
+template<typename From, typename To>
+__attribute__((target("avx2"))) void convertAVX2(const From* in, To* out, size_t n) {
+    convertVectorLoop<32>(in, out, n);
 }
 
-std::optional<double> getDoubleFillValue(const df::Value& fill) {
-    if (std::holds_alternative<double>(fill)) return std::get<double>(fill);
-    if (std::holds_alternative<int>(fill)) return static_cast<double>(std::get<int>(fill));
-    return std::nullopt;
+template<typename From, typename To>
+void convertSSE2(const From* in, To* out, size_t n) {
+    convertVectorLoop<16>(in, out, n);
 }
 
-template<typename Vec, typename Fill, typename Op>
-void applyVecOp(Vec& result, const Vec& other, std::optional<Fill> fillOpt, Op op) {
-    size_t minSize = std::min(result.size(), other.size());
-    for (size_t i = 0; i < minSize; ++i) {
-        if (!result[i].isNA() && !other[i].isNA()) {
-            op(result[i], result[i].valueUnsafe(), other[i].valueUnsafe());
-        } else if (fillOpt.has_value()) {
-            Fill f = fillOpt.value();
-            if (result[i].isNA() && other[i].isNA()) {
-                // both NA, stays NA
-            } else if (result[i].isNA()) {
-                op(result[i], f, other[i].valueUnsafe());
-            } else {
-                op(result[i], result[i].valueUnsafe(), f);
-            }
-        } else {
-            result[i] = df::NA_VALUE;
+bool haveAVX2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#endif
+
+template<ArithOp Op, typename T>
+void arith(const T* a, const T* b, T scalar, T* out, size_t n) {
+#ifdef DF_HAVE_VECTOR_KERNELS
+    if (haveAVX2()) arithAVX2<Op>(a, b, scalar, out, n);
+    else arithSSE2<Op>(a, b, scalar, out, n);
+#else
+    arithScalarLoop<Op>(a, b, scalar, out, 0, n);
+#endif
+}
+
+template<typename From, typename To>
+void convert(const From* in, To* out, size_t n) {
+#ifdef DF_HAVE_VECTOR_KERNELS
+    if (haveAVX2()) convertAVX2(in, out, n);
+    else convertSSE2(in, out, n);
+#else
+    for (size_t i = 0; i < n; ++i) out[i] = static_cast<To>(in[i]);
+#endif
+}
+
+// Bits of word k that belong to rows before n.
+uint64_t rowsBefore(size_t n, size_t k) {
+    if (n >= k * 64 + 64) return ~uint64_t(0);
+    return n <= k * 64 ? 0 : (uint64_t(1) << (n - k * 64)) - 1;
+}
+
+// Zeroes the NA slots of data, as setNA would have.
+template<typename T>
+void clearNASlots(T* data, const std::vector<uint64_t>& words, size_t n) {
+    for (size_t k = 0; k < words.size(); ++k) {
+        for (uint64_t missing = ~words[k] & rowsBefore(n, k); missing; missing &= missing - 1) {
+            data[k * 64 + static_cast<size_t>(__builtin_ctzll(missing))] = T{};
         }
     }
-    for (size_t i = minSize; i < result.size(); ++i) {
-        if (fillOpt.has_value() && !result[i].isNA()) {
-            op(result[i], result[i].valueUnsafe(), fillOpt.value());
-        } else {
-            result[i] = df::NA_VALUE;
+}
+
+std::vector<uint64_t> validityWords(const df::Bitmap& validity) {
+    std::vector<uint64_t> words(validity.numWords());
+    for (size_t k = 0; k < words.size(); ++k) words[k] = validity.wordAt(k);
+    return words;
+}
+
+// col as a column of T, sharing its buffers (or taking them, when col is
+// an rvalue) when it already is one.
+template<typename T, typename C>
+df::Column<T> toColumn(C&& col) {
+    using Col = std::decay_t<C>;
+    if constexpr (std::is_same_v<Col, df::Column<T>>) {
+        return std::forward<C>(col);
+    } else if constexpr (std::is_same_v<Col, df::BoolColumn>) {
+        return col.template cast<T>();
+    } else {
+        std::vector<T> converted(col.size());
+        convert(col.data(), converted.data(), col.size());
+        return df::Column<T>(std::move(converted), col.validity());
+    }
+}
+
+// Combines result with other row by row: NA where either side is, or
+// where the divisor is zero. With fill, a row missing on one side only
+// (or past the end of other) uses fill in its place.
+template<ArithOp Op, typename T>
+void applyVecOp(df::Column<T>& result, const df::Column<T>& other, std::optional<T> fill) {
+    const size_t n = result.size();
+    const size_t m = std::min(n, other.size());
+    const T* a = result.data();
+    const T* b = other.data();
+    std::vector<uint64_t> words(result.validity().numWords());
+    // Rows filled on one side are worked out before the kernel overwrites a.
+    std::vector<std::pair<size_t, T>> filled;
+    for (size_t k = 0; k < words.size(); ++k) {
+        const uint64_t self = result.validity().wordAt(k);
+        const uint64_t otherWord = k * 64 < m ? other.validity().wordAt(k) & rowsBefore(m, k) : 0;
+        uint64_t valid = self & otherWord;
+        if constexpr (Op == ArithOp::Divide) {
+            for (uint64_t rows = valid; rows; rows &= rows - 1) {
+                const size_t i = k * 64 + static_cast<size_t>(__builtin_ctzll(rows));
+                if (b[i] == static_cast<T>(0)) valid &= ~(uint64_t(1) << (i & 63));
+            }
+        }
+        if (fill) {
+            for (uint64_t lone = (self ^ otherWord) & rowsBefore(n, k); lone; lone &= lone - 1) {
+                const size_t i = k * 64 + static_cast<size_t>(__builtin_ctzll(lone));
+                T value;
+                const bool selfValid = (self >> (i & 63)) & 1;
+                if (arithValue<Op>(selfValid ? a[i] : *fill, selfValid ? *fill : b[i], value)) {
+                    filled.emplace_back(i, value);
+                    valid |= uint64_t(1) << (i & 63);
+                }
+            }
         }
+        words[k] = valid;
+    }
+    T* out = result.mutableData();
+    arith<Op>(out, b, T{}, out, m);
+    for (const auto& [i, value] : filled) out[i] = value;
+    clearNASlots(out, words, n);
+    result.setValidity(df::Bitmap(df::SharedBuffer<uint64_t>(std::move(words)), n));
+}
+
+// Applies op(value, scalar) to every valid slot of col: in place when col
+// owns its values, else straight into a new buffer rather than a copy.
+template<ArithOp Op, typename T>
+void applyScalarOp(df::Column<T>& col, T scalar) {
+    const size_t n = col.size();
+    if (col.sharesValues()) {
+        std::vector<T> out(n);
+        arith<Op>(col.data(), static_cast<const T*>(nullptr), scalar, out.data(), n);
+        col = df::Column<T>(std::move(out), col.validity());
+    } else {
+        T* data = col.mutableData();
+        arith<Op>(data, static_cast<const T*>(nullptr), scalar, data, n);
     }
+    if (col.nullCount() > 0) clearNASlots(col.mutableData(), validityWords(col.validity()), n);
 }
 
-template<typename Op>
-df::DataFrame applyDfDfOp(const df::DataFrame& df, const df::DataFrame& other,
-                          const df::Value& fillValue, Op op) {
-    df::DataFrame result = df;
+template<ArithOp Op>
+void frameInPlace(df::DataFrame& df, const df::DataFrame& other, const df::Value& fillValue) {
+    if (&df == &other) {
+        const df::DataFrame copy = other;
+        frameInPlace<Op>(df, copy, fillValue);
+        return;
+    }
     for (const auto& [colName, otherData] : other.getColumns()) {
         if (!df.columnExists(colName)) {
-            result.addColumn(colName, otherData);
+            df.addColumn(colName, otherData);
             continue;
         }
-        const auto& selfData = df[colName];
-
-        if (isIntLikeColumn(selfData) && isIntLikeColumn(otherData)) {
-            df::IntColumn selfVec = toIntColumn(selfData);
-            df::IntColumn otherVec = toIntColumn(otherData);
-            applyVecOp(selfVec, otherVec, getIntFillValue(fillValue), op);
-            result[colName] = df::ColumnData(selfVec);
-        } else if (isNumericLikeColumn(selfData) && isNumericLikeColumn(otherData)) {
-            df::DoubleColumn selfVec = toDoubleColumn(selfData);
-            df::DoubleColumn otherVec = toDoubleColumn(otherData);
-            applyVecOp(selfVec, otherVec, getDoubleFillValue(fillValue), op);
-            result[colName] = df::ColumnData(selfVec);
-        }
+        auto& selfData = df[colName];
+
+        // Both sides are converted to the type holding the values of each
+        // (see CommonNumber); bool with bool gives ints. The left column's
+        // buffer is reused when it keeps its type and is not shared.
+        df::visitDecodedInPlace([&](auto& selfCol) {
+            df::visitDecoded([&](const auto& otherCol) {
+                using Self = std::decay_t<decltype(selfCol)>;
+                using Other = std::decay_t<decltype(otherCol)>;
+                if constexpr (isArithmeticColumn<Self> && isArithmeticColumn<Other>) {
+                    using Common = df::CommonNumber<typename Self::element_type, typename Other::element_type>;
+                    using T = std::conditional_t<std::is_same_v<Common, bool>, int, Common>;
+                    df::Column<T> selfVec = toColumn<T>(std::move(selfCol));
+                    applyVecOp<Op>(selfVec, toColumn<T>(otherCol), numberAs<T>(fillValue));
+                    selfData = df::ColumnData(std::move(selfVec));
+                }
+            }, otherData);
+        }, selfData);
     }
-    return result;
 }
 
-template<typename Op>
-void scalarInPlace(df::DataFrame& df, const std::string& columnName,
-                   const df::Value& value, Op op) {
-    if (!df.columnExists(columnName)) {
-        throw std::out_of_range("Column does not exist.");
-    }
-    auto& colData = df[columnName];
-
-    if (std::holds_alternative<double>(value)) {
-        double val = std::get<double>(value);
-        if (std::holds_alternative<df::IntColumn>(colData)) {
-            auto& intVec = std::get<df::IntColumn>(colData);
-            df::DoubleColumn doubleVec;
-            doubleVec.reserve(intVec.size());
-            for (const auto& elem : intVec) {
-                if (elem.isNA()) {
-                    doubleVec.push_back(df::NA_VALUE);
-                } else {
-                    df::NullableDouble d;
-                    op(d, static_cast<double>(elem.valueUnsafe()), val);
-                    doubleVec.push_back(d);
-                }
-            }
-            colData = doubleVec;
+// A scalar keeps the type of the column it applies to when that holds it:
+// integers in range of an integer column, and any number for a float or
+// double column. Otherwise the column is widened to CommonNumber of the two.
+// Bool columns count as int ones when withBools is set.
+template<ArithOp Op>
+void scalarInPlace(df::ColumnData& colData, const df::Value& value, bool withBools) {
+    std::visit([&](const auto& scalar) {
+        using S = std::decay_t<decltype(scalar)>;
+        if constexpr (!std::is_arithmetic_v<S> || std::is_same_v<S, bool>) {
+            throw std::invalid_argument("Unsupported value type for arithmetic operation.");
         } else {
-            std::visit([&](auto& vec) {
-                using V = typename std::decay_t<decltype(vec)>::value_type;
-                if constexpr (std::is_same_v<V, df::NullableDouble>) {
-                    for (auto& elem : vec) {
-                        if (elem.isNA()) continue;
-                        op(elem, elem.valueUnsafe(), val);
-                    }
-                } else if constexpr (std::is_same_v<V, df::NullableBool> ||
-                                     std::is_same_v<V, df::NullableString>) {
+            df::visitDecodedInPlace([&](auto& vec) {
+                using Col = std::decay_t<decltype(vec)>;
+                if constexpr (!isArithmeticColumn<Col>) {
                     throw std::invalid_argument("Arithmetic operation not supported for non-numeric column type.");
+                } else {
+                    if (std::is_same_v<Col, df::BoolColumn> && !withBools) {
+                        throw std::invalid_argument("Arithmetic operation not supported for non-numeric column type.");
+                    }
+                    using E = typename Col::element_type;
+                    using T = std::conditional_t<std::is_same_v<E, bool>, int, E>;
+                    bool keepsType;
+                    if constexpr (std::is_floating_point_v<T>) keepsType = true;
+                    else if constexpr (std::is_floating_point_v<S>) keepsType = false;
+                    else keepsType = fitsIn<T>(scalar);
+                    if (keepsType) {
+                        if constexpr (std::is_same_v<Col, df::Column<T>>) {
+                            applyScalarOp<Op>(vec, static_cast<T>(scalar));
+                        } else {
+                            df::Column<T> ints = toColumn<T>(vec);
+                            applyScalarOp<Op>(ints, static_cast<T>(scalar));
+                            colData = std::move(ints);
+                        }
+                    } else {
+                        using R = df::CommonNumber<T, S>;
+                        df::Column<R> widened = toColumn<R>(vec);
+                        applyScalarOp<Op>(widened, static_cast<R>(scalar));
+                        colData = std::move(widened);
+                    }
                 }
             }, colData);
         }
-    } else if (std::holds_alternative<int>(value)) {
-        int val = std::get<int>(value);
-        std::visit([&](auto& vec) {
-            using V = typename std::decay_t<decltype(vec)>::value_type;
-            if constexpr (std::is_same_v<V, df::NullableInt>) {
-                for (auto& elem : vec) {
-                    if (elem.isNA()) continue;
-                    op(elem, elem.valueUnsafe(), val);
-                }
-            } else if constexpr (std::is_same_v<V, df::NullableDouble>) {
-                for (auto& elem : vec) {
-                    if (elem.isNA()) continue;
-                    op(elem, elem.valueUnsafe(), static_cast<double>(val));
-                }
-            } else if constexpr (std::is_same_v<V, df::NullableBool> ||
-                                 std::is_same_v<V, df::NullableString>) {
-                throw std::invalid_argument("Arithmetic operation not supported for non-numeric column type.");
-            }
-        }, colData);
-    } else {
-        throw std::invalid_argument("Unsupported value type for arithmetic operation.");
-    }
+    }, value);
 }
 
-template<typename InPlaceOp>
-df::DataFrame applyScalar(const df::DataFrame& df, const df::Value& value, InPlaceOp inPlaceOp) {
-    df::DataFrame result = df;
-    for (const auto& [colName, colData] : df.getColumns()) {
-        if (std::holds_alternative<df::IntColumn>(colData) ||
-            std::holds_alternative<df::DoubleColumn>(colData)) {
-            inPlaceOp(result, colName, value);
-        } else if (std::holds_alternative<df::BoolColumn>(colData)) {
-            result[colName] = boolToInt(std::get<df::BoolColumn>(colData));
-            inPlaceOp(result, colName, value);
-        }
+template<ArithOp Op>
+void scalarInPlace(df::DataFrame& df, const std::string& columnName, const df::Value& value) {
+    if (!df.columnExists(columnName)) {
+        throw std::out_of_range("Column does not exist.");
     }
-    return result;
+    scalarInPlace<Op>(df[columnName], value, false);
 }
 
-constexpr auto opAdd = [](auto& dst, auto a, auto b) { dst = a + b; };
-constexpr auto opSub = [](auto& dst, auto a, auto b) { dst = a - b; };
-constexpr auto opMul = [](auto& dst, auto a, auto b) { dst = a * b; };
-constexpr auto opDiv = [](auto& dst, auto a, auto b) {
-    if (b == 0) dst = df::NA_VALUE;
-    else dst = a / b;
-};
+// Numeric and bool columns change; the others are left as they are.
+template<ArithOp Op>
+void scalarInPlace(df::DataFrame& df, const df::Value& value) {
+    for (const auto& colName : df.getColumnNames()) {
+        auto& colData = df[colName];
+        const bool arithmetic = df::visitType([](const auto& vec) {
+            return isArithmeticColumn<std::decay_t<decltype(vec)>>;
+        }, colData);
+        if (arithmetic) scalarInPlace<Op>(colData, value, true);
+    }
+}
 
 bool valueIsZero(const df::Value& v) {
-    if (std::holds_alternative<double>(v)) return std::get<double>(v) == 0;
-    if (std::holds_alternative<int>(v)) return std::get<int>(v) == 0;
-    return false;
+    std::optional<double> number = numberAs<double>(v);
+    return number && *number == 0;
 }
 
 } // anonymous namespace
@@ -209,53 +385,101 @@ bool valueIsZero(const df::Value& v) {
 namespace df { namespace math {
 
 void addInPlace(DataFrame& df, const std::string& columnName, const Value& value) {
-    scalarInPlace(df, columnName, value, opAdd);
+    scalarInPlace<ArithOp::Add>(df, columnName, value);
 }
 
 void subtractInPlace(DataFrame& df, const std::string& columnName, const Value& value) {
-    scalarInPlace(df, columnName, value, opSub);
+    scalarInPlace<ArithOp::Subtract>(df, columnName, value);
 }
 
 void multiplyInPlace(DataFrame& df, const std::string& columnName, const Value& value) {
-    scalarInPlace(df, columnName, value, opMul);
+    scalarInPlace<ArithOp::Multiply>(df, columnName, value);
 }
 
 void divideInPlace(DataFrame& df, const std::string& columnName, const Value& value) {
     if (valueIsZero(value)) throw std::invalid_argument("Division by zero.");
-    scalarInPlace(df, columnName, value, opDiv);
+    scalarInPlace<ArithOp::Divide>(df, columnName, value);
+}
+
+void addInPlace(DataFrame& df, const DataFrame& other, const Value& fillValue) {
+    frameInPlace<ArithOp::Add>(df, other, fillValue);
+}
+
+void subtractInPlace(DataFrame& df, const DataFrame& other, const Value& fillValue) {
+    frameInPlace<ArithOp::Subtract>(df, other, fillValue);
+}
+
+void multiplyInPlace(DataFrame& df, const DataFrame& other, const Value& fillValue) {
+    frameInPlace<ArithOp::Multiply>(df, other, fillValue);
+}
+
+void divideInPlace(DataFrame& df, const DataFrame& other, const Value& fillValue) {
+    frameInPlace<ArithOp::Divide>(df, other, fillValue);
+}
+
+void addInPlace(DataFrame& df, const Value& value) {
+    scalarInPlace<ArithOp::Add>(df, value);
+}
+
+void subtractInPlace(DataFrame& df, const Value& value) {
+    scalarInPlace<ArithOp::Subtract>(df, value);
+}
+
+void multiplyInPlace(DataFrame& df, const Value& value) {
+    scalarInPlace<ArithOp::Multiply>(df, value);
+}
+
+void divideInPlace(DataFrame& df, const Value& value) {
+    if (valueIsZero(value)) throw std::invalid_argument("Division by zero.");
+    scalarInPlace<ArithOp::Divide>(df, value);
 }
 
 DataFrame add(const DataFrame& df, const DataFrame& other, const Value& fillValue) {
-    return applyDfDfOp(df, other, fillValue, opAdd);
+    DataFrame result = df;
+    addInPlace(result, other, fillValue);
+    return result;
 }
 
 DataFrame subtract(const DataFrame& df, const DataFrame& other, const Value& fillValue) {
-    return applyDfDfOp(df, other, fillValue, opSub);
+    DataFrame result = df;
+    subtractInPlace(result, other, fillValue);
+    return result;
 }
 
 DataFrame multiply(const DataFrame& df, const DataFrame& other, const Value& fillValue) {
-    return applyDfDfOp(df, other, fillValue, opMul);
+    DataFrame result = df;
+    multiplyInPlace(result, other, fillValue);
+    return result;
 }
 
 DataFrame divide(const DataFrame& df, const DataFrame& other, const Value& fillValue) {
-    return applyDfDfOp(df, other, fillValue, opDiv);
+    DataFrame result = df;
+    divideInPlace(result, other, fillValue);
+    return result;
 }
 
 DataFrame add(const DataFrame& df, const Value& value) {
-    return applyScalar(df, value, addInPlace);
+    DataFrame result = df;
+    addInPlace(result, value);
+    return result;
 }
 
 DataFrame subtract(const DataFrame& df, const Value& value) {
-    return applyScalar(df, value, subtractInPlace);
+    DataFrame result = df;
+    subtractInPlace(result, value);
+    return result;
 }
 
 DataFrame multiply(const DataFrame& df, const Value& value) {
-    return applyScalar(df, value, multiplyInPlace);
+    DataFrame result = df;
+    multiplyInPlace(result, value);
+    return result;
 }
 
 DataFrame divide(const DataFrame& df, const Value& value) {
-    if (valueIsZero(value)) throw std::invalid_argument("Division by zero.");
-    return applyScalar(df, value, divideInPlace);
+    DataFrame result = df;
+    divideInPlace(result, value);
+    return result;
 }
 
 }} // namespace df::math
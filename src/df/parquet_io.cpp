@@ -0,0 +1,1301 @@
+#include "df/io.hpp"
+#include "df/dataframe.hpp"
+#include "df/index.hpp"
+#include "df/csv_reader.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#ifdef DF_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace df {
+
+namespace detail {
+
+// Parquet: "PAR1", the column chunks of each row group as sequences of
+// pages, the FileMetaData in Thrift's compact protocol, its u32 size, "PAR1".
+//
+// Flat columns are read, with plain, dictionary (PLAIN_DICTIONARY and
+// RLE_DICTIONARY) and RLE-encoded values in v1 or v2 data pages. DATE and
+// TIMESTAMP columns become timestamp columns. Pages may
+// be uncompressed or snappy-compressed, or zstd-compressed when built with
+// -DDF_HAVE_ZSTD (and linked with -lzstd). A column named like the index
+// pandas writes becomes the index.
+constexpr char parquetMagic[4] = {'P', 'A', 'R', '1'};
+constexpr const char* parquetIndexColumn = "__index_level_0__";
+
+enum class ParquetType : int32_t {
+    Boolean = 0, Int32 = 1, Int64 = 2, Int96 = 3, Float = 4, Double = 5, ByteArray = 6, FixedLenByteArray = 7
+};
+enum class ParquetEncoding : int32_t { Plain = 0, PlainDictionary = 2, Rle = 3, RleDictionary = 8 };
+enum class ParquetCodec : int32_t { Uncompressed = 0, Snappy = 1, Zstd = 6 };
+enum class ParquetPageType : int32_t { Data = 0, Index = 1, Dictionary = 2, DataV2 = 3 };
+
+[[noreturn]] static void corruptParquet() { throw std::runtime_error("Corrupt Parquet file."); }
+
+static uint64_t readVarint(std::string_view data, size_t& pos) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= data.size()) corruptParquet();
+        uint8_t byte = static_cast<uint8_t>(data[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    corruptParquet();
+}
+
+// Reader for Thrift's compact protocol.
+class ThriftReader {
+private:
+    std::string_view data;
+    size_t pos = 0;
+    int depth = 0;
+
+    void need(size_t n) const {
+        if (data.size() - pos < n) corruptParquet();
+    }
+
+    void skipElement(uint8_t type) {
+        if (type == True || type == False) {
+            need(1);
+            ++pos;
+        } else {
+            skip(type);
+        }
+    }
+
+public:
+    enum : uint8_t {
+        Stop = 0, True = 1, False = 2, Byte = 3, I16 = 4, I32 = 5, I64 = 6, Double = 7,
+        Binary = 8, List = 9, Set = 10, Map = 11, Struct = 12
+    };
+
+    explicit ThriftReader(std::string_view input) : data(input) {}
+
+    size_t offset() const { return pos; }
+
+    int64_t integer() {
+        uint64_t v = readVarint(data, pos);
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+    int32_t i32() { return static_cast<int32_t>(integer()); }
+    int8_t byte() {
+        need(1);
+        return static_cast<int8_t>(data[pos++]);
+    }
+
+    std::string_view binary() {
+        uint64_t n = readVarint(data, pos);
+        need(n);
+        std::string_view s = data.substr(pos, n);
+        pos += n;
+        return s;
+    }
+
+    // Element count of a list or set, whose element type goes to type.
+    size_t list(uint8_t& type) {
+        need(1);
+        uint8_t header = static_cast<uint8_t>(data[pos++]);
+        type = header & 0x0f;
+        size_t n = header >> 4;
+        if (n == 15) n = readVarint(data, pos);
+        if (n > data.size() - pos) corruptParquet();
+        return n;
+    }
+
+    // Reads a struct, calling field(id, type) for each of its fields; field
+    // reads the value and returns true, or returns false to skip it.
+    template<typename F>
+    void readStruct(F&& field) {
+        if (++depth > 64) corruptParquet();
+        int16_t last = 0;
+        while (true) {
+            need(1);
+            uint8_t header = static_cast<uint8_t>(data[pos++]);
+            uint8_t type = header & 0x0f;
+            if (type == Stop) break;
+            int16_t id = (header >> 4) != 0 ? static_cast<int16_t>(last + (header >> 4)) : static_cast<int16_t>(integer());
+            last = id;
+            if (!field(id, type)) skip(type);
+        }
+        --depth;
+    }
+
+    void skip(uint8_t type) {
+        switch (type) {
+            case True:
+            case False:
+                break;
+            case Byte:
+                need(1);
+                ++pos;
+                break;
+            case I16:
+            case I32:
+            case I64:
+                readVarint(data, pos);
+                break;
+            case Double:
+                need(8);
+                pos += 8;
+                break;
+            case Binary:
+                binary();
+                break;
+            case List:
+            case Set: {
+                if (++depth > 64) corruptParquet();
+                uint8_t element;
+                size_t n = list(element);
+                for (size_t i = 0; i < n; ++i) skipElement(element);
+                --depth;
+                break;
+            }
+            case Map: {
+                if (++depth > 64) corruptParquet();
+                size_t n = readVarint(data, pos);
+                if (n > data.size() - pos) corruptParquet();
+                if (n > 0) {
+                    need(1);
+                    uint8_t types = static_cast<uint8_t>(data[pos++]);
+                    for (size_t i = 0; i < n; ++i) {
+                        skipElement(types >> 4);
+                        skipElement(types & 0x0f);
+                    }
+                }
+                --depth;
+                break;
+            }
+            case Struct:
+                readStruct([](int16_t, uint8_t) { return false; });
+                break;
+            default:
+                corruptParquet();
+        }
+    }
+};
+
+struct ParquetStatistics {
+    std::optional<std::string_view> min;
+    std::optional<std::string_view> max;
+    // min and max as written before min_value/max_value, in signed order
+    std::optional<std::string_view> legacyMin;
+    std::optional<std::string_view> legacyMax;
+    std::optional<int64_t> nullCount;
+};
+
+struct ParquetColumnChunk {
+    int32_t codec = 0;
+    int64_t numValues = 0;
+    int64_t dataPageOffset = 0;
+    int64_t dictionaryPageOffset = 0;
+    int64_t totalCompressedSize = 0;
+    ParquetStatistics statistics;
+};
+
+struct ParquetRowGroup {
+    std::vector<ParquetColumnChunk> columns;
+    int64_t numRows = 0;
+};
+
+struct ParquetSchemaElement {
+    int32_t type = -1;
+    int32_t repetition = 0; // REQUIRED, OPTIONAL, REPEATED
+    std::string name;
+    int32_t numChildren = 0;
+    int32_t convertedType = -1;
+    int16_t logicalType = 0; // LogicalType union member, 0 if none
+    bool logicalSigned = true;
+    int8_t logicalBitWidth = 0; // of an INTEGER logical type
+    int16_t timeUnit = 0; // TimeUnit union member of a TIMESTAMP
+};
+
+struct ParquetPageHeader {
+    int32_t type = -1;
+    int32_t uncompressedSize = 0;
+    int32_t compressedSize = 0;
+    int32_t numValues = 0;
+    int32_t encoding = 0;
+    int32_t levelEncoding = static_cast<int32_t>(ParquetEncoding::Rle);
+    int32_t definitionLength = 0;
+    int32_t repetitionLength = 0;
+    bool compressed = true;
+};
+
+// A top-level column and how its values are read.
+struct ParquetColumn {
+    std::string name;
+    ParquetType type = ParquetType::Int32;
+    size_t leaf = 0; // position of its chunk in each row group
+    bool optional = false;
+    bool isUnsigned = false;
+    int intBits = 0; // 8 or 16 for INT32 columns annotated that narrow
+    bool allNull = false;
+    int64_t nanosPerUnit = 0; // of each stored value, for dates and timestamps
+    std::string unsupported; // why it cannot be read, if it cannot
+};
+
+static ParquetStatistics readStatistics(ThriftReader& in) {
+    ParquetStatistics stats;
+    in.readStruct([&](int16_t id, uint8_t) {
+        switch (id) {
+            case 1: stats.legacyMax = in.binary(); return true;
+            case 2: stats.legacyMin = in.binary(); return true;
+            case 3: stats.nullCount = in.integer(); return true;
+            case 5: stats.max = in.binary(); return true;
+            case 6: stats.min = in.binary(); return true;
+            default: return false;
+        }
+    });
+    return stats;
+}
+
+static ParquetColumnChunk readColumnChunk(ThriftReader& in) {
+    ParquetColumnChunk chunk;
+    in.readStruct([&](int16_t id, uint8_t) {
+        if (id == 1) {
+            if (!in.binary().empty()) {
+                throw std::runtime_error("Parquet column chunks in other files are not supported.");
+            }
+            return true;
+        }
+        if (id != 3) return false;
+        in.readStruct([&](int16_t field, uint8_t) {
+            switch (field) {
+                case 4: chunk.codec = in.i32(); return true;
+                case 5: chunk.numValues = in.integer(); return true;
+                case 7: chunk.totalCompressedSize = in.integer(); return true;
+                case 9: chunk.dataPageOffset = in.integer(); return true;
+                case 11: chunk.dictionaryPageOffset = in.integer(); return true;
+                case 12: chunk.statistics = readStatistics(in); return true;
+                default: return false;
+            }
+        });
+        return true;
+    });
+    return chunk;
+}
+
+static ParquetSchemaElement readSchemaElement(ThriftReader& in) {
+    ParquetSchemaElement element;
+    in.readStruct([&](int16_t id, uint8_t) {
+        switch (id) {
+            case 1: element.type = in.i32(); return true;
+            case 3: element.repetition = in.i32(); return true;
+            case 4: element.name = std::string(in.binary()); return true;
+            case 5: element.numChildren = in.i32(); return true;
+            case 6: element.convertedType = in.i32(); return true;
+            case 10:
+                in.readStruct([&](int16_t member, uint8_t) {
+                    element.logicalType = member;
+                    if (member == 8) {
+                        in.readStruct([&](int16_t field, uint8_t) {
+                            if (field != 2) return false;
+                            in.readStruct([&](int16_t unit, uint8_t) {
+                                element.timeUnit = unit;
+                                return false;
+                            });
+                            return true;
+                        });
+                        return true;
+                    }
+                    if (member != 10) return false;
+                    in.readStruct([&](int16_t field, uint8_t type) {
+                        if (field == 1) element.logicalBitWidth = in.byte();
+                        else if (field == 2) element.logicalSigned = type == ThriftReader::True;
+                        else return false;
+                        return true;
+                    });
+                    return true;
+                });
+                return true;
+            default: return false;
+        }
+    });
+    return element;
+}
+
+static ParquetPageHeader readPageHeader(ThriftReader& in) {
+    ParquetPageHeader header;
+    in.readStruct([&](int16_t id, uint8_t) {
+        switch (id) {
+            case 1: header.type = in.i32(); return true;
+            case 2: header.uncompressedSize = in.i32(); return true;
+            case 3: header.compressedSize = in.i32(); return true;
+            case 5:
+                in.readStruct([&](int16_t field, uint8_t) {
+                    switch (field) {
+                        case 1: header.numValues = in.i32(); return true;
+                        case 2: header.encoding = in.i32(); return true;
+                        case 3: header.levelEncoding = in.i32(); return true;
+                        default: return false;
+                    }
+                });
+                return true;
+            case 7:
+                in.readStruct([&](int16_t field, uint8_t) {
+                    switch (field) {
+                        case 1: header.numValues = in.i32(); return true;
+                        case 2: header.encoding = in.i32(); return true;
+                        default: return false;
+                    }
+                });
+                return true;
+            case 8:
+                in.readStruct([&](int16_t field, uint8_t type) {
+                    switch (field) {
+                        case 1: header.numValues = in.i32(); return true;
+                        case 4: header.encoding = in.i32(); return true;
+                        case 5: header.definitionLength = in.i32(); return true;
+                        case 6: header.repetitionLength = in.i32(); return true;
+                        case 7: header.compressed = type == ThriftReader::True; return true;
+                        default: return false;
+                    }
+                });
+                return true;
+            default: return false;
+        }
+    });
+    return header;
+}
+
+static void snappyDecompress(std::string_view input, size_t expected, std::string& out) {
+    size_t pos = 0;
+    if (readVarint(input, pos) != expected) corruptParquet();
+    out.resize(expected);
+    size_t written = 0;
+    auto readLE = [&](size_t bytes) {
+        if (input.size() - pos < bytes) corruptParquet();
+        size_t v = 0;
+        for (size_t b = 0; b < bytes; ++b) v |= static_cast<size_t>(static_cast<uint8_t>(input[pos + b])) << (8 * b);
+        pos += bytes;
+        return v;
+    };
+    while (pos < input.size()) {
+        const uint8_t tag = static_cast<uint8_t>(input[pos++]);
+        size_t length, offset;
+        switch (tag & 3) {
+            case 0:
+                length = (tag >> 2) + 1u;
+                if (length > 60) length = readLE(length - 60) + 1;
+                if (input.size() - pos < length || expected - written < length) corruptParquet();
+                std::memcpy(&out[written], input.data() + pos, length);
+                pos += length;
+                written += length;
+                continue;
+            case 1:
+                length = ((tag >> 2) & 7u) + 4;
+                offset = (static_cast<size_t>(tag >> 5) << 8) | readLE(1);
+                break;
+            case 2:
+                length = (tag >> 2) + 1u;
+                offset = readLE(2);
+                break;
+            default:
+                length = (tag >> 2) + 1u;
+                offset = readLE(4);
+                break;
+        }
+        if (offset == 0 || offset > written || expected - written < length) corruptParquet();
+        // A copy may overlap the bytes it produces.
+        char* dst = &out[written];
+        const char* src = dst - offset;
+        if (offset >= length) std::memcpy(dst, src, length);
+        else for (size_t i = 0; i < length; ++i) dst[i] = src[i];
+        written += length;
+    }
+    if (written != expected) corruptParquet();
+}
+
+// The uncompressed bytes of a page, in buffer unless they need no decoding.
+static std::string_view decompress(int32_t codec, std::string_view input, int32_t uncompressedSize, std::string& buffer) {
+    if (uncompressedSize < 0) corruptParquet();
+    const auto expected = static_cast<size_t>(uncompressedSize);
+    switch (static_cast<ParquetCodec>(codec)) {
+        case ParquetCodec::Uncompressed:
+            return input;
+        case ParquetCodec::Snappy:
+            snappyDecompress(input, expected, buffer);
+            return buffer;
+        case ParquetCodec::Zstd: {
+#ifdef DF_HAVE_ZSTD
+            buffer.resize(expected);
+            size_t n = ZSTD_decompress(buffer.data(), expected, input.data(), input.size());
+            if (ZSTD_isError(n) || n != expected) corruptParquet();
+            return buffer;
+#else
+            throw std::runtime_error("zstd-compressed Parquet pages need a build with DF_HAVE_ZSTD.");
+#endif
+        }
+        default:
+            throw std::runtime_error("Unsupported Parquet compression codec " + std::to_string(codec) + ".");
+    }
+}
+
+// Decodes count values of bitWidth bits packed LSB first.
+static void unpackBits(std::string_view data, int bitWidth, size_t count, uint32_t* out) {
+    if (bitWidth == 0) {
+        std::fill(out, out + count, 0u);
+        return;
+    }
+    if ((data.size() * 8) / static_cast<size_t>(bitWidth) < count) corruptParquet();
+    const uint64_t mask = (uint64_t(1) << bitWidth) - 1;
+    size_t bit = 0;
+    for (size_t i = 0; i < count; ++i, bit += static_cast<size_t>(bitWidth)) {
+        const size_t byte = bit >> 3;
+        uint64_t word = 0;
+        std::memcpy(&word, data.data() + byte, std::min<size_t>(8, data.size() - byte));
+        out[i] = static_cast<uint32_t>((word >> (bit & 7)) & mask);
+    }
+}
+
+// Decodes count values of the RLE / bit-packed hybrid encoding.
+static void decodeHybrid(std::string_view data, int bitWidth, size_t count, uint32_t* out) {
+    if (bitWidth < 0 || bitWidth > 32) corruptParquet();
+    const size_t valueBytes = (static_cast<size_t>(bitWidth) + 7) / 8;
+    size_t pos = 0;
+    size_t produced = 0;
+    while (produced < count) {
+        const uint64_t header = readVarint(data, pos);
+        if (header & 1) {
+            const uint64_t groups = header >> 1;
+            if (groups > data.size()) corruptParquet();
+            const size_t bytes = std::min<size_t>(groups * static_cast<size_t>(bitWidth), data.size() - pos);
+            const size_t n = std::min<size_t>(groups * 8, count - produced);
+            unpackBits(data.substr(pos, bytes), bitWidth, n, out + produced);
+            pos += bytes;
+            produced += n;
+        } else {
+            if (data.size() - pos < valueBytes) corruptParquet();
+            uint32_t value = 0;
+            for (size_t b = 0; b < valueBytes; ++b) {
+                value |= static_cast<uint32_t>(static_cast<uint8_t>(data[pos + b])) << (8 * b);
+            }
+            pos += valueBytes;
+            const size_t n = std::min<size_t>(header >> 1, count - produced);
+            std::fill(out + produced, out + produced + n, value);
+            produced += n;
+        }
+    }
+}
+
+// Values of physical type P: uint8_t for BOOLEAN, std::string_view for
+// BYTE_ARRAY, else the matching C++ type.
+template<typename P>
+static void decodePlain(std::string_view data, size_t count, std::vector<P>& out) {
+    if constexpr (std::is_same_v<P, std::string_view>) {
+        size_t pos = 0;
+        out.reserve(out.size() + count);
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t length;
+            if (data.size() - pos < sizeof(length)) corruptParquet();
+            std::memcpy(&length, data.data() + pos, sizeof(length));
+            pos += sizeof(length);
+            if (data.size() - pos < length) corruptParquet();
+            out.push_back(data.substr(pos, length));
+            pos += length;
+        }
+    } else if constexpr (std::is_same_v<P, uint8_t>) {
+        if (data.size() < (count + 7) / 8) corruptParquet();
+        const size_t base = out.size();
+        out.resize(base + count);
+        for (size_t i = 0; i < count; ++i) out[base + i] = (static_cast<uint8_t>(data[i >> 3]) >> (i & 7)) & 1;
+    } else {
+        if (data.size() / sizeof(P) < count) corruptParquet();
+        const size_t base = out.size();
+        out.resize(base + count);
+        if (count > 0) std::memcpy(out.data() + base, data.data(), count * sizeof(P));
+    }
+}
+
+class ParquetFile {
+public:
+    std::shared_ptr<const MappedFile> file;
+    std::string_view data;
+    std::vector<ParquetRowGroup> rowGroups;
+    std::vector<ParquetColumn> columns;
+
+    ParquetFile(const std::string& filename, bool memoryMap)
+        : file(std::make_shared<const MappedFile>(filename, memoryMap)), data(file->view()) {
+        const size_t trailer = sizeof(uint32_t) + sizeof(parquetMagic);
+        if (data.size() < sizeof(parquetMagic) + trailer ||
+            std::memcmp(data.data(), parquetMagic, sizeof(parquetMagic)) != 0) {
+            throw std::runtime_error("Not a Parquet file: " + filename);
+        }
+        if (std::memcmp(data.data() + data.size() - sizeof(parquetMagic), "PARE", 4) == 0) {
+            throw std::runtime_error("Encrypted Parquet files are not supported.");
+        }
+        if (std::memcmp(data.data() + data.size() - sizeof(parquetMagic), parquetMagic, sizeof(parquetMagic)) != 0) {
+            corruptParquet();
+        }
+        uint32_t footerSize;
+        std::memcpy(&footerSize, data.data() + data.size() - trailer, sizeof(footerSize));
+        if (footerSize > data.size() - sizeof(parquetMagic) - trailer) corruptParquet();
+
+        std::vector<ParquetSchemaElement> schema;
+        ThriftReader in(data.substr(data.size() - trailer - footerSize, footerSize));
+        in.readStruct([&](int16_t id, uint8_t) {
+            uint8_t type;
+            if (id == 2) {
+                size_t n = in.list(type);
+                for (size_t i = 0; i < n; ++i) schema.push_back(readSchemaElement(in));
+                return true;
+            }
+            if (id == 4) {
+                size_t n = in.list(type);
+                for (size_t i = 0; i < n; ++i) {
+                    ParquetRowGroup group;
+                    in.readStruct([&](int16_t field, uint8_t) {
+                        if (field == 3) {
+                            group.numRows = in.integer();
+                            return true;
+                        }
+                        if (field != 1) return false;
+                        uint8_t elementType;
+                        size_t count = in.list(elementType);
+                        for (size_t c = 0; c < count; ++c) group.columns.push_back(readColumnChunk(in));
+                        return true;
+                    });
+                    rowGroups.push_back(std::move(group));
+                }
+                return true;
+            }
+            return false;
+        });
+        readColumns(schema);
+    }
+
+private:
+    // Number of leaves under schema[i], advancing i past its subtree.
+    static size_t subtreeLeaves(const std::vector<ParquetSchemaElement>& schema, size_t& i) {
+        if (i >= schema.size()) corruptParquet();
+        const ParquetSchemaElement& element = schema[i++];
+        if (element.numChildren <= 0) return 1;
+        size_t leaves = 0;
+        for (int32_t c = 0; c < element.numChildren; ++c) leaves += subtreeLeaves(schema, i);
+        return leaves;
+    }
+
+    void readColumns(const std::vector<ParquetSchemaElement>& schema) {
+        if (schema.empty()) corruptParquet();
+        size_t i = 1;
+        size_t leaf = 0;
+        for (int32_t c = 0; c < schema[0].numChildren; ++c) {
+            const ParquetSchemaElement& element = schema.at(i);
+            ParquetColumn column;
+            column.name = element.name;
+            column.leaf = leaf;
+            leaf += subtreeLeaves(schema, i);
+            if (element.numChildren > 0 || element.repetition == 2) {
+                column.unsupported = "nested";
+            } else {
+                column.type = static_cast<ParquetType>(element.type);
+                column.optional = element.repetition == 1;
+                // UINT_8 .. UINT_64, or an unsigned INTEGER logical type
+                column.isUnsigned = (element.convertedType >= 11 && element.convertedType <= 14) ||
+                                    (element.logicalType == 10 && !element.logicalSigned);
+                // INT_8, INT_16, UINT_8, UINT_16, or an INTEGER logical type of 8 or 16 bits
+                if (element.logicalType == 10 && element.logicalBitWidth <= 16) {
+                    column.intBits = element.logicalBitWidth;
+                } else if (element.convertedType == 11 || element.convertedType == 15) {
+                    column.intBits = 8;
+                } else if (element.convertedType == 12 || element.convertedType == 16) {
+                    column.intBits = 16;
+                }
+                column.allNull = element.logicalType == 11;
+                // DATE, or TIMESTAMP (TIMESTAMP_MILLIS, TIMESTAMP_MICROS) in
+                // MILLIS, MICROS or NANOS
+                if (column.type == ParquetType::Int32 && (element.logicalType == 6 || element.convertedType == 6)) {
+                    column.nanosPerUnit = 86400LL * 1000000000;
+                } else if (column.type == ParquetType::Int64) {
+                    int16_t unit = element.logicalType == 8 ? element.timeUnit
+                                 : element.convertedType == 9 ? 1 : element.convertedType == 10 ? 2 : 0;
+                    static constexpr int64_t nanosPerUnit[] = {0, 1000000, 1000, 1};
+                    if (unit >= 1 && unit <= 3) column.nanosPerUnit = nanosPerUnit[unit];
+                }
+                if (element.convertedType == 5 || element.logicalType == 5) column.unsupported = "decimal";
+                else if (column.type == ParquetType::Int96 || column.type == ParquetType::FixedLenByteArray) {
+                    column.unsupported = "fixed-width binary";
+                } else if (element.type < 0 || element.type > 7) {
+                    corruptParquet();
+                }
+            }
+            columns.push_back(std::move(column));
+        }
+        for (const auto& group : rowGroups) {
+            if (group.columns.size() != leaf || group.numRows < 0) corruptParquet();
+        }
+    }
+};
+
+// Receives the values of a column's rows in order: value() for each present
+// one, null() for each missing one.
+template<typename T>
+struct ParquetValueSink {
+    const ParquetColumn& column;
+    std::vector<T> values;
+    std::vector<uint64_t> valid;
+
+    ParquetValueSink(const ParquetColumn& col, size_t rows) : column(col), valid((rows + 63) / 64, 0) {
+        values.reserve(rows);
+    }
+
+    template<typename P>
+    void value(P v) {
+        const size_t i = values.size();
+        valid[i >> 6] |= uint64_t(1) << (i & 63);
+        if constexpr (std::is_same_v<T, Timestamp>) {
+            values.push_back(toTimestamp(v));
+        } else {
+            values.push_back(static_cast<T>(v));
+        }
+    }
+    void null() { values.push_back(T{}); }
+
+    template<typename P>
+    Timestamp toTimestamp(P v) const {
+        if constexpr (std::is_integral_v<P>) {
+            const int64_t count = v;
+            if (count <= std::numeric_limits<int64_t>::max() / column.nanosPerUnit &&
+                count >= std::numeric_limits<int64_t>::min() / column.nanosPerUnit) {
+                return Timestamp(count * column.nanosPerUnit);
+            }
+        }
+        throw std::runtime_error("Parquet column '" + column.name + "' has a time out of range for TimestampColumn.");
+    }
+
+    Bitmap validity() {
+        const size_t n = values.size();
+        return Bitmap(SharedBuffer<uint64_t>(std::move(valid)), n);
+    }
+};
+
+struct ParquetStringSink {
+    std::vector<StringColumn::offset_type> offsets{0};
+    std::vector<char> chars;
+    std::vector<uint64_t> valid;
+
+    explicit ParquetStringSink(size_t rows) : valid((rows + 63) / 64, 0) { offsets.reserve(rows + 1); }
+
+    void value(std::string_view v) {
+        const size_t i = offsets.size() - 1;
+        valid[i >> 6] |= uint64_t(1) << (i & 63);
+        chars.insert(chars.end(), v.begin(), v.end());
+        offsets.push_back(static_cast<StringColumn::offset_type>(chars.size()));
+    }
+    void null() { offsets.push_back(offsets.back()); }
+
+    StringColumn column() {
+        const size_t n = offsets.size() - 1;
+        return StringColumn(SharedBuffer<StringColumn::offset_type>(std::move(offsets)),
+                            SharedBuffer<char>(std::move(chars)), Bitmap(SharedBuffer<uint64_t>(std::move(valid)), n));
+    }
+};
+
+// Index labels: integers while they are, else their text, with "NA" for nulls.
+struct ParquetLabelSink {
+    std::vector<int64_t> ints;
+    std::vector<std::string> strings;
+    bool text = false;
+
+    template<typename P>
+    void value(P v) {
+        if constexpr (std::is_same_v<P, std::string_view>) {
+            toText();
+            strings.emplace_back(v);
+        } else if constexpr (std::is_integral_v<P> && !std::is_same_v<P, uint8_t>) {
+            if (text) strings.push_back(std::to_string(v));
+            else ints.push_back(static_cast<int64_t>(v));
+        } else {
+            toText();
+            strings.push_back(std::to_string(v));
+        }
+    }
+    void null() {
+        toText();
+        strings.emplace_back("NA");
+    }
+    void toText() {
+        if (text) return;
+        text = true;
+        for (int64_t v : ints) strings.push_back(std::to_string(v));
+        ints.clear();
+    }
+
+    Index index() { return text ? Index(StringIndex(std::move(strings))) : Index(Int64Index(std::move(ints))); }
+};
+
+// Decodes the chunks of column in the given row groups into sink.
+template<typename P, typename Sink>
+static void decodeColumn(const ParquetFile& file, const ParquetColumn& column, const std::vector<size_t>& groups,
+                         Sink& sink) {
+    std::string pageBuffer;
+    std::string dictionaryBuffer;
+    std::vector<P> dictionary;
+    std::vector<P> values;
+    std::vector<uint32_t> levels;
+    std::vector<uint32_t> indices;
+
+    for (size_t g : groups) {
+        const ParquetColumnChunk& chunk = file.rowGroups[g].columns[column.leaf];
+        if (chunk.numValues != file.rowGroups[g].numRows) corruptParquet();
+        int64_t start = chunk.dataPageOffset;
+        if (chunk.dictionaryPageOffset > 0) start = std::min(start, chunk.dictionaryPageOffset);
+        if (start < 4 || chunk.totalCompressedSize < 0 || static_cast<uint64_t>(start) > file.data.size() ||
+            file.data.size() - static_cast<size_t>(start) < static_cast<uint64_t>(chunk.totalCompressedSize)) {
+            corruptParquet();
+        }
+        std::string_view pages = file.data.substr(static_cast<size_t>(start), static_cast<size_t>(chunk.totalCompressedSize));
+        size_t pos = 0;
+        dictionary.clear();
+        bool hasDictionary = false;
+        size_t remaining = static_cast<size_t>(chunk.numValues);
+
+        while (remaining > 0) {
+            ThriftReader in(pages.substr(pos));
+            ParquetPageHeader header = readPageHeader(in);
+            pos += in.offset();
+            if (header.compressedSize < 0 || static_cast<size_t>(header.compressedSize) > pages.size() - pos) {
+                corruptParquet();
+            }
+            std::string_view page = pages.substr(pos, static_cast<size_t>(header.compressedSize));
+            pos += static_cast<size_t>(header.compressedSize);
+
+            const auto pageType = static_cast<ParquetPageType>(header.type);
+            if (pageType == ParquetPageType::Dictionary) {
+                const auto encoding = static_cast<ParquetEncoding>(header.encoding);
+                if (encoding != ParquetEncoding::Plain && encoding != ParquetEncoding::PlainDictionary) {
+                    throw std::runtime_error("Unsupported Parquet dictionary encoding in column '" + column.name + "'.");
+                }
+                if (header.numValues < 0) corruptParquet();
+                std::string_view plain = decompress(chunk.codec, page, header.uncompressedSize, dictionaryBuffer);
+                dictionary.clear();
+                decodePlain(plain, static_cast<size_t>(header.numValues), dictionary);
+                hasDictionary = true;
+                continue;
+            }
+            if (pageType != ParquetPageType::Data && pageType != ParquetPageType::DataV2) continue;
+
+            if (header.numValues < 0 || static_cast<size_t>(header.numValues) > remaining) corruptParquet();
+            const size_t n = static_cast<size_t>(header.numValues);
+            std::string_view levelData;
+            std::string_view valueData;
+            if (pageType == ParquetPageType::DataV2) {
+                if (header.definitionLength < 0 || header.repetitionLength != 0 ||
+                    static_cast<size_t>(header.definitionLength) > page.size()) {
+                    corruptParquet();
+                }
+                const auto levelBytes = static_cast<size_t>(header.definitionLength);
+                levelData = page.substr(0, levelBytes);
+                valueData = page.substr(levelBytes);
+                if (header.compressed) {
+                    valueData = decompress(chunk.codec, valueData, header.uncompressedSize - header.definitionLength,
+                                           pageBuffer);
+                }
+            } else {
+                valueData = decompress(chunk.codec, page, header.uncompressedSize, pageBuffer);
+                if (column.optional) {
+                    if (static_cast<ParquetEncoding>(header.levelEncoding) != ParquetEncoding::Rle) {
+                        throw std::runtime_error("Unsupported Parquet level encoding in column '" + column.name + "'.");
+                    }
+                    uint32_t length;
+                    if (valueData.size() < sizeof(length)) corruptParquet();
+                    std::memcpy(&length, valueData.data(), sizeof(length));
+                    if (valueData.size() - sizeof(length) < length) corruptParquet();
+                    levelData = valueData.substr(sizeof(length), length);
+                    valueData = valueData.substr(sizeof(length) + length);
+                }
+            }
+
+            size_t present = n;
+            if (column.optional) {
+                levels.resize(n);
+                decodeHybrid(levelData, 1, n, levels.data());
+                present = 0;
+                for (uint32_t level : levels) {
+                    if (level > 1) corruptParquet();
+                    present += level;
+                }
+            }
+
+            values.clear();
+            switch (static_cast<ParquetEncoding>(header.encoding)) {
+                case ParquetEncoding::Plain:
+                    decodePlain(valueData, present, values);
+                    break;
+                case ParquetEncoding::PlainDictionary:
+                case ParquetEncoding::RleDictionary: {
+                    if (!hasDictionary) corruptParquet();
+                    if (present > 0) {
+                        if (valueData.empty()) corruptParquet();
+                        indices.resize(present);
+                        decodeHybrid(valueData.substr(1), static_cast<uint8_t>(valueData[0]), present, indices.data());
+                        values.resize(present);
+                        for (size_t i = 0; i < present; ++i) {
+                            if (indices[i] >= dictionary.size()) corruptParquet();
+                            values[i] = dictionary[indices[i]];
+                        }
+                    }
+                    break;
+                }
+                case ParquetEncoding::Rle:
+                    if constexpr (std::is_same_v<P, uint8_t>) {
+                        uint32_t length;
+                        if (valueData.size() < sizeof(length)) corruptParquet();
+                        std::memcpy(&length, valueData.data(), sizeof(length));
+                        if (valueData.size() - sizeof(length) < length) corruptParquet();
+                        indices.resize(present);
+                        decodeHybrid(valueData.substr(sizeof(length), length), 1, present, indices.data());
+                        values.assign(indices.begin(), indices.end());
+                        break;
+                    }
+                    [[fallthrough]];
+                default:
+                    throw std::runtime_error("Unsupported Parquet encoding " + std::to_string(header.encoding) +
+                                             " in column '" + column.name + "'.");
+            }
+
+            if (present == n) {
+                for (const P& v : values) sink.value(v);
+            } else {
+                size_t k = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    if (levels[i]) sink.value(values[k++]);
+                    else sink.null();
+                }
+            }
+            remaining -= n;
+        }
+    }
+}
+
+template<typename Sink>
+static void decodeAny(const ParquetFile& file, const ParquetColumn& column, const std::vector<size_t>& groups,
+                      Sink& sink) {
+    switch (column.type) {
+        case ParquetType::Boolean: decodeColumn<uint8_t>(file, column, groups, sink); break;
+        case ParquetType::Int32: decodeColumn<int32_t>(file, column, groups, sink); break;
+        case ParquetType::Int64: decodeColumn<int64_t>(file, column, groups, sink); break;
+        case ParquetType::Float: decodeColumn<float>(file, column, groups, sink); break;
+        case ParquetType::Double: decodeColumn<double>(file, column, groups, sink); break;
+        default: decodeColumn<std::string_view>(file, column, groups, sink); break;
+    }
+}
+
+// Values stored as P, kept as T; unsigned values are stored in signed P.
+template<typename T, typename P>
+static ColumnData numberColumn(const ParquetFile& file, const ParquetColumn& column, const std::vector<size_t>& groups,
+                               size_t rows) {
+    ParquetValueSink<T> sink(column, rows);
+    decodeColumn<P>(file, column, groups, sink);
+    Bitmap validity = sink.validity();
+    return Column<T>(SharedBuffer<T>(std::move(sink.values)), std::move(validity));
+}
+
+static ColumnData readParquetColumn(const ParquetFile& file, const ParquetColumn& column,
+                                    const std::vector<size_t>& groups, size_t rows) {
+    if (!column.unsupported.empty()) {
+        throw std::runtime_error("Parquet column '" + column.name + "' has an unsupported " + column.unsupported + " type.");
+    }
+    if (column.allNull) {
+        return DoubleColumn(SharedBuffer<double>(std::vector<double>(rows)), Bitmap(rows, false));
+    }
+    if (column.nanosPerUnit != 0) {
+        ParquetValueSink<Timestamp> sink(column, rows);
+        if (column.type == ParquetType::Int32) decodeColumn<int32_t>(file, column, groups, sink);
+        else decodeColumn<int64_t>(file, column, groups, sink);
+        Bitmap validity = sink.validity();
+        return TimestampColumn(SharedBuffer<Timestamp>(std::move(sink.values)), std::move(validity));
+    }
+    switch (column.type) {
+        case ParquetType::Boolean: {
+            ParquetValueSink<BoolColumn::storage_type> sink(column, rows);
+            decodeColumn<uint8_t>(file, column, groups, sink);
+            return BoolColumn(SharedBuffer<BoolColumn::storage_type>(std::move(sink.values)), sink.validity());
+        }
+        case ParquetType::Int32:
+            if (column.intBits == 8) {
+                return column.isUnsigned ? numberColumn<uint8_t, int32_t>(file, column, groups, rows)
+                                         : numberColumn<int8_t, int32_t>(file, column, groups, rows);
+            }
+            if (column.intBits == 16) {
+                return column.isUnsigned ? numberColumn<uint16_t, int32_t>(file, column, groups, rows)
+                                         : numberColumn<int16_t, int32_t>(file, column, groups, rows);
+            }
+            return column.isUnsigned ? numberColumn<uint32_t, int32_t>(file, column, groups, rows)
+                                     : numberColumn<int, int32_t>(file, column, groups, rows);
+        case ParquetType::Int64:
+            return column.isUnsigned ? numberColumn<uint64_t, int64_t>(file, column, groups, rows)
+                                     : numberColumn<int64_t, int64_t>(file, column, groups, rows);
+        case ParquetType::Float: return numberColumn<float, float>(file, column, groups, rows);
+        case ParquetType::Double: return numberColumn<double, double>(file, column, groups, rows);
+        default: {
+            ParquetStringSink sink(rows);
+            decodeColumn<std::string_view>(file, column, groups, sink);
+            return sink.column();
+        }
+    }
+}
+
+// A ColumnPredicate bound to a column, with its bounds as the column's
+// values compare: integers or numbers for number columns, flags for Bool,
+// text for String and times for Timestamp columns. Rows of a column of
+// another kind fail it.
+struct ParquetFilter {
+    enum class Kind { None, Integer, Number, Flag, Text, Time };
+    struct Bound {
+        Kind kind = Kind::None;
+        int64_t integer = 0;
+        double number = 0;
+        bool flag = false;
+        std::string text;
+        Timestamp time;
+    };
+
+    const ParquetColumn* column;
+    size_t slot; // position of the column among those decoded
+    io::ColumnPredicate::Op op;
+    Bound lower;
+    Bound upper;
+};
+
+template<typename T>
+static ParquetFilter::Bound parquetBound(const T& value) {
+    ParquetFilter::Bound bound;
+    if constexpr (std::is_same_v<T, bool>) {
+        bound.kind = ParquetFilter::Kind::Flag;
+        bound.flag = value;
+    } else if constexpr (std::is_integral_v<T>) {
+        // Integers compare exactly with integer values, past where doubles
+        // lose precision.
+        if (!std::is_signed_v<T> && static_cast<uint64_t>(value) > std::numeric_limits<int64_t>::max()) {
+            bound.kind = ParquetFilter::Kind::Number;
+            bound.number = static_cast<double>(value);
+        } else {
+            bound.kind = ParquetFilter::Kind::Integer;
+            bound.integer = static_cast<int64_t>(value);
+        }
+    } else if constexpr (std::is_floating_point_v<T>) {
+        bound.kind = ParquetFilter::Kind::Number;
+        bound.number = static_cast<double>(value);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        bound.kind = ParquetFilter::Kind::Text;
+        bound.text = value;
+    } else if constexpr (std::is_same_v<T, Timestamp>) {
+        bound.kind = ParquetFilter::Kind::Time;
+        bound.time = value;
+    } else if constexpr (!std::is_same_v<T, NA>) {
+        if (!value.isNA()) return parquetBound(value.valueUnsafe());
+    }
+    return bound;
+}
+
+static ParquetFilter::Kind kindOf(const ParquetColumn& column) {
+    if (column.allNull) return ParquetFilter::Kind::None;
+    if (column.nanosPerUnit != 0) return ParquetFilter::Kind::Time;
+    switch (column.type) {
+        case ParquetType::Boolean: return ParquetFilter::Kind::Flag;
+        case ParquetType::ByteArray: return ParquetFilter::Kind::Text;
+        default: return ParquetFilter::Kind::Number;
+    }
+}
+
+static bool isNumeric(ParquetFilter::Kind kind) {
+    return kind == ParquetFilter::Kind::Integer || kind == ParquetFilter::Kind::Number;
+}
+
+// Whether values of kind a compare with bounds of kind b.
+static bool comparable(ParquetFilter::Kind a, ParquetFilter::Kind b) {
+    return a == b || (isNumeric(a) && isNumeric(b));
+}
+
+template<typename T>
+static int order(const T& a, const T& b) { return a < b ? -1 : b < a ? 1 : a == b ? 0 : 2; }
+
+// Orders a number against a numeric bound, exactly when both are integers.
+template<typename T>
+static int compareNumber(T value, const ParquetFilter::Bound& bound) {
+    if (bound.kind == ParquetFilter::Kind::Integer) {
+        if constexpr (std::is_integral_v<T>) {
+            if (!std::is_signed_v<T> && static_cast<uint64_t>(value) > std::numeric_limits<int64_t>::max()) return 1;
+            return order(static_cast<int64_t>(value), bound.integer);
+        } else {
+            return order(static_cast<double>(value), static_cast<double>(bound.integer));
+        }
+    }
+    if (bound.kind == ParquetFilter::Kind::Number) return order(static_cast<double>(value), bound.number);
+    return 2;
+}
+
+// Orders a value against bound: -1, 0 or 1, or 2 when they do not compare.
+static int compareBound(const ParquetFilter::Bound& value, const ParquetFilter::Bound& bound) {
+    if (value.kind == ParquetFilter::Kind::Integer) return compareNumber(value.integer, bound);
+    if (value.kind == ParquetFilter::Kind::Number) return compareNumber(value.number, bound);
+    if (value.kind != bound.kind) return 2;
+    switch (bound.kind) {
+        case ParquetFilter::Kind::Flag: return order(value.flag, bound.flag);
+        case ParquetFilter::Kind::Text: return order(std::string_view(value.text), std::string_view(bound.text));
+        case ParquetFilter::Kind::Time: return order(value.time, bound.time);
+        default: return 2;
+    }
+}
+
+static int compareRow(const ColumnData& data, size_t i, const ParquetFilter::Bound& bound) {
+    return visitDecoded([&](const auto& col) -> int {
+        using Col = std::decay_t<decltype(col)>;
+        if (col.isNA(i)) return 2;
+        if constexpr (isNumberColumn<Col>) {
+            return compareNumber(col.value(i), bound);
+        } else if constexpr (std::is_same_v<Col, BoolColumn>) {
+            if (bound.kind != ParquetFilter::Kind::Flag) return 2;
+            return order(static_cast<bool>(col.value(i)), bound.flag);
+        } else if constexpr (std::is_same_v<Col, TimestampColumn>) {
+            if (bound.kind != ParquetFilter::Kind::Time) return 2;
+            return order(col.value(i), bound.time);
+        } else {
+            if (bound.kind != ParquetFilter::Kind::Text) return 2;
+            return order(std::string_view(col.value(i)), std::string_view(bound.text));
+        }
+    }, data);
+}
+
+static bool passesRow(const ParquetFilter& filter, const ColumnData& data, size_t i) {
+    using Op = io::ColumnPredicate::Op;
+    if (filter.op == Op::IsNA || filter.op == Op::NotNA) {
+        bool na = std::visit([i](const auto& col) { return col.isNA(i); }, data);
+        return na == (filter.op == Op::IsNA);
+    }
+    int c = compareRow(data, i, filter.lower);
+    switch (filter.op) {
+        case Op::Equal: return c == 0;
+        case Op::NotEqual: return c != 0;
+        case Op::Less: return c == -1;
+        case Op::LessEqual: return c == -1 || c == 0;
+        case Op::Greater: return c == 1;
+        case Op::GreaterEqual: return c == 0 || c == 1;
+        case Op::Between: {
+            if (c != 0 && c != 1) return false;
+            int u = compareRow(data, i, filter.upper);
+            return u == -1 || u == 0;
+        }
+        default: return false;
+    }
+}
+
+// A min or max statistic as a bound of its column's kind.
+static std::optional<ParquetFilter::Bound> statisticBound(const ParquetColumn& column, std::string_view bytes) {
+    ParquetFilter::Bound bound;
+    bound.kind = kindOf(column);
+    if (bound.kind == ParquetFilter::Kind::Time) {
+        int64_t count;
+        if (column.type == ParquetType::Int32) {
+            int32_t days;
+            if (bytes.size() != sizeof(days)) return std::nullopt;
+            std::memcpy(&days, bytes.data(), sizeof(days));
+            count = days;
+        } else {
+            if (bytes.size() != sizeof(count)) return std::nullopt;
+            std::memcpy(&count, bytes.data(), sizeof(count));
+        }
+        if (count > std::numeric_limits<int64_t>::max() / column.nanosPerUnit ||
+            count < std::numeric_limits<int64_t>::min() / column.nanosPerUnit) {
+            return std::nullopt;
+        }
+        bound.time = Timestamp(count * column.nanosPerUnit);
+        return bound;
+    }
+    auto load = [&](auto sample) {
+        using T = decltype(sample);
+        if (bytes.size() != sizeof(T)) return false;
+        std::memcpy(&sample, bytes.data(), sizeof(T));
+        bound = parquetBound(sample);
+        return true;
+    };
+    switch (column.type) {
+        case ParquetType::Boolean:
+            if (bytes.size() != 1) return std::nullopt;
+            bound.flag = bytes[0] != 0;
+            return bound;
+        case ParquetType::Int32:
+            if (column.isUnsigned ? load(uint32_t{}) : load(int32_t{})) return bound;
+            return std::nullopt;
+        case ParquetType::Int64:
+            if (column.isUnsigned ? load(uint64_t{}) : load(int64_t{})) return bound;
+            return std::nullopt;
+        case ParquetType::Float:
+            if (load(float{})) return bound;
+            return std::nullopt;
+        case ParquetType::Double:
+            if (load(double{})) return bound;
+            return std::nullopt;
+        default:
+            bound.text = std::string(bytes);
+            return bound;
+    }
+}
+
+// Whether the statistics of group show that none of its rows passes filter.
+static bool excludes(const ParquetRowGroup& group, const ParquetFilter& filter) {
+    using Op = io::ColumnPredicate::Op;
+    const ParquetColumn& column = *filter.column;
+    const ParquetStatistics& stats = group.columns[column.leaf].statistics;
+    const std::optional<int64_t>& nulls = stats.nullCount;
+
+    if (filter.op == Op::IsNA) return !column.allNull && nulls && *nulls == 0;
+    if (filter.op == Op::NotNA) return column.allNull || (nulls && *nulls == group.numRows);
+    // Every row fails a comparison with a bound of another kind, or when NA.
+    const ParquetFilter::Kind kind = kindOf(column);
+    if (!comparable(kind, filter.lower.kind) || (filter.op == Op::Between && !comparable(kind, filter.upper.kind)) ||
+        (nulls && *nulls == group.numRows)) {
+        return filter.op != Op::NotEqual;
+    }
+
+    std::optional<std::string_view> minBytes = stats.min;
+    std::optional<std::string_view> maxBytes = stats.max;
+    if ((!minBytes || !maxBytes) && kind != ParquetFilter::Kind::Text && !column.isUnsigned) {
+        minBytes = stats.legacyMin;
+        maxBytes = stats.legacyMax;
+    }
+    if (!minBytes || !maxBytes) return false;
+    std::optional<ParquetFilter::Bound> min = statisticBound(column, *minBytes);
+    std::optional<ParquetFilter::Bound> max = statisticBound(column, *maxBytes);
+    if (!min || !max) return false;
+
+    const int lo = compareBound(*min, filter.lower);
+    const int hi = compareBound(*max, filter.lower);
+    switch (filter.op) {
+        case Op::Equal: return lo == 1 || hi == -1;
+        case Op::NotEqual: return lo == 0 && hi == 0 && nulls && *nulls == 0;
+        case Op::Less: return lo == 0 || lo == 1;
+        case Op::LessEqual: return lo == 1;
+        case Op::Greater: return hi == 0 || hi == -1;
+        case Op::GreaterEqual: return hi == -1;
+        case Op::Between: return hi == -1 || compareBound(*min, filter.upper) == 1;
+        default: return false;
+    }
+}
+
+} // namespace detail
+
+namespace io {
+
+DataFrame readParquet(const std::string& filename, const ParquetReadOptions& options) {
+    using detail::ParquetColumn;
+    detail::ParquetFile file(filename, options.memoryMap);
+
+    auto find = [&](const std::string& name) -> const ParquetColumn* {
+        for (const auto& column : file.columns) {
+            if (column.name == name) return &column;
+        }
+        return nullptr;
+    };
+
+    std::vector<const ParquetColumn*> selected;
+    if (options.columns.empty()) {
+        for (const auto& column : file.columns) {
+            if (column.name != detail::parquetIndexColumn) selected.push_back(&column);
+        }
+    } else {
+        for (const auto& name : options.columns) {
+            const ParquetColumn* column = find(name);
+            if (!column) throw std::invalid_argument("Unknown column: " + name);
+            selected.push_back(column);
+        }
+    }
+    const ParquetColumn* indexColumn = find(detail::parquetIndexColumn);
+    if (indexColumn && (!indexColumn->unsupported.empty() ||
+                        std::find(selected.begin(), selected.end(), indexColumn) != selected.end())) {
+        indexColumn = nullptr;
+    }
+
+    // Columns to decode: the selected ones, then any only filtered on.
+    std::vector<const ParquetColumn*> decoded = selected;
+    std::vector<detail::ParquetFilter> filters;
+    for (const auto& predicate : options.where) {
+        const ParquetColumn* column = find(predicate.column);
+        if (!column) {
+            throw std::invalid_argument("Predicate on unknown column: " + predicate.column);
+        }
+        auto it = std::find(decoded.begin(), decoded.end(), column);
+        if (it == decoded.end()) it = decoded.insert(decoded.end(), column);
+        detail::ParquetFilter filter{column, static_cast<size_t>(it - decoded.begin()), predicate.op, {}, {}};
+        filter.lower = std::visit([](const auto& v) { return detail::parquetBound(v); }, predicate.value);
+        filter.upper = std::visit([](const auto& v) { return detail::parquetBound(v); }, predicate.upper);
+        bool needsValue = predicate.op != ColumnPredicate::Op::IsNA && predicate.op != ColumnPredicate::Op::NotNA;
+        if ((needsValue && filter.lower.kind == detail::ParquetFilter::Kind::None) ||
+            (predicate.op == ColumnPredicate::Op::Between && filter.upper.kind == detail::ParquetFilter::Kind::None)) {
+            throw std::invalid_argument("Predicate on column " + predicate.column + " has no value.");
+        }
+        filters.push_back(std::move(filter));
+    }
+
+    // Row groups that may hold a passing row, and the position of their
+    // first row in the file.
+    std::vector<size_t> groups;
+    std::vector<size_t> firstRows;
+    size_t fileRows = 0;
+    size_t rows = 0;
+    for (size_t g = 0; g < file.rowGroups.size(); ++g) {
+        const detail::ParquetRowGroup& group = file.rowGroups[g];
+        bool skip = std::any_of(filters.begin(), filters.end(),
+                                [&](const auto& filter) { return detail::excludes(group, filter); });
+        if (!skip) {
+            groups.push_back(g);
+            firstRows.push_back(fileRows);
+            rows += static_cast<size_t>(group.numRows);
+        }
+        fileRows += static_cast<size_t>(group.numRows);
+    }
+
+    std::vector<ColumnData> columns;
+    for (const ParquetColumn* column : decoded) {
+        columns.push_back(detail::readParquetColumn(file, *column, groups, rows));
+    }
+    std::optional<Index> index;
+    if (indexColumn) {
+        detail::ParquetLabelSink labels;
+        detail::decodeAny(file, *indexColumn, groups, labels);
+        index = labels.index();
+    }
+
+    std::vector<size_t> kept;
+    if (!filters.empty()) {
+        for (size_t i = 0; i < rows; ++i) {
+            bool pass = std::all_of(filters.begin(), filters.end(), [&](const auto& filter) {
+                return detail::passesRow(filter, columns[filter.slot], i);
+            });
+            if (pass) kept.push_back(i);
+        }
+        if (!index) {
+            // Label kept rows by their position in the file.
+            std::vector<int64_t> labels;
+            labels.reserve(rows);
+            for (size_t k = 0; k < groups.size(); ++k) {
+                const size_t n = static_cast<size_t>(file.rowGroups[groups[k]].numRows);
+                for (size_t r = 0; r < n; ++r) labels.push_back(static_cast<int64_t>(firstRows[k] + r));
+            }
+            index = Index(Int64Index(std::move(labels)));
+        }
+        index = index->take(kept);
+    }
+
+    DataFrame df;
+    for (size_t c = 0; c < selected.size(); ++c) {
+        if (filters.empty()) {
+            df.addColumn(selected[c]->name, columns[c]);
+        } else {
+            df.addColumn(selected[c]->name, std::visit([&](const auto& col) -> ColumnData { return col.take(kept); },
+                                                       columns[c]));
+        }
+    }
+    if (index && df.numColumns() > 0 && index->size() > 0) df.setIndex(*index);
+    return df;
+}
+
+} // namespace io
+} // namespace df
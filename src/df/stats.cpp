@@ -7,73 +7,92 @@
 
 namespace df { namespace stats {
 
+namespace {
+
+template<typename Col>
+constexpr bool isNumericColumn = isNumberColumn<Col> || std::is_same_v<Col, BoolColumn>;
+
+// Valid values of a column, in row order.
+template<typename Col>
+std::vector<double> validAsDouble(const Col& vec) {
+    std::vector<double> values;
+    values.reserve(vec.size() - vec.nullCount());
+    vec.forEachValid([&values](size_t, auto v) { values.push_back(static_cast<double>(v)); });
+    return values;
+}
+
+// Integers (and bools as 0/1) sum exactly in 128 bits: to an int when the
+// total fits one, else to int64_t, or uint64_t for unsigned columns. Only a
+// total past 64 bits falls back to double.
+template<typename Col>
+Value integerSum(const Col& vec) {
+    using T = typename Col::element_type;
+    constexpr bool isUnsigned = std::is_unsigned_v<T> && !std::is_same_v<T, bool>;
+    __int128 total = 0;
+    bool anyValid = false;
+    vec.forEachValid([&](size_t, T v) {
+        total += v;
+        anyValid = true;
+    });
+    if (!anyValid) return NA_VALUE;
+    if (total >= std::numeric_limits<int>::min() && total <= std::numeric_limits<int>::max()) {
+        return static_cast<int>(total);
+    }
+    if (isUnsigned && total <= std::numeric_limits<uint64_t>::max()) return static_cast<uint64_t>(total);
+    if (!isUnsigned && total >= std::numeric_limits<int64_t>::min() && total <= std::numeric_limits<int64_t>::max()) {
+        return static_cast<int64_t>(total);
+    }
+    return static_cast<double>(total);
+}
+
+} // namespace
+
 Value mean(const ColumnData& column) {
-    return std::visit([](const auto& vec) -> Value {
-        using T = typename std::decay_t<decltype(vec)>::value_type;
-
-        size_t count = 0;
-        double sum = 0.0;
-
-        for (const auto& val : vec) {
-            if constexpr (std::is_same_v<T, NullableInt> ||
-                          std::is_same_v<T, NullableDouble> ||
-                          std::is_same_v<T, NullableBool>) {
-                if (!val.isNA()) {
-                    if constexpr (std::is_same_v<T, NullableBool>) {
-                        sum += val.valueUnsafe() ? 1.0 : 0.0;
-                    } else {
-                        sum += static_cast<double>(val.valueUnsafe());
-                    }
-                    count++;
-                }
-            }
-        }
+    if (const auto* encoded = std::get_if<EncodedColumn>(&column)) return encoded->mean();
+    return visitDecoded([](const auto& vec) -> Value {
+        using Col = std::decay_t<decltype(vec)>;
 
-        if (count == 0) return NA_VALUE;
-        return sum / count;
+        if constexpr (isIntegerColumn<Col> || std::is_same_v<Col, BoolColumn>) {
+            // Summed exactly, as EncodedColumn::mean does, and divided once.
+            size_t count = 0;
+            __int128 total = 0;
+            vec.forEachValid([&](size_t, auto v) {
+                total += v;
+                ++count;
+            });
+            if (count == 0) return NA_VALUE;
+            return static_cast<double>(total) / static_cast<double>(count);
+        }
+        else if constexpr (isFloatColumn<Col>) {
+            size_t count = 0;
+            double sum = 0.0;
+            vec.forEachValid([&](size_t, auto v) {
+                sum += static_cast<double>(v);
+                ++count;
+            });
+            if (count == 0) return NA_VALUE;
+            return sum / count;
+        }
+        return NA_VALUE;
     }, column);
 }
 
 Value sum(const ColumnData& column) {
-    return std::visit([](const auto& vec) -> Value {
-        using T = typename std::decay_t<decltype(vec)>::value_type;
+    if (const auto* encoded = std::get_if<EncodedColumn>(&column)) return encoded->sum();
+    return visitDecoded([](const auto& vec) -> Value {
+        using Col = std::decay_t<decltype(vec)>;
 
-        if constexpr (std::is_same_v<T, NullableInt>) {
-            long long total = 0;
-            bool anyValid = false;
-            for (const auto& val : vec) {
-                if (!val.isNA()) {
-                    total += val.valueUnsafe();
-                    anyValid = true;
-                }
-            }
-            if (!anyValid) return NA_VALUE;
-            if (total >= std::numeric_limits<int>::min() && total <= std::numeric_limits<int>::max()) {
-                return static_cast<int>(total);
-            }
-            return static_cast<double>(total);
+        if constexpr (isIntegerColumn<Col> || std::is_same_v<Col, BoolColumn>) {
+            return integerSum(vec);
         }
-        else if constexpr (std::is_same_v<T, NullableDouble>) {
+        else if constexpr (isFloatColumn<Col>) {
+            // float columns sum in double precision.
             double total = 0.0;
             bool anyValid = false;
-            for (const auto& val : vec) {
-                if (!val.isNA()) {
-                    total += val.valueUnsafe();
-                    anyValid = true;
-                }
-            }
-            if (!anyValid) return NA_VALUE;
-            return total;
-        }
-        else if constexpr (std::is_same_v<T, NullableBool>) {
-            int total = 0;
-            bool anyValid = false;
-            for (const auto& val : vec) {
-                if (!val.isNA()) {
-                    total += val.valueUnsafe() ? 1 : 0;
-                    anyValid = true;
-                }
-            }
+            vec.forEachValid([&](size_t, auto v) {
+                total += v;
+                anyValid = true;
+            });
             if (!anyValid) return NA_VALUE;
             return total;
         }
@@ -82,86 +101,51 @@ Value sum(const ColumnData& column) {
 }
 
 Value max(const ColumnData& column) {
-    return std::visit([](const auto& vec) -> Value {
-        using T = typename std::decay_t<decltype(vec)>::value_type;
+    if (const auto* encoded = std::get_if<EncodedColumn>(&column)) return encoded->max();
+    return visitDecoded([](const auto& vec) -> Value {
+        using T = typename std::decay_t<decltype(vec)>::element_type;
 
         if (vec.empty()) return NA_VALUE;
 
-        if constexpr (std::is_same_v<T, NullableInt> ||
-                      std::is_same_v<T, NullableDouble> ||
-                      std::is_same_v<T, NullableBool>) {
-            auto it = std::max_element(vec.begin(), vec.end(),
-                [](const auto& a, const auto& b) {
-                    if (a.isNA()) return !b.isNA();
-                    if (b.isNA()) return false;
-                    return a.valueUnsafe() < b.valueUnsafe();
-                });
-            if (it == vec.end() || it->isNA()) return NA_VALUE;
-            return it->valueUnsafe();
-        }
-        else if constexpr (std::is_same_v<T, NullableString>) {
-            NullableString maxVal;
-            bool anyValid = false;
-            for (const auto& val : vec) {
-                if (!val.isNA()) {
-                    if (!anyValid || val.valueUnsafe() > maxVal.valueUnsafe()) {
-                        maxVal = val;
-                        anyValid = true;
-                    }
-                }
+        T maxVal{};
+        bool anyValid = false;
+        vec.forEachValid([&](size_t, auto v) {
+            if (!anyValid || v > maxVal) {
+                maxVal = T(v);
+                anyValid = true;
             }
-            if (!anyValid) return NA_VALUE;
-            return maxVal.valueUnsafe();
-        }
-        return NA_VALUE;
+        });
+        if (!anyValid) return NA_VALUE;
+        return maxVal;
     }, column);
 }
 
 Value min(const ColumnData& column) {
-    return std::visit([](const auto& vec) -> Value {
-        using T = typename std::decay_t<decltype(vec)>::value_type;
+    if (const auto* encoded = std::get_if<EncodedColumn>(&column)) return encoded->min();
+    return visitDecoded([](const auto& vec) -> Value {
+        using T = typename std::decay_t<decltype(vec)>::element_type;
 
         if (vec.empty()) return NA_VALUE;
 
-        if constexpr (std::is_same_v<T, NullableInt> ||
-                      std::is_same_v<T, NullableDouble> ||
-                      std::is_same_v<T, NullableBool>) {
-            auto it = std::min_element(vec.begin(), vec.end(),
-                [](const auto& a, const auto& b) {
-                    if (a.isNA()) return false;
-                    if (b.isNA()) return true;
-                    return a.valueUnsafe() < b.valueUnsafe();
-                });
-            if (it == vec.end() || it->isNA()) return NA_VALUE;
-            return it->valueUnsafe();
-        }
-        else if constexpr (std::is_same_v<T, NullableString>) {
-            NullableString minVal;
-            bool anyValid = false;
-            for (const auto& val : vec) {
-                if (!val.isNA()) {
-                    if (!anyValid || val.valueUnsafe() < minVal.valueUnsafe()) {
-                        minVal = val;
-                        anyValid = true;
-                    }
-                }
+        T minVal{};
+        bool anyValid = false;
+        vec.forEachValid([&](size_t, auto v) {
+            if (!anyValid || v < minVal) {
+                minVal = T(v);
+                anyValid = true;
             }
-            if (!anyValid) return NA_VALUE;
-            return minVal.valueUnsafe();
-        }
-        return NA_VALUE;
+        });
+        if (!anyValid) return NA_VALUE;
+        return minVal;
     }, column);
 }
 
 Value median(const ColumnData& column) {
-    return std::visit([](const auto& vec) -> Value {
-        using T = typename std::decay_t<decltype(vec)>::value_type;
+    return visitDecoded([](const auto& vec) -> Value {
+        using Col = std::decay_t<decltype(vec)>;
 
-        if constexpr (std::is_same_v<T, NullableInt> || std::is_same_v<T, NullableDouble>) {
-            std::vector<double> values;
-            for (const auto& val : vec) {
-                if (!val.isNA()) values.push_back(static_cast<double>(val.valueUnsafe()));
-            }
+        if constexpr (isNumberColumn<Col>) {
+            std::vector<double> values = validAsDouble(vec);
             if (values.empty()) return NA_VALUE;
             std::sort(values.begin(), values.end());
             size_t n = values.size();
@@ -173,38 +157,31 @@ Value median(const ColumnData& column) {
 }
 
 Value count(const ColumnData& column) {
+    if (const auto* encoded = std::get_if<EncodedColumn>(&column)) return encoded->count();
     return std::visit([](const auto& vec) -> Value {
-        size_t validCount = 0;
-        for (const auto& val : vec) {
-            if (!val.isNA()) validCount++;
-        }
-        return static_cast<int>(validCount);
+        return static_cast<int>(vec.size() - vec.nullCount());
     }, column);
 }
 
 Value var(const ColumnData& column, size_t ddof) {
-    return std::visit([ddof](const auto& vec) -> Value {
-        using T = typename std::decay_t<decltype(vec)>::value_type;
+    return visitDecoded([ddof](const auto& vec) -> Value {
+        using Col = std::decay_t<decltype(vec)>;
 
-        if constexpr (std::is_same_v<T, NullableInt> || std::is_same_v<T, NullableDouble>) {
+        if constexpr (isNumberColumn<Col>) {
             double meanVal = 0.0;
             size_t count = 0;
-            for (const auto& val : vec) {
-                if (!val.isNA()) {
-                    meanVal += static_cast<double>(val.valueUnsafe());
-                    count++;
-                }
-            }
+            vec.forEachValid([&](size_t, auto v) {
+                meanVal += static_cast<double>(v);
+                count++;
+            });
             if (count <= ddof) return NA_VALUE;
             meanVal /= count;
 
             double sumSquaredDiff = 0.0;
-            for (const auto& val : vec) {
-                if (!val.isNA()) {
-                    double diff = static_cast<double>(val.valueUnsafe()) - meanVal;
-                    sumSquaredDiff += diff * diff;
-                }
-            }
+            vec.forEachValid([&](size_t, auto v) {
+                double diff = static_cast<double>(v) - meanVal;
+                sumSquaredDiff += diff * diff;
+            });
             return sumSquaredDiff / (count - ddof);
         }
         return NA_VALUE;
@@ -222,13 +199,17 @@ Value std(const ColumnData& column, size_t ddof) {
 namespace {
 
 std::pair<std::vector<double>, std::vector<double>>
-extractPairedNumeric(const ColumnData& col1, const ColumnData& col2) {
+extractPairedNumeric(const ColumnData& column1, const ColumnData& column2) {
+    // Encoded columns are decoded once here rather than for every row.
+    auto plain = [](const ColumnData& c) { return visitDecoded([](const auto& vec) -> ColumnData { return vec; }, c); };
+    const ColumnData col1 = plain(column1);
+    const ColumnData col2 = plain(column2);
     auto toDouble = [](const ColumnData& c, size_t idx) -> std::pair<bool, double> {
-        return std::visit([idx](const auto& vec) -> std::pair<bool, double> {
+        return visitDecoded([idx](const auto& vec) -> std::pair<bool, double> {
             using VecType = std::decay_t<decltype(vec)>;
-            if constexpr (std::is_same_v<VecType, IntColumn> || std::is_same_v<VecType, DoubleColumn>) {
-                if (vec[idx].isNA()) return {true, 0.0};
-                return {false, static_cast<double>(vec[idx].valueUnsafe())};
+            if constexpr (isNumberColumn<VecType>) {
+                if (vec.isNA(idx)) return {true, 0.0};
+                return {false, static_cast<double>(vec.value(idx))};
             } else {
                 return {true, 0.0};
             }
@@ -251,11 +232,8 @@ extractPairedNumeric(const ColumnData& col1, const ColumnData& col2) {
 std::vector<std::string> numericColumnNames(const DataFrame& df) {
     std::vector<std::string> names;
     for (const auto& name : df.getColumnNames()) {
-        const auto& colData = df[name];
-        if (std::holds_alternative<IntColumn>(colData) ||
-            std::holds_alternative<DoubleColumn>(colData)) {
-            names.push_back(name);
-        }
+        bool numeric = visitType([](const auto& vec) { return isNumberColumn<std::decay_t<decltype(vec)>>; }, df[name]);
+        if (numeric) names.push_back(name);
     }
     return names;
 }
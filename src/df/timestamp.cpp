@@ -0,0 +1,276 @@
+#include "df/timestamp.hpp"
+#include <limits>
+#include <stdexcept>
+
+namespace df {
+
+namespace {
+
+constexpr int64_t nanosPerSecond = 1000000000;
+constexpr int64_t secondsPerDay = 86400;
+
+// The broken-down parts of a timestamp while it is parsed.
+struct DateTimeFields {
+    int64_t year = 1970;
+    int64_t month = 1;
+    int64_t day = 1;
+    int64_t hour = 0;
+    int64_t minute = 0;
+    int64_t second = 0;
+    int64_t fraction = 0; // nanoseconds
+    int64_t offset = 0;   // seconds east of UTC
+};
+
+int64_t floorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date, and back.
+int64_t daysFromCivil(int64_t y, int64_t m, int64_t d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+void civilFromDays(int64_t z, int64_t& y, int64_t& m, int64_t& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const int64_t doe = z - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = yoe + era * 400 + (m <= 2);
+}
+
+int64_t daysInMonth(int64_t y, int64_t m) {
+    static constexpr int64_t days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (m == 2 && y % 4 == 0 && (y % 100 != 0 || y % 400 == 0)) return 29;
+    return days[m - 1];
+}
+
+bool toTimestamp(const DateTimeFields& f, Timestamp& out) {
+    if (f.month < 1 || f.month > 12 || f.day < 1 || f.day > daysInMonth(f.year, f.month) || f.hour > 23 ||
+        f.minute > 59 || f.second > 59) {
+        return false;
+    }
+    const int64_t seconds = daysFromCivil(f.year, f.month, f.day) * secondsPerDay + f.hour * 3600 + f.minute * 60 +
+                            f.second - f.offset;
+    constexpr int64_t maxSeconds = std::numeric_limits<int64_t>::max() / nanosPerSecond;
+    constexpr int64_t minSeconds = std::numeric_limits<int64_t>::min() / nanosPerSecond;
+    if (seconds > maxSeconds || seconds < minSeconds - 1) return false;
+    if (seconds == maxSeconds && f.fraction > std::numeric_limits<int64_t>::max() - maxSeconds * nanosPerSecond) {
+        return false;
+    }
+    if (seconds == minSeconds - 1) {
+        // The first second before minSeconds is only partly representable.
+        const int64_t below = f.fraction - nanosPerSecond;
+        if (below < std::numeric_limits<int64_t>::min() - minSeconds * nanosPerSecond) return false;
+        out = Timestamp(minSeconds * nanosPerSecond + below);
+        return true;
+    }
+    out = Timestamp(seconds * nanosPerSecond + f.fraction);
+    return true;
+}
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// Reads between minCount and maxCount digits at pos.
+bool readDigits(std::string_view s, size_t& pos, size_t minCount, size_t maxCount, int64_t& value) {
+    size_t start = pos;
+    value = 0;
+    while (pos < s.size() && pos - start < maxCount && isDigit(s[pos])) value = value * 10 + (s[pos++] - '0');
+    return pos - start >= minCount;
+}
+
+bool readChar(std::string_view s, size_t& pos, char c) {
+    if (pos >= s.size() || s[pos] != c) return false;
+    ++pos;
+    return true;
+}
+
+// Up to nine digits of a second, as nanoseconds.
+bool readFraction(std::string_view s, size_t& pos, int64_t& nanos) {
+    size_t start = pos;
+    if (!readDigits(s, pos, 1, 9, nanos)) return false;
+    for (size_t n = pos - start; n < 9; ++n) nanos *= 10;
+    return true;
+}
+
+// 'Z', or a sign and HH, HHMM or HH:MM.
+bool readOffset(std::string_view s, size_t& pos, int64_t& offset) {
+    if (pos < s.size() && (s[pos] == 'Z' || s[pos] == 'z')) {
+        ++pos;
+        offset = 0;
+        return true;
+    }
+    if (pos >= s.size() || (s[pos] != '+' && s[pos] != '-')) return false;
+    const int64_t sign = s[pos++] == '-' ? -1 : 1;
+    int64_t hours, minutes = 0;
+    if (!readDigits(s, pos, 2, 2, hours)) return false;
+    if (readChar(s, pos, ':') || (pos < s.size() && isDigit(s[pos]))) {
+        if (!readDigits(s, pos, 2, 2, minutes)) return false;
+    }
+    if (hours > 23 || minutes > 59) return false;
+    offset = sign * (hours * 3600 + minutes * 60);
+    return true;
+}
+
+bool parseISO(std::string_view s, Timestamp& out) {
+    DateTimeFields f;
+    size_t pos = 0;
+    if (!readDigits(s, pos, 4, 4, f.year) || !readChar(s, pos, '-') || !readDigits(s, pos, 2, 2, f.month) ||
+        !readChar(s, pos, '-') || !readDigits(s, pos, 2, 2, f.day)) {
+        return false;
+    }
+    if (pos < s.size()) {
+        const char sep = s[pos++];
+        if (sep != 'T' && sep != 't' && sep != ' ') return false;
+        if (!readDigits(s, pos, 2, 2, f.hour) || !readChar(s, pos, ':') || !readDigits(s, pos, 2, 2, f.minute)) {
+            return false;
+        }
+        if (readChar(s, pos, ':')) {
+            if (!readDigits(s, pos, 2, 2, f.second)) return false;
+            if ((readChar(s, pos, '.') || readChar(s, pos, ',')) && !readFraction(s, pos, f.fraction)) return false;
+        }
+        if (pos < s.size() && !readOffset(s, pos, f.offset)) return false;
+    }
+    return pos == s.size() && toTimestamp(f, out);
+}
+
+void putDigits(std::string& out, int64_t value, int width) {
+    char buf[20];
+    for (int i = width - 1; i >= 0; --i) {
+        buf[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    out.append(buf, static_cast<size_t>(width));
+}
+
+// The parts of t in UTC; fraction is in nanoseconds.
+DateTimeFields fieldsOf(Timestamp t) {
+    DateTimeFields f;
+    const int64_t seconds = floorDiv(t.nanos, nanosPerSecond);
+    f.fraction = t.nanos - seconds * nanosPerSecond;
+    const int64_t days = floorDiv(seconds, secondsPerDay);
+    const int64_t secondOfDay = seconds - days * secondsPerDay;
+    civilFromDays(days, f.year, f.month, f.day);
+    f.hour = secondOfDay / 3600;
+    f.minute = secondOfDay / 60 % 60;
+    f.second = secondOfDay % 60;
+    return f;
+}
+
+void putDate(std::string& out, const DateTimeFields& f) {
+    putDigits(out, f.year, 4);
+    out += '-';
+    putDigits(out, f.month, 2);
+    out += '-';
+    putDigits(out, f.day, 2);
+}
+
+void putTime(std::string& out, const DateTimeFields& f) {
+    putDigits(out, f.hour, 2);
+    out += ':';
+    putDigits(out, f.minute, 2);
+    out += ':';
+    putDigits(out, f.second, 2);
+}
+
+void formatISO(Timestamp t, std::string& out) {
+    const DateTimeFields f = fieldsOf(t);
+    putDate(out, f);
+    if (f.hour == 0 && f.minute == 0 && f.second == 0 && f.fraction == 0) return;
+    out += ' ';
+    putTime(out, f);
+    if (f.fraction == 0) return;
+    out += '.';
+    if (f.fraction % 1000000 == 0) putDigits(out, f.fraction / 1000000, 3);
+    else if (f.fraction % 1000 == 0) putDigits(out, f.fraction / 1000, 6);
+    else putDigits(out, f.fraction, 9);
+}
+
+} // namespace
+
+std::string Timestamp::toString() const {
+    std::string out;
+    formatISO(*this, out);
+    return out;
+}
+
+TimestampFormat::TimestampFormat(std::string_view format) {
+    for (size_t i = 0; i < format.size(); ++i) {
+        if (format[i] != '%') {
+            steps.push_back({0, format[i], 0});
+            continue;
+        }
+        if (++i == format.size()) throw std::invalid_argument("Date format ends in '%'.");
+        int width = 0;
+        if (format[i] == '3' || format[i] == '6' || format[i] == '9') {
+            width = format[i] - '0';
+            if (++i == format.size() || format[i] != 'f') {
+                throw std::invalid_argument("Only %f takes a width in a date format.");
+            }
+        }
+        switch (format[i]) {
+            case '%': steps.push_back({0, '%', 0}); break;
+            case 'f': steps.push_back({'f', 0, width == 0 ? 6 : width}); break;
+            case 'Y': case 'm': case 'd': case 'H': case 'M': case 'S': case 'z':
+                steps.push_back({format[i], 0, 0});
+                break;
+            default:
+                throw std::invalid_argument(std::string("Unsupported date format directive: %") + format[i]);
+        }
+    }
+}
+
+bool TimestampFormat::parse(std::string_view text, Timestamp& out) const {
+    if (steps.empty()) return parseISO(text, out);
+    DateTimeFields f;
+    size_t pos = 0;
+    for (const Step& step : steps) {
+        bool ok = false;
+        switch (step.directive) {
+            case 0: ok = readChar(text, pos, step.literal); break;
+            case 'Y': ok = readDigits(text, pos, 4, 4, f.year); break;
+            case 'm': ok = readDigits(text, pos, 1, 2, f.month); break;
+            case 'd': ok = readDigits(text, pos, 1, 2, f.day); break;
+            case 'H': ok = readDigits(text, pos, 1, 2, f.hour); break;
+            case 'M': ok = readDigits(text, pos, 1, 2, f.minute); break;
+            case 'S': ok = readDigits(text, pos, 1, 2, f.second); break;
+            case 'f': ok = readFraction(text, pos, f.fraction); break;
+            case 'z': ok = readOffset(text, pos, f.offset); break;
+        }
+        if (!ok) return false;
+    }
+    return pos == text.size() && toTimestamp(f, out);
+}
+
+void TimestampFormat::format(Timestamp t, std::string& out) const {
+    if (steps.empty()) {
+        formatISO(t, out);
+        return;
+    }
+    const DateTimeFields f = fieldsOf(t);
+    static constexpr int64_t scale[] = {1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1};
+    for (const Step& step : steps) {
+        switch (step.directive) {
+            case 0: out += step.literal; break;
+            case 'Y': putDigits(out, f.year, 4); break;
+            case 'm': putDigits(out, f.month, 2); break;
+            case 'd': putDigits(out, f.day, 2); break;
+            case 'H': putDigits(out, f.hour, 2); break;
+            case 'M': putDigits(out, f.minute, 2); break;
+            case 'S': putDigits(out, f.second, 2); break;
+            case 'f': putDigits(out, f.fraction / scale[step.width], step.width); break;
+            case 'z': out += "+0000"; break;
+        }
+    }
+}
+
+} // namespace df
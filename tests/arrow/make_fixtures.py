@@ -0,0 +1,47 @@
+# Writes the Arrow IPC fixtures read by tests/arrow_check.cpp with pyarrow:
+#
+#   python3 tests/arrow/make_fixtures.py
+#
+# table.arrow (file format) and table.arrows (stream format) hold the same
+# twelve rows in three record batches of four, with nulls, a
+# dictionary<int32, large_utf8> column, a timestamp[ns] column and the
+# "__index_level_0__" column a non-default index is written as.
+
+import datetime
+import os
+
+import pyarrow as pa
+import pyarrow.ipc as ipc
+
+here = os.path.dirname(os.path.abspath(__file__))
+
+
+def path(name):
+    return os.path.join(here, name)
+
+
+rows = 12
+cities = ["Oslo", "Lima", "Pune"]
+table = pa.table({
+    "id": pa.array(range(rows), pa.int64()),
+    "small": pa.array([None if i % 5 == 1 else i * 10 - 60 for i in range(rows)], pa.int8()),
+    "ratio": pa.array([None if i % 4 == 3 else i / 4 for i in range(rows)], pa.float64()),
+    "name": pa.array([None if i == 6 else "row%d" % i for i in range(rows)], pa.large_utf8()),
+    "note": pa.array(["n%d" % (i % 3) for i in range(rows)], pa.utf8()),
+    "city": pa.DictionaryArray.from_arrays(
+        pa.array([None if i == 10 else i % 3 for i in range(rows)], pa.int32()),
+        pa.array(cities, pa.large_utf8())),
+    "flag": pa.array([None if i == 2 else i % 2 == 0 for i in range(rows)], pa.bool_()),
+    "at": pa.array([None if i == 4 else datetime.datetime(2024, 1, 1 + i, 12, 30, 0, 250)
+                    for i in range(rows)], pa.timestamp("ns")),
+    "__index_level_0__": pa.array([100 + 10 * i for i in range(rows)], pa.int64()),
+})
+batches = table.to_batches(max_chunksize=4)
+
+with ipc.new_file(path("table.arrow"), table.schema) as writer:
+    for batch in batches:
+        writer.write_batch(batch)
+
+with ipc.new_stream(path("table.arrows"), table.schema) as writer:
+    for batch in batches:
+        writer.write_batch(batch)
@@ -0,0 +1,127 @@
+// Reads the Arrow IPC fixtures in tests/arrow (written by pyarrow, see
+// make_fixtures.py) in both formats, checks their values, and round-trips
+// them through toArrow and readArrow. Prints each failed check and exits
+// non-zero if there was one.
+//
+//   bash tests/build.sh && ./bin/arrow_check
+
+#include "df/dataframe.hpp"
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace df;
+
+namespace {
+
+const std::string dir = "tests/arrow/";
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::printf("FAILED: %s\n", what.c_str());
+        ++failures;
+    }
+}
+
+template<typename Col>
+const Col* column(const DataFrame& frame, const std::string& name) {
+    if (!frame.columnExists(name)) return nullptr;
+    return std::get_if<Col>(&frame[name]);
+}
+
+constexpr int64_t nanosPerDay = 86400LL * 1000000000LL;
+constexpr int64_t jan1 = 19723 * nanosPerDay; // 2024-01-01
+
+// The twelve rows make_fixtures.py writes.
+void checkValues(const DataFrame& frame, const std::string& what) {
+    check(frame.numRows() == 12 && frame.numColumns() == 8, what + ": shape");
+    const auto* id = column<Int64Column>(frame, "id");
+    const auto* small = column<Int8Column>(frame, "small");
+    const auto* ratio = column<DoubleColumn>(frame, "ratio");
+    const auto* name = column<StringColumn>(frame, "name");
+    const auto* note = column<StringColumn>(frame, "note");
+    const auto* city = column<CategoricalColumn>(frame, "city");
+    const auto* flag = column<BoolColumn>(frame, "flag");
+    const auto* at = column<TimestampColumn>(frame, "at");
+    if (!id || !small || !ratio || !name || !note || !city || !flag || !at) {
+        check(false, what + ": column types");
+        return;
+    }
+    const char* cities[] = {"Oslo", "Lima", "Pune"};
+    bool values = true;
+    for (size_t i = 0; i < 12; ++i) {
+        const int64_t n = static_cast<int64_t>(i);
+        values = values && id->value(i) == n &&
+                 (i % 5 == 1 ? small->isNA(i) : small->value(i) == static_cast<int8_t>(n * 10 - 60)) &&
+                 (i % 4 == 3 ? ratio->isNA(i) : ratio->value(i) == static_cast<double>(i) / 4) &&
+                 (i == 6 ? name->isNA(i) : name->value(i) == "row" + std::to_string(i)) &&
+                 note->value(i) == "n" + std::to_string(i % 3) &&
+                 (i == 10 ? city->isNA(i) : city->value(i) == cities[i % 3]) &&
+                 (i == 2 ? flag->isNA(i) : flag->value(i) == (i % 2 == 0)) &&
+                 (i == 4 ? at->isNA(i)
+                         : at->value(i) == Timestamp(jan1 + n * nanosPerDay + 45000LL * 1000000000LL + 250000));
+    }
+    check(values, what + ": values");
+    check(frame.getIndex().isInt64() && frame.getIndex().at(0) == "100" && frame.getIndex().at(11) == "210",
+          what + ": index");
+}
+
+bool sameColumn(const ColumnData& a, const ColumnData& b) {
+    if (a.index() != b.index()) return false;
+    return std::visit([&b](const auto& x) {
+        using Col = std::decay_t<decltype(x)>;
+        if constexpr (std::is_same_v<Col, EncodedColumn>) {
+            return false;
+        } else {
+            const Col& y = std::get<Col>(b);
+            if (x.size() != y.size()) return false;
+            for (size_t i = 0; i < x.size(); ++i) {
+                if (x.isNA(i) != y.isNA(i) || (!x.isNA(i) && x.value(i) != y.value(i))) return false;
+            }
+            return true;
+        }
+    }, a);
+}
+
+bool sameFrame(const DataFrame& a, const DataFrame& b) {
+    if (a.getColumnNames() != b.getColumnNames() || a.getIndex() != b.getIndex()) return false;
+    for (const auto& name : a.getColumnNames()) {
+        if (!sameColumn(a[name], b[name])) return false;
+    }
+    return true;
+}
+
+void checkFixture(const std::string& file) {
+    const DataFrame mapped = io::readArrow(dir + file);
+    checkValues(mapped, file);
+    checkValues(io::readArrow(dir + file, false), file + " (read into memory)");
+
+    const auto temp = std::filesystem::temp_directory_path();
+    for (auto format : {io::ArrowFormat::File, io::ArrowFormat::Stream}) {
+        const bool isFile = format == io::ArrowFormat::File;
+        const std::string out = (temp / (isFile ? "df_arrow_check.arrow" : "df_arrow_check.arrows")).string();
+        mapped.toArrow(out, format);
+        check(sameFrame(mapped, DataFrame::readArrow(out)),
+              file + ": round trip as " + (isFile ? "file" : "stream"));
+        std::filesystem::remove(out);
+    }
+}
+
+} // namespace
+
+int main() {
+    for (const char* file : {"table.arrow", "table.arrows"}) {
+        try {
+            checkFixture(file);
+        } catch (const std::exception& e) {
+            check(false, std::string(file) + ": threw " + e.what());
+        }
+    }
+    if (failures != 0) return 1;
+    std::printf("All Arrow checks passed.\n");
+    return 0;
+}
@@ -0,0 +1,18 @@
+#!/bin/bash
+set -e
+
+cd "$(dirname "$0")/.."
+mkdir -p bin
+
+# Links the library build.sh builds, and zstd when build.sh built it in.
+ZSTD_LIBS=""
+if nm bin/static/parquet_io.o 2>/dev/null | grep -q ZSTD_; then
+    ZSTD_LIBS="-lzstd"
+fi
+
+for check in parquet_check arrow_check; do
+    g++ -std=c++17 -Wall -Iinclude tests/$check.cpp -Lbin/static -l:dataframe_lib.a -lz $ZSTD_LIBS -pthread \
+        -o bin/$check
+done
+
+echo "Compilation complete. Run ./bin/parquet_check and ./bin/arrow_check from the repository root."
@@ -0,0 +1,69 @@
+# Writes the Parquet fixtures read by tests/parquet_check.cpp with pyarrow:
+#
+#   python3 tests/parquet/make_fixtures.py
+#
+# pruned.parquet has the data pages of its second row group and of its
+# "payload" column overwritten with garbage, so only a reader that skips
+# them from the footer's statistics and column list can read it.
+
+import datetime
+import os
+
+import pyarrow as pa
+import pyarrow.parquet as pq
+
+here = os.path.dirname(os.path.abspath(__file__))
+
+
+def path(name):
+    return os.path.join(here, name)
+
+
+rows = 12
+table = pa.table({
+    "id": pa.array(range(rows), pa.int64()),
+    "small": pa.array([i * 3 - 10 for i in range(rows)], pa.int32()),
+    "ratio": pa.array([i / 4 for i in range(rows)], pa.float64()),
+    "name": pa.array(["row%d" % i for i in range(rows)], pa.string()),
+    "flag": pa.array([i % 3 == 0 for i in range(rows)], pa.bool_()),
+    "day": pa.array([datetime.date(2024, 1, 1 + i) for i in range(rows)], pa.date32()),
+    "at": pa.array([datetime.datetime(2024, 1, 1, i, 30) for i in range(rows)], pa.timestamp("us")),
+})
+
+pq.write_table(table, path("plain.parquet"), use_dictionary=False, compression="none")
+
+repeated = pa.table({
+    "city": pa.array(["Oslo", "Lima", "Pune", "Oslo"] * 3, pa.string()),
+    "code": pa.array([7, 7, 9, 7] * 3, pa.int32()),
+})
+pq.write_table(repeated, path("dictionary.parquet"), use_dictionary=True, compression="none")
+
+optional = pa.table({
+    "n": pa.array([1, None, 3, None, 5, 6], pa.int64()),
+    "s": pa.array(["a", None, "c", "d", None, "f"], pa.string()),
+    "x": pa.array([None, 2.5, None, 4.5, 5.5, None], pa.float64()),
+    "empty": pa.array([None] * 6, pa.int32()),
+})
+pq.write_table(optional, path("optional.parquet"), compression="none")
+
+pq.write_table(table, path("snappy.parquet"), compression="snappy")
+
+# Three row groups of four rows, in v2 data pages.
+pq.write_table(table, path("row_groups.parquet"), compression="snappy", row_group_size=4,
+               data_page_version="2.0")
+
+pruned = table.append_column("payload", pa.array(["p%d" % i for i in range(rows)], pa.string()))
+pq.write_table(pruned, path("pruned.parquet"), use_dictionary=False, compression="none", row_group_size=4)
+metadata = pq.ParquetFile(path("pruned.parquet")).metadata
+with open(path("pruned.parquet"), "r+b") as f:
+    for g in range(metadata.num_row_groups):
+        group = metadata.row_group(g)
+        for c in range(group.num_columns):
+            chunk = group.column(c)
+            if g != 1 and chunk.path_in_schema != "payload":
+                continue
+            start = chunk.data_page_offset
+            if chunk.has_dictionary_page and chunk.dictionary_page_offset is not None:
+                start = min(start, chunk.dictionary_page_offset)
+            f.seek(start)
+            f.write(b"\xff" * chunk.total_compressed_size)
@@ -0,0 +1,167 @@
+// Reads the Parquet fixtures in tests/parquet (written by pyarrow, see
+// make_fixtures.py) and checks their values, a projection, where filters and
+// the row groups and columns those let the reader skip. Prints each failed
+// check and exits non-zero if there was one.
+//
+//   bash tests/build.sh && ./bin/parquet_check
+
+#include "df/dataframe.hpp"
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace df;
+using Op = io::ColumnPredicate::Op;
+
+namespace {
+
+const std::string dir = "tests/parquet/";
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::printf("FAILED: %s\n", what.c_str());
+        ++failures;
+    }
+}
+
+template<typename Col>
+const Col* column(const DataFrame& frame, const std::string& name) {
+    if (!frame.columnExists(name)) return nullptr;
+    return std::get_if<Col>(&frame[name]);
+}
+
+constexpr int64_t nanosPerDay = 86400LL * 1000000000LL;
+constexpr int64_t jan1 = 19723 * nanosPerDay; // 2024-01-01
+
+// The twelve rows make_fixtures.py writes to plain, snappy and row_groups.
+void checkTable(const std::string& file) {
+    DataFrame frame = io::readParquet(dir + file);
+    check(frame.numRows() == 12 && frame.numColumns() == 7, file + ": shape");
+    const auto* id = column<Int64Column>(frame, "id");
+    const auto* small = column<IntColumn>(frame, "small");
+    const auto* ratio = column<DoubleColumn>(frame, "ratio");
+    const auto* name = column<StringColumn>(frame, "name");
+    const auto* flag = column<BoolColumn>(frame, "flag");
+    const auto* day = column<TimestampColumn>(frame, "day");
+    const auto* at = column<TimestampColumn>(frame, "at");
+    if (!id || !small || !ratio || !name || !flag || !day || !at) {
+        check(false, file + ": column types");
+        return;
+    }
+    bool values = true;
+    for (size_t i = 0; i < 12; ++i) {
+        const int64_t n = static_cast<int64_t>(i);
+        values = values && id->value(i) == n && small->value(i) == 3 * static_cast<int>(i) - 10 &&
+                 ratio->value(i) == static_cast<double>(i) / 4 && name->value(i) == "row" + std::to_string(i) &&
+                 flag->value(i) == (i % 3 == 0) && day->value(i) == Timestamp(jan1 + n * nanosPerDay) &&
+                 at->value(i) == Timestamp(jan1 + (n * 60 + 30) * 60000000000LL);
+    }
+    check(values, file + ": values");
+
+    io::ParquetReadOptions options;
+    options.columns = {"name", "id"};
+    options.where = {{"small", Op::Between, -4, 11}, {"flag", Op::Equal, false}};
+    DataFrame filtered = io::readParquet(dir + file, options);
+    const auto* names = column<StringColumn>(filtered, "name");
+    check(filtered.getColumnNames() == std::vector<std::string>{"name", "id"} && names &&
+          filtered.numRows() == 4 && names->value(0) == "row2" && names->value(1) == "row4" &&
+          names->value(3) == "row7" && filtered.getIndex().at(3) == "7",
+          file + ": projection and where");
+}
+
+void checkDictionary() {
+    DataFrame frame = io::readParquet(dir + "dictionary.parquet");
+    const auto* code = column<IntColumn>(frame, "code");
+    bool values = code && frame.numRows() == 12;
+    const char* cities[] = {"Oslo", "Lima", "Pune", "Oslo"};
+    for (size_t i = 0; values && i < 12; ++i) {
+        values = visitDecoded([&](const auto& col) {
+            using Col = std::decay_t<decltype(col)>;
+            if constexpr (std::is_same_v<Col, StringColumn> || std::is_same_v<Col, CategoricalColumn>) {
+                return col.value(i) == cities[i % 4];
+            } else {
+                return false;
+            }
+        }, frame["city"]) && code->value(i) == (i % 4 == 2 ? 9 : 7);
+    }
+    check(values, "dictionary.parquet: values");
+
+    io::ParquetReadOptions options;
+    options.where = {{"city", Op::Equal, std::string("Oslo")}};
+    check(io::readParquet(dir + "dictionary.parquet", options).numRows() == 6, "dictionary.parquet: where");
+}
+
+void checkOptional() {
+    DataFrame frame = io::readParquet(dir + "optional.parquet");
+    const auto* n = column<Int64Column>(frame, "n");
+    const auto* s = column<StringColumn>(frame, "s");
+    const auto* x = column<DoubleColumn>(frame, "x");
+    check(n && s && x && frame.numRows() == 6, "optional.parquet: column types");
+    if (!n || !s || !x) return;
+    check(n->isNA(1) && n->isNA(3) && n->value(4) == 5 && n->nullCount() == 2, "optional.parquet: int64 nulls");
+    check(s->isNA(1) && s->isNA(4) && s->value(3) == "d" && s->nullCount() == 2, "optional.parquet: string nulls");
+    check(x->isNA(0) && x->value(1) == 2.5 && x->value(4) == 5.5 && x->nullCount() == 3,
+          "optional.parquet: double nulls");
+    check(std::visit([](const auto& col) { return col.nullCount(); }, frame["empty"]) == 6,
+          "optional.parquet: all-null column");
+
+    io::ParquetReadOptions options;
+    options.where = {{"n", Op::IsNA}};
+    check(io::readParquet(dir + "optional.parquet", options).numRows() == 2, "optional.parquet: IsNA");
+    options.where = {{"n", Op::GreaterEqual, int64_t(3)}, {"s", Op::NotNA}};
+    check(io::readParquet(dir + "optional.parquet", options).numRows() == 2, "optional.parquet: where");
+}
+
+// The pages of pruned.parquet's second row group and of its payload column
+// are garbage: reading them throws, so only skipping them succeeds.
+void checkPruning() {
+    const std::string file = dir + "pruned.parquet";
+    bool threw = false;
+    try {
+        io::readParquet(file);
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    check(threw, "pruned.parquet: reading the damaged pages throws");
+
+    io::ParquetReadOptions options;
+    options.columns = {"id", "name"};
+    options.where = {{"id", Op::NotEqual, int64_t(5)}, {"id", Op::LessEqual, int64_t(3)}};
+    DataFrame low = io::readParquet(file, options);
+    options.where = {{"id", Op::Greater, int64_t(7)}};
+    DataFrame high = io::readParquet(file, options);
+    options.where = {{"day", Op::GreaterEqual, Timestamp(jan1 + 9 * nanosPerDay)}};
+    DataFrame late = io::readParquet(file, options);
+    const auto* lowIds = column<Int64Column>(low, "id");
+    const auto* highIds = column<Int64Column>(high, "id");
+    check(lowIds && low.numRows() == 4 && lowIds->value(3) == 3, "pruned.parquet: first row group only");
+    check(highIds && high.numRows() == 4 && highIds->value(0) == 8 && high.getIndex().at(0) == "8",
+          "pruned.parquet: last row group only");
+    check(late.numRows() == 3, "pruned.parquet: timestamp statistics");
+}
+
+} // namespace
+
+int main() {
+    const std::vector<void (*)()> checks = {
+        [] { checkTable("plain.parquet"); },
+        [] { checkTable("snappy.parquet"); },
+        [] { checkTable("row_groups.parquet"); },
+        checkDictionary,
+        checkOptional,
+        checkPruning,
+    };
+    for (auto run : checks) {
+        try {
+            run();
+        } catch (const std::exception& e) {
+            check(false, std::string("threw ") + e.what());
+        }
+    }
+    if (failures != 0) return 1;
+    std::printf("All Parquet checks passed.\n");
+    return 0;
+}